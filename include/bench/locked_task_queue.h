@@ -0,0 +1,69 @@
+#ifndef LOCKED_TASK_QUEUE_H
+#define LOCKED_TASK_QUEUE_H
+
+#include <pthread.h>
+#include "task.h"
+
+/**
+ * @brief Original task layout with the command embedded by value
+ * @details Kept for the benchmark baseline: every queue operation copies the
+ *          whole BUFSIZ array.
+ */
+typedef struct {
+    int fd;                      // Client file descriptor
+    char data[BUFSIZ];          // Received data
+    int length;                 // Data length
+} LockedTask;
+
+/**
+ * @brief Mutex-based task queue used as the benchmark baseline
+ * @details Same design as the server's original TaskQueue: a circular buffer
+ *          protected by one mutex and one condition variable shared by
+ *          producers and consumers, signaled on every push and pop, storing
+ *          LockedTask by value.
+ */
+typedef struct {
+    LockedTask queue[TASK_QUEUE_CAPACITY];  // Task storage space (circular queue)
+    int front;                        // Queue front index
+    int rear;                         // Queue rear index
+    int count;                        // Current number of tasks
+    int stopping;                     // Set by locked_task_queue_wake_all()
+
+    pthread_mutex_t mutex;           // Mutex for queue access
+    pthread_cond_t cond;             // Condition variable (signals when tasks are available)
+} LockedTaskQueue;
+
+/**
+ * @brief Initializes a locked task queue
+ * @param q Pointer to the queue to be initialized
+ */
+void locked_task_queue_init(LockedTaskQueue* q);
+
+/**
+ * @brief Adds a task, waiting while the queue is full
+ * @param q Pointer to the queue
+ * @param task Task to be added
+ */
+void locked_task_queue_push(LockedTaskQueue* q, const LockedTask* task);
+
+/**
+ * @brief Removes a task, waiting while the queue is empty
+ * @param q Pointer to the queue
+ * @param task Receives the removed task
+ * @return 1 if a task was removed, 0 if the queue was stopped
+ */
+int locked_task_queue_pop(LockedTaskQueue* q, LockedTask* task);
+
+/**
+ * @brief Stops the queue and wakes every waiting thread
+ * @param q Pointer to the queue
+ */
+void locked_task_queue_wake_all(LockedTaskQueue* q);
+
+/**
+ * @brief Destroys the mutex and condition variable of the queue
+ * @param q Pointer to the queue
+ */
+void locked_task_queue_destroy(LockedTaskQueue* q);
+
+#endif
@@ -16,6 +16,21 @@
  */
 #define SERVER_PORT 5100
 
+/**
+ * @brief Largest snapshot datagram sent by the server (same value as the server's UDP_DATAGRAM_MAX)
+ */
+#define UDP_DATAGRAM_MAX 1200
+
+/**
+ * @brief Upper bound of fragments per snapshot accepted from the server
+ */
+#define UDP_MAX_FRAGMENTS 65535
+
+/**
+ * @brief Receive timeout of the UDP socket in milliseconds (lets the thread check keep_running)
+ */
+#define UDP_RECV_TIMEOUT_MS 100
+
 /**
  * @brief Maximum number of clients that can connect to the server
  */
@@ -52,6 +67,7 @@ extern volatile sig_atomic_t keep_running;
  */
 typedef struct {
     int socket_fd;                   ///< Socket file descriptor for server communication
+    int udp_fd;                      ///< UDP socket receiving ball states (-1 = states on the TCP stream)
     dev_fb* framebuffer;             ///< Framebuffer device information structure (for display control)
     BallListManager* ball_list_manager; ///< Ball list manager
     pthread_mutex_t mutex_ball;      ///< Mutex for synchronizing access to ball resources
@@ -89,7 +105,8 @@ void* render_thread(void* arg);
  * @brief Thread function for receiving data from the server
  * @param arg Pointer to the SharedContext structure
  * @return NULL when the thread terminates
- * @details Continuously listens for incoming data from the server and updates the game state
+ * @details Continuously listens for incoming data from the server and updates the game state.
+ *          With a UDP port the TCP stream carries only command replies, which are printed.
  * @date 2025-04-07
  * @author Kim Hyo Jin
  */
@@ -105,4 +122,18 @@ void* socket_recv_thread(void* arg);
  */
 void* socket_send_thread(void* arg);
 
+/**
+ * @brief Thread function receiving ball states as UDP datagrams
+ * @param arg Pointer to SharedContext
+ * @return NULL
+ * @details Started only when a UDP port was given on the command line.
+ *          Each datagram is one fragment "S<seq> <index>/<count>\n" followed
+ *          by whole balls. Fragments of older sequences than the one being
+ *          assembled are ignored, a newer sequence restarts the assembly,
+ *          and the ball list is replaced only once every fragment of a
+ *          sequence has arrived. A lost fragment therefore skips one tick
+ *          instead of delaying later ones.
+ */
+void* udp_recv_thread(void* arg);
+
 #endif
\ No newline at end of file
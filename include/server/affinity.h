@@ -0,0 +1,79 @@
+#ifndef AFFINITY_H
+#define AFFINITY_H
+
+#include <stdint.h>
+
+#define AFFINITY_MAX_CPUS 1024      ///< Highest CPU number accepted in a CPU list (exclusive)
+
+/**
+ * @brief Server thread roles that can be pinned to a CPU set
+ */
+typedef enum {
+    ROLE_REACTOR = 0,   ///< Reactor (network) threads, including the main thread
+    ROLE_WORKER,        ///< Command worker threads
+    ROLE_SIM,           ///< Simulation thread and its sim pool helpers
+    ROLE_FANOUT,        ///< Snapshot fan-out thread
+    ROLE_COUNT          ///< Number of roles
+} ThreadRole;
+
+/**
+ * @brief Set of CPU numbers
+ */
+typedef struct {
+    uint64_t mask[AFFINITY_MAX_CPUS / 64];  ///< Bit n set = CPU n is in the set
+    int cpu_count;                          ///< Number of CPUs in the set (0 = role not pinned)
+} CpuList;
+
+/**
+ * @brief CPU placement of every server thread role
+ * @details Filled from --affinity ROLE=CPULIST options. Every thread of a
+ *          pinned role is bound to the whole CPU set of the role, so the
+ *          scheduler still balances the threads of a role inside the set but
+ *          never migrates them onto the CPUs (or NUMA node) of another role.
+ *          Roles without a CPU set keep the default scheduling.
+ */
+typedef struct {
+    CpuList roles[ROLE_COUNT];  ///< CPU set of each role
+} ThreadLayout;
+
+/**
+ * @brief Clears a layout (every role unpinned)
+ * @param layout Pointer to the layout to be initialized
+ */
+void affinity_layout_init(ThreadLayout* layout);
+
+/**
+ * @brief Parses one ROLE=CPULIST specification into a layout
+ * @param layout Pointer to the layout to update
+ * @param spec Specification such as "worker=2-5" or "sim=0,8"
+ *             (roles: reactor, worker, sim, fanout)
+ * @return 0 on success, -1 if the role, the list or a CPU number is invalid
+ *         or a CPU is not available to the process (an error has been printed)
+ */
+int affinity_parse(ThreadLayout* layout, const char* spec);
+
+/**
+ * @brief Binds the calling thread to the CPU set of a role
+ * @param layout Pointer to the layout
+ * @param role Role of the calling thread
+ * @return 0 on success or if the role is not pinned, -1 on failure
+ * @details Threads created afterwards by the calling thread inherit the
+ *          binding (the sim pool helpers follow the simulation thread).
+ */
+int affinity_pin_self(const ThreadLayout* layout, ThreadRole role);
+
+/**
+ * @brief Restores the CPU set the process was started with on the calling thread
+ * @return 0 on success, -1 on failure
+ * @details Undoes affinity_pin_self(). The main thread uses it after
+ *          allocating the world on the simulation role's CPUs.
+ */
+int affinity_unpin_self(void);
+
+/**
+ * @brief Prints the CPU set and NUMA nodes of every role
+ * @param layout Pointer to the layout
+ */
+void affinity_report(const ThreadLayout* layout);
+
+#endif // AFFINITY_H
@@ -0,0 +1,66 @@
+#ifndef BALL_KERNEL_H
+#define BALL_KERNEL_H
+
+#include "localball_list.h"
+
+/**
+ * @brief Function pointer type for ball integration kernels
+ * @param list Pointer to the ball list
+ * @param begin Index of the first ball to move
+ * @param end Index one past the last ball to move
+ */
+typedef void (*MoveKernel)(BallList* list, int begin, int end);
+
+/**
+ * @brief Moves the balls in [begin, end) one step (portable scalar version)
+ * @param list Pointer to the ball list
+ * @param begin Index of the first ball to move
+ * @param end Index one past the last ball to move
+ * @details Adds the velocity to each position and reflects the ball off the
+ *          boundaries of the logical coordinate space, in Q10.6 fixed point
+ *          widened to 32 bits.
+ *          The velocity used is the base velocity scaled by the owner's speed
+ *          level (scaleSpeed()); that work is skipped while no owner has a
+ *          non-zero level. This is the reference for the SIMD kernels.
+ */
+void move_balls_scalar(BallList* list, int begin, int end);
+
+/**
+ * @brief Moves the balls in [begin, end) one step, 8 balls per iteration (SSE2)
+ * @param list Pointer to the ball list
+ * @param begin Index of the first ball to move
+ * @param end Index one past the last ball to move
+ * @details The 16-bit fields are unpacked into two groups of 4 int32 lanes and
+ *          packed back with a bias trick, since SSE2 has no unsigned 32->16 pack.
+ *          Owner speed levels are applied as a per-owner float scale (2^level).
+ *          Wall reflection is applied with compare masks instead of branches.
+ *          Produces the same result as move_balls_scalar().
+ *          Falls back to the scalar kernel on non-x86 builds.
+ */
+void move_balls_sse2(BallList* list, int begin, int end);
+
+/**
+ * @brief Moves the balls in [begin, end) one step, 8 balls per instruction (AVX2)
+ * @param list Pointer to the ball list
+ * @param begin Index of the first ball to move
+ * @param end Index one past the last ball to move
+ * @details The 16-bit and 8-bit fields are widened to int32 lanes and narrowed
+ *          back with a saturating pack and a cross-lane permute. Owner speed
+ *          levels are gathered per lane and applied with variable shifts.
+ *          Wall reflection is applied with compare masks instead of branches.
+ *          Produces the same result as move_balls_scalar(). Must only be
+ *          called on CPUs that support AVX2. Falls back to the scalar kernel
+ *          on non-x86 builds.
+ */
+void move_balls_avx2(BallList* list, int begin, int end);
+
+/**
+ * @brief Moves the balls in [begin, end) with the best kernel for this CPU
+ * @param list Pointer to the ball list
+ * @param begin Index of the first ball to move
+ * @param end Index one past the last ball to move
+ * @details The kernel is selected once via CPUID (AVX2, then SSE2, then scalar).
+ */
+void move_balls(BallList* list, int begin, int end);
+
+#endif // BALL_KERNEL_H
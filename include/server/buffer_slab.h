@@ -0,0 +1,82 @@
+#ifndef BUFFER_SLAB_H
+#define BUFFER_SLAB_H
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "console_color.h"
+
+#define SLAB_CLASS_COUNT 4          ///< Number of buffer size classes
+#define SLAB_CHUNK_BUFFERS 64       ///< Buffers carved out of one chunk allocation
+#define SLAB_CLASS_MAX_BUFFERS 1024 ///< Buffers a class may own (power of two, free ring size)
+#define SLAB_HEADER_SIZE 8          ///< Bytes in front of each buffer holding its class
+
+/**
+ * @brief Free list of one size class
+ * @details The free buffers are kept in a bounded lock-free ring (same
+ *          sequence-number scheme as TaskQueue), so the epoll thread can take
+ *          buffers while workers return them without sharing a lock. The
+ *          mutex is only taken to carve a new chunk when the ring runs dry.
+ */
+typedef struct {
+    uint32_t push_pos;                  ///< Next ring position to fill (atomic)
+    char pad0[64 - sizeof(uint32_t)];
+    uint32_t pop_pos;                   ///< Next ring position to take (atomic)
+    char pad1[64 - sizeof(uint32_t)];
+    uint32_t seq[SLAB_CLASS_MAX_BUFFERS];   ///< Per-slot sequence numbers
+    char* slots[SLAB_CLASS_MAX_BUFFERS];    ///< Free buffers
+
+    size_t buffer_size;                 ///< Usable bytes of each buffer of the class
+    int owned;                          ///< Buffers carved so far (at most SLAB_CLASS_MAX_BUFFERS)
+    void** chunks;                      ///< Chunk allocations, freed on destroy
+    int chunk_count;                    ///< Number of chunks
+    pthread_mutex_t grow_mutex;         ///< Serializes chunk allocation
+} SlabClass;
+
+/**
+ * @brief Slab of reusable, variable-sized command buffers
+ * @details Buffers come in SLAB_CLASS_COUNT size classes (64 B up to BUFSIZ + 1),
+ *          so a 3-byte command takes a 64-byte buffer instead of a BUFSIZ
+ *          array. Buffers are carved from chunks on demand and recycled
+ *          through the class's free ring; a class that reaches
+ *          SLAB_CLASS_MAX_BUFFERS falls back to malloc() for further buffers.
+ */
+typedef struct {
+    SlabClass classes[SLAB_CLASS_COUNT];    ///< Size classes, smallest first
+} BufferSlab;
+
+/**
+ * @brief Initializes an empty buffer slab
+ * @param slab Pointer to the slab to be initialized
+ */
+void buffer_slab_init(BufferSlab* slab);
+
+/**
+ * @brief Takes a buffer of at least size bytes
+ * @param slab Pointer to the buffer slab
+ * @param size Number of bytes needed
+ * @return Buffer to be returned with buffer_slab_free(), or NULL if memory allocation fails
+ * @details Thread-safe. Lock-free unless the size class has to grow.
+ */
+char* buffer_slab_alloc(BufferSlab* slab, size_t size);
+
+/**
+ * @brief Returns a buffer to the slab
+ * @param slab Pointer to the buffer slab
+ * @param buf Buffer from buffer_slab_alloc() (NULL is ignored)
+ * @details Thread-safe and lock-free; may be called from another thread than
+ *          the one that allocated the buffer.
+ */
+void buffer_slab_free(BufferSlab* slab, char* buf);
+
+/**
+ * @brief Frees every chunk of the slab
+ * @param slab Pointer to the buffer slab
+ * @details Buffers still held elsewhere become invalid. No thread may still
+ *          be using the slab.
+ */
+void buffer_slab_destroy(BufferSlab* slab);
+
+#endif // BUFFER_SLAB_H
@@ -11,7 +11,9 @@
 #include <pthread.h>
 #include "console_color.h"
 
-#define MAX_CLIENTS 10
+#define MAX_CLIENTS 10                  ///< Default cap on connected clients (--max-clients)
+#define CLIENT_TABLE_MAX_CLIENTS 65535  ///< Upper bound of --max-clients (owner IDs are 16-bit)
+#define CLIENT_TABLE_INIT_CAPACITY 16   ///< Initial capacity of the dense array and the fd index
 
 /**
  * @brief Structure representing a socket context
@@ -23,123 +25,103 @@
 typedef struct {
     int csock;                  // Client socket file descriptor
     struct sockaddr_in cliaddr; // Client address information
+    int epoll_fd;               // Epoll instance of the reactor that owns the connection (-1 with io_uring)
+    int udp_port;               // UDP port registered with "u:<port>" for ball states (0 = states on the TCP stream)
 } SocketContext;
 
-/**
- * @brief Structure representing a client node in the linked list
- * @details This structure represents a single client in the linked list of clients,
- *          containing the socket context and a pointer to the next client.
- * @date 2025-04-07
- * @author Kim Hyo Jin
- */
-typedef struct ClientNode {
-    SocketContext ctx;          // Socket context for this client
-    struct ClientNode* next;    // Pointer to the next client in the list
-} ClientNode;
-
 /**
  * @brief Structure representing a client list manager
- * @details This structure manages a linked list of clients with thread safety
- *          mechanisms for concurrent access.
+ * @details Clients are stored in a dense array that broadcasts iterate
+ *          directly (clients[0 .. client_count - 1]), plus an index from
+ *          socket fd to array slot. Insert, lookup and remove are O(1):
+ *          removing moves the last client into the freed slot. The order of
+ *          the dense array is therefore not the connection order.
+ *          All fields are protected by mutex_client.
  * @date 2025-04-07
  * @author Kim Hyo Jin
  */
 typedef struct {
-    ClientNode* head;           // Pointer to the first client in the list
-    ClientNode* tail;           // Pointer to the last client in the list
-    pthread_mutex_t mutex_client; // Mutex for synchronizing client list operations
-    int client_count;           // Current number of clients in the list
+    SocketContext* clients;     // Dense array of connected clients
+    int client_count;           // Current number of clients in the table
+    int client_capacity;        // Capacity of clients
+    int* slot_of_fd;            // fd -> index in clients, -1 if the fd is not a client
+    int fd_capacity;            // Number of entries in slot_of_fd
+    int max_clients;            // Maximum number of clients accepted
+    pthread_mutex_t mutex_client; // Mutex for synchronizing client table operations
 } ClientListManager;
 
 /**
  * @brief Creates a new socket context
  * @param csock Client socket file descriptor
  * @param cliaddr Client address information
+ * @param epoll_fd Epoll instance of the reactor that owns the connection (-1 with io_uring)
  * @return A newly created SocketContext
  * @details Initializes a new socket context with the provided socket and address.
  * @date 2025-04-07
  * @author Kim Hyo Jin
  */
-SocketContext create_client(int csock, struct sockaddr_in cliaddr);
-
-/**
- * @brief Creates a new client node
- * @param ctx Socket context for the new client
- * @return Pointer to the newly created ClientNode, or NULL if allocation fails
- * @details Allocates memory for a new client node and initializes it with the provided context.
- * @date 2025-04-07
- * @author Kim Hyo Jin
- */
-ClientNode* create_client_node(SocketContext ctx);
-
-/**
- * @brief Appends a client to the linked list
- * @param head Pointer to the head of the client list
- * @param tail Pointer to the tail of the client list
- * @param ctx Socket context for the new client
- * @return Updated head of the client list
- * @details Adds a new client to the end of the linked list.
- * @date 2025-04-07
- * @author Kim Hyo Jin
- */
-ClientNode* append_client(ClientNode* head, ClientNode** tail, SocketContext ctx);
+SocketContext create_client(int csock, struct sockaddr_in cliaddr, int epoll_fd);
 
 /**
- * @brief Adds a client to the client list manager
+ * @brief Adds a client to the client table
  * @param manager Pointer to the client list manager
  * @param csock Client socket file descriptor
  * @param cliaddr Client address information
- * @details Creates a new client and adds it to the manager's list.
+ * @param epoll_fd Epoll instance of the reactor that owns the connection (-1 with io_uring)
+ * @return 0 on success, -1 if the table is full (max_clients), the fd is
+ *         already registered or memory allocation fails
+ * @details O(1) amortized. The caller holds mutex_client.
  * @date 2025-04-07
  * @author Kim Hyo Jin
  */
-void add_client(ClientListManager* manager, int csock, struct sockaddr_in cliaddr);
+int add_client(ClientListManager* manager, int csock, struct sockaddr_in cliaddr, int epoll_fd);
 
 /**
- * @brief Removes a client from the list by socket file descriptor
- * @param socket_fd Socket file descriptor of the client to remove
- * @param head Pointer to the head of the client list
- * @param tail Pointer to the tail of the client list
- * @return Pointer to the removed client node, or NULL if not found
- * @details Removes a client from the list based on its socket file descriptor.
- * @date 2025-04-07
- * @author Kim Hyo Jin
+ * @brief Finds a client by socket file descriptor
+ * @param manager Pointer to the client list manager
+ * @param socket_fd Socket file descriptor of the client
+ * @return Pointer to the client's context (valid until the table changes), or NULL if not found
+ * @details O(1). The caller holds mutex_client.
  */
-ClientNode* remove_client_by_socket(int socket_fd, ClientNode** head, ClientNode** tail);
+SocketContext* find_client(ClientListManager* manager, int socket_fd);
 
 /**
- * @brief Frees all resources used by the client list
- * @param head Pointer to the head of the client list
- * @details Frees all client nodes in the list and closes their sockets.
+ * @brief Removes a client from the table by socket file descriptor
+ * @param manager Pointer to the client list manager
+ * @param socket_fd Socket file descriptor of the client to remove
+ * @param removed Receives the removed client's context (may be NULL)
+ * @return 1 if the client was removed, 0 if not found
+ * @details O(1): the last client of the dense array takes the freed slot.
+ *          The socket is not closed. The caller holds mutex_client.
  * @date 2025-04-07
  * @author Kim Hyo Jin
  */
-void free_client_list(ClientNode** head);
+int remove_client_by_socket(ClientListManager* manager, int socket_fd, SocketContext* removed);
 
 /**
- * @brief Prints information about all clients in the list
- * @param head Pointer to the head of the client list
- * @details Displays information about each client in the list.
+ * @brief Prints information about all clients in the table
+ * @param manager Pointer to the client list manager
+ * @details Displays information about each client in the table.
  * @date 2025-04-07
  * @author Kim Hyo Jin
  */
-void print_clients(ClientNode* head);
+void print_clients(const ClientListManager* manager);
 
 /**
  * @brief Initializes a client list manager
  * @param manager Pointer to the client list manager to be initialized
- * @details Initializes the client list manager by setting head and tail to NULL,
- *          initializing the mutex, and setting the client count to 0.
+ * @param max_clients Maximum number of clients accepted (1 to CLIENT_TABLE_MAX_CLIENTS)
+ * @details Initializes an empty client table and the mutex.
  * @date 2025-04-07
  * @author Kim Hyo Jin
  */
-void client_list_manager_init(ClientListManager* manager);
+void client_list_manager_init(ClientListManager* manager, int max_clients);
 
 /**
  * @brief Destroys a client list manager
  * @param manager Pointer to the client list manager to be destroyed
- * @details Frees all resources used by the client list manager, including
- *          destroying the mutex and freeing all client nodes.
+ * @details Closes the sockets of the remaining clients, frees the table and
+ *          destroys the mutex.
  * @date 2025-04-07
  * @author Kim Hyo Jin
  */
@@ -0,0 +1,83 @@
+#ifndef COLLISION_H
+#define COLLISION_H
+
+#include "localball_list.h"
+
+#define WORLD_SIZE 1000.0f            ///< Width and height of the logical coordinate space
+#define COLLISION_MIN_CELL_SIZE 2.0f  ///< Lower bound of the grid cell size (bounds the cell count)
+#define COLLISION_LARGE_SHARE 64      ///< At most 1/N of the balls may be larger than a cell
+#define COLLISION_LARGE_MIN 16        ///< ... but always allow this many (small worlds)
+
+/**
+ * @brief Counters of the collision stage
+ * @details The tick_* fields describe the last step, the total_* fields
+ *          accumulate over the whole run.
+ */
+typedef struct {
+    unsigned long long tick_pairs_tested;     ///< Candidate pairs tested in the last step
+    unsigned long long tick_pairs_colliding;  ///< Overlapping pairs resolved in the last step
+    unsigned long long total_pairs_tested;    ///< Candidate pairs tested since startup
+    unsigned long long total_pairs_colliding; ///< Overlapping pairs resolved since startup
+} CollisionStats;
+
+/**
+ * @brief Uniform grid over the logical coordinate space used for collision detection
+ * @details The grid is rebuilt every step with a counting sort: balls are
+ *          bucketed by cell, and the positions, radii and velocities are
+ *          gathered in cell order so that the pair tests and responses work on
+ *          contiguous memory; the results are scattered back once per step. The cell size
+ *          is the diameter of a typical ball: the smallest radius that at most
+ *          count / COLLISION_LARGE_SHARE balls exceed, so only the 3x3
+ *          neighbourhood of a cell can contain two overlapping cell balls.
+ *          Balls larger than a cell are sorted into one extra bucket
+ *          after the last cell and tested against each other and against
+ *          the cells their reach covers, so a few huge balls (a:1:255) no
+ *          longer coarsen the grid for everyone. With at most
+ *          COLLISION_LARGE_MIN balls the grid is a single cell and every
+ *          pair is tested.
+ *          The cost follows the number of overlapping pairs: 100k balls
+ *          stay within a 30 ms tick only up to radius 2; at the default
+ *          radius of 20 a step takes about 420 ms.
+ */
+typedef struct {
+    float cell_size;    ///< Cell width and height of the current step
+    int cols, rows;     ///< Grid dimensions of the current step
+    int* cell_start;    ///< Start of each cell in the sorted arrays (cols * rows + 2 entries, the last bucket holds the large balls)
+    int cell_capacity;  ///< Capacity of cell_start
+    int* ball_cell;     ///< Cell of each ball
+    int* sorted_index;  ///< Ball indices in cell order
+    float* sorted_x;    ///< X positions in cell order
+    float* sorted_y;    ///< Y positions in cell order
+    float* sorted_r;    ///< Radii in cell order
+    int* sorted_dx;     ///< Velocity x components in cell order
+    int* sorted_dy;     ///< Velocity y components in cell order
+    int ball_capacity;  ///< Capacity of the per-ball arrays
+    CollisionStats stats; ///< Pair counters
+} CollisionGrid;
+
+/**
+ * @brief Initializes an empty collision grid
+ * @param grid Pointer to the grid to be initialized
+ */
+void collision_grid_init(CollisionGrid* grid);
+
+/**
+ * @brief Frees all memory used by a collision grid
+ * @param grid Pointer to the grid
+ */
+void collision_grid_destroy(CollisionGrid* grid);
+
+/**
+ * @brief Detects and resolves ball-ball collisions for one step
+ * @param grid Pointer to the collision grid
+ * @param list Pointer to the ball list
+ * @details Rebuilds the grid, tests each candidate pair once, and applies an
+ *          elastic response (mass proportional to radius squared) to pairs
+ *          that overlap and approach each other. Overlapping balls are also
+ *          pushed apart so that they do not stick. Velocities are rounded to
+ *          integers and clamped to MIN_SPEED ~ MAX_SPEED; a component never
+ *          becomes 0, so no ball stops moving.
+ */
+void collision_step(CollisionGrid* grid, BallList* list);
+
+#endif // COLLISION_H
@@ -0,0 +1,142 @@
+#ifndef COMMAND_RING_H
+#define COMMAND_RING_H
+
+#include <stdint.h>
+
+#define COMMAND_RING_CAPACITY 256   ///< Commands a ring holds (power of two)
+#define COMMAND_RING_CACHE_LINE 64  ///< Producer and consumer positions live on separate cache lines
+
+/**
+ * @brief A parsed and validated command waiting to be applied to the world
+ */
+typedef struct {
+    int fd;         ///< Client (owner) file descriptor
+    int count;      ///< Ball count, or ball ID for CMD_KILL
+    int radius;     ///< Ball radius for CMD_ADD
+    char cmd;       ///< Command character (CMD_ADD, CMD_KILL, CMD_EXIT, ...)
+} WorldCommand;
+
+/**
+ * @brief Bounded single-producer/single-consumer command ring
+ * @details One ring per producing thread (each worker and the epoll thread);
+ *          the simulation thread is the only consumer. Each side owns its
+ *          position and reads the other's with acquire loads. The producer
+ *          caches the consumer's position so it only touches the consumer's
+ *          cache line when the ring looks full; the consumer reads the
+ *          producer's position once per drain.
+ */
+typedef struct {
+    uint32_t head;              ///< Next position to consume (written by the consumer)
+    char pad0[COMMAND_RING_CACHE_LINE - sizeof(uint32_t)];
+    uint32_t tail;              ///< Next position to produce (written by the producer)
+    uint32_t cached_head;       ///< Producer's last view of head
+    char pad1[COMMAND_RING_CACHE_LINE - 2 * sizeof(uint32_t)];
+    WorldCommand slots[COMMAND_RING_CAPACITY]; ///< Command storage (circular)
+} CommandRing;
+
+/**
+ * @brief Initializes an empty command ring
+ * @param ring Pointer to the ring to be initialized
+ */
+void command_ring_init(CommandRing* ring);
+
+/**
+ * @brief Appends a command (producer side)
+ * @param ring Pointer to the command ring
+ * @param command Command to append
+ * @return 1 on success, 0 if the ring is full
+ */
+int command_ring_push(CommandRing* ring, const WorldCommand* command);
+
+/**
+ * @brief Returns the producer position (consumer side)
+ * @param ring Pointer to the command ring
+ * @return Position one past the last command published so far
+ * @details Pass the result to command_ring_pop() to consume exactly the
+ *          commands published before this call.
+ */
+uint32_t command_ring_end(CommandRing* ring);
+
+/**
+ * @brief Removes the oldest command before end (consumer side)
+ * @param ring Pointer to the command ring
+ * @param end Position returned by command_ring_end()
+ * @param command Receives the removed command
+ * @return 1 if a command was removed, 0 once end has been reached
+ */
+int command_ring_pop(CommandRing* ring, uint32_t end, WorldCommand* command);
+
+/**
+ * @brief Tells whether the consumer has taken every command before pos
+ * @param ring Pointer to the command ring
+ * @param pos Producer position (a value of tail)
+ * @return Non-zero if the commands before pos have been consumed
+ */
+int command_ring_consumed(CommandRing* ring, uint32_t pos);
+
+/**
+ * @brief Bounded multi-producer/single-consumer command ring
+ * @details Used by the reactor threads, which all push into this one ring so
+ *          that the commands of different connections keep a single order
+ *          (a disconnect is always ahead of the connect of a client that
+ *          reuses its fd, whichever reactors handle them). Producers claim a
+ *          position with a compare-and-swap and publish the slot through its
+ *          sequence number, as in TaskQueue.
+ */
+typedef struct {
+    uint32_t head;              ///< Next position to consume (written by the consumer)
+    char pad0[COMMAND_RING_CACHE_LINE - sizeof(uint32_t)];
+    uint32_t tail;              ///< Next position to claim (atomic, shared by the producers)
+    char pad1[COMMAND_RING_CACHE_LINE - sizeof(uint32_t)];
+    uint32_t seq[COMMAND_RING_CAPACITY];       ///< Per-slot sequence numbers
+    WorldCommand slots[COMMAND_RING_CAPACITY]; ///< Command storage (circular)
+} SharedCommandRing;
+
+/**
+ * @brief Initializes an empty shared command ring
+ * @param ring Pointer to the ring to be initialized
+ */
+void shared_command_ring_init(SharedCommandRing* ring);
+
+/**
+ * @brief Appends a command (any producer thread)
+ * @param ring Pointer to the shared command ring
+ * @param command Command to append
+ * @return 1 on success, 0 if the ring is full
+ */
+int shared_command_ring_push(SharedCommandRing* ring, const WorldCommand* command);
+
+/**
+ * @brief Returns the end of the commands published so far (consumer side)
+ * @param ring Pointer to the shared command ring
+ * @return Position one past the last command of the contiguous published run
+ * @details A slot claimed by a producer that has not finished writing it
+ *          ends the run; it is picked up by a later call.
+ */
+uint32_t shared_command_ring_end(SharedCommandRing* ring);
+
+/**
+ * @brief Removes the oldest command before end (consumer side)
+ * @param ring Pointer to the shared command ring
+ * @param end Position returned by shared_command_ring_end()
+ * @param command Receives the removed command
+ * @return 1 if a command was removed, 0 once end has been reached
+ */
+int shared_command_ring_pop(SharedCommandRing* ring, uint32_t end, WorldCommand* command);
+
+/**
+ * @brief Returns the next position producers will claim
+ * @param ring Pointer to the shared command ring
+ * @return Position one past every command claimed so far
+ */
+uint32_t shared_command_ring_tail(SharedCommandRing* ring);
+
+/**
+ * @brief Tells whether the consumer has taken every command before pos
+ * @param ring Pointer to the shared command ring
+ * @param pos Position returned by shared_command_ring_tail()
+ * @return Non-zero if the commands before pos have been consumed
+ */
+int shared_command_ring_consumed(SharedCommandRing* ring, uint32_t pos);
+
+#endif // COMMAND_RING_H
@@ -0,0 +1,63 @@
+#ifndef INPUT_BUFFER_H
+#define INPUT_BUFFER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define INPUT_BUFFER_SIZE 512       ///< Bytes buffered per connection (longest command + delimiter)
+#define COMMAND_DELIMITER '\n'      ///< Ends every command on the wire ("a:3\n"); a preceding '\r' is ignored
+#define INPUT_NONE (-1)             ///< input_buffer_next(): no complete command buffered
+#define INPUT_TOO_LONG (-2)         ///< input_buffer_next(): a command exceeded INPUT_BUFFER_SIZE and is dropped
+
+/**
+ * @brief Bytes received from one connection that are not yet split into commands
+ * @details TCP delivers a byte stream: one recv() may return several
+ *          commands, or the first half of one. The reactor receives straight
+ *          into the free space of the buffer and then takes every complete,
+ *          delimiter-terminated command out of it; an incomplete command stays
+ *          at the front until the rest arrives. Only the reactor that owns the
+ *          connection touches it, so it needs no synchronization.
+ */
+typedef struct {
+    uint32_t start;                 ///< Offset of the first byte not yet returned as a command
+    uint32_t end;                   ///< Offset just past the last received byte
+    int discarding;                 ///< Dropping the rest of an over-long command up to its delimiter
+    char data[INPUT_BUFFER_SIZE];   ///< Received bytes
+} InputBuffer;
+
+/**
+ * @brief Empties the buffer (new connection on the fd)
+ * @param in Pointer to the input buffer
+ */
+void input_buffer_reset(InputBuffer* in);
+
+/**
+ * @brief Returns the free space to receive into
+ * @param in Pointer to the input buffer
+ * @param avail Receives the number of free bytes (always at least 1)
+ * @return Where the next received bytes must be written
+ * @details Moves a buffered incomplete command to the front first, so the
+ *          whole remaining space is contiguous.
+ */
+char* input_buffer_space(InputBuffer* in, size_t* avail);
+
+/**
+ * @brief Marks bytes written to input_buffer_space() as received
+ * @param in Pointer to the input buffer
+ * @param len Number of bytes received
+ */
+void input_buffer_commit(InputBuffer* in, size_t len);
+
+/**
+ * @brief Takes the next complete command out of the buffer
+ * @param in Pointer to the input buffer
+ * @param cmd Receives the command, '\0'-terminated in place without its
+ *            delimiter; valid until the next input_buffer_space() call
+ * @return Length of the command, INPUT_NONE if no complete command is
+ *         buffered, or INPUT_TOO_LONG once for a command that does not fit
+ *         in the buffer (its bytes are dropped up to the next delimiter)
+ * @details Empty lines are skipped.
+ */
+int input_buffer_next(InputBuffer* in, char** cmd);
+
+#endif // INPUT_BUFFER_H
@@ -11,8 +11,12 @@
 #include <sys/ioctl.h>
 #include <errno.h>
 #include <time.h>
+#include <stdint.h>
 #include "console_color.h"
 
+#define START_BALL_SPEED 2  ///< Speed of a new ball along each axis (direction is random)
+#define BALL_PALETTE_SIZE 6 ///< Number of colors a ball can have (5 owner colors + fallback)
+
 /**
  * @brief Structure representing RGB color information
  * @details This structure stores the red, green, and blue channel values
@@ -62,39 +66,18 @@ typedef struct {
 } LogicalBall;
 
 /**
- * @brief Creates a ball in the logical coordinate system
- * @param id Unique identifier for the ball
- * @param radius Radius of the ball
- * @return A newly created LogicalBall object
- * @details Creates a new ball with the specified ID and radius, initializes
- *          its position to a random location within the logical coordinate space,
- *          sets a random velocity, and assigns a random color.
- * @date 2025-04-07
- * @author Kim Hyo Jin
+ * @brief Ball color palette
+ * @details The server stores a 1-byte palette index per ball instead of an
+ *          RGB triple. Entries 0 ~ 4 are the owner colors (owner_id % 5) and
+ *          the last entry is the fallback gray.
  */
-LogicalBall create_logical_ball(int id, int radius, int owner_id);
+extern const RGBColor ball_palette[BALL_PALETTE_SIZE];
 
 /**
- * @brief Gets the color of a ball based on its owner ID
+ * @brief Gets the palette index of an owner's color
  * @param owner_id The ID of the ball's owner
- * @return A RGBColor structure representing the ball's color
- * @details Returns a color based on the owner ID, with a default fallback color
- *          if the ID is not recognized.
- * @date 2025-04-07
- * @author Kim Hyo Jin
- */
-RGBColor get_color_by_owner(int owner_id);  
-
-/**
- * @brief Moves a ball in the logical coordinate system
- * @param b Pointer to the ball object to be moved
- * @details Updates the ball's position by adding its velocity components to
- *          its current position. If the ball reaches the boundaries of the
- *          logical coordinate space, its velocity is reversed to create a
- *          bouncing effect.
- * @date 2025-04-07
- * @author Kim Hyo Jin
+ * @return Index into ball_palette
  */
-void move_logical_ball(LogicalBall *b);
+uint8_t get_palette_index_by_owner(int owner_id);
 
 #endif // LOCAL_BALL_H
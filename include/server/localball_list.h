@@ -6,91 +6,331 @@
 #define MAX_SPEED 2000
 #define MIN_SPEED -2000
 
+// 고정소수점 위치: Q10.6 (정수부 10비트 = 0 ~ 1000, 소수부 6비트)
+#define BALL_FIXED_SHIFT 6                          ///< Fraction bits of a stored position
+#define BALL_FIXED_ONE (1 << BALL_FIXED_SHIFT)      ///< 1.0 in stored position units
+#define BALL_WORLD_FIXED (1000 * BALL_FIXED_ONE)    ///< World size in stored position units
+#define BALL_MAX_RADIUS 255                         ///< Largest radius that fits the 1-byte radius field
+#define BALL_MAX_OWNER_ID UINT16_MAX                ///< Largest owner ID that fits the 2-byte owner field
+
+// 소유자별 속도 단계: 실제 속도 = 저장된 속도 * 2^level (MIN_SPEED ~ MAX_SPEED, 최소 크기 1)
+#define SPEED_LEVEL_MAX 11      ///< 2^11 > MAX_SPEED: every ball of the owner runs at MAX_SPEED
+#define SPEED_LEVEL_MIN -11     ///< 2^-11 * MAX_SPEED < 1: every ball of the owner runs at speed 1
+
+#define BALL_LIST_INIT_CAPACITY 64  ///< Capacity reserved on the first insertion
+#define OWNER_SET_INIT_CAPACITY 8   ///< Capacity reserved for an owner's first ball
+#define SPAWN_BATCH 256             ///< Balls generated per batch by spawnBalls()
+
+// Ball ID = (generation << BALL_HANDLE_INDEX_BITS) | handle slot
+#define BALL_HANDLE_INDEX_BITS 20   ///< Bits of a ball ID used for the handle slot
+#define BALL_HANDLE_INDEX_MASK ((1 << BALL_HANDLE_INDEX_BITS) - 1)
+#define BALL_HANDLE_GEN_MASK ((1 << (31 - BALL_HANDLE_INDEX_BITS)) - 1) ///< Keeps IDs positive
+#define BALL_HANDLE_MAX_SLOTS (1 << BALL_HANDLE_INDEX_BITS) ///< Maximum number of live balls
 
 /**
- * @brief A node structure for storing ball objects in a linked list
- * @details This structure represents a node in a singly linked list that stores ball objects.
- *          Each node contains a ball object and a pointer to the next node in the list.
- * @date 2025-04-07
- * @author Kim Hyo Jin
+ * @brief Slot of the generational handle table
+ * @details A ball ID names a slot and the generation the slot had when the
+ *          ball was created. The generation is bumped whenever the slot is
+ *          released, and released slots are reused in FIFO order, so an ID
+ *          of a deleted ball only resolves again after its slot has been
+ *          released BALL_HANDLE_GEN_MASK + 1 (2048) times, and after every
+ *          other free slot has been reused in between.
  */
-typedef struct BallListNode {
-    LogicalBall data;           ///< The ball object stored in this node
-    struct BallListNode* next;  ///< Pointer to the next node in the linked list
-} BallListNode;
+typedef struct {
+    int index;          ///< Index of the ball in the list, or -1 if the slot is free
+    int generation;     ///< Current generation of the slot
+    int next_free;      ///< Next slot in the free list (valid while free)
+} BallHandleSlot;
 
 /**
- * @brief Creates a new node with the given ball object
- * @param ball The ball object to be stored in the new node
- * @return A pointer to the newly created node, or NULL if memory allocation fails
- * @details Allocates memory for a new node, initializes it with the given ball object,
- *          and sets the next pointer to NULL.
- * @date 2025-04-07
- * @author Kim Hyo Jin
+ * @brief Set of the balls owned by one client
+ * @details Holds the list indices of every ball of the owner, in insertion
+ *          order until a ball other than the newest one is removed.
+ *          speed_min/speed_max bound the base velocity magnitudes of the
+ *          owner's balls, so speed commands can tell in O(1) when every
+ *          ball is already clamped. They are widened by spawns, recomputed
+ *          exactly by every collision write-back and may stay wider than
+ *          needed after removals until then.
  */
-BallListNode* createNode(LogicalBall ball);
+typedef struct {
+    int* index;         ///< Indices of the owner's balls in the ball list
+    int count;          ///< Number of balls owned
+    int capacity;       ///< Capacity of the index array
+    int speed_min;      ///< Smallest base velocity magnitude (valid while count > 0)
+    int speed_max;      ///< Largest base velocity magnitude (valid while count > 0)
+} OwnerBallSet;
 
 /**
- * @brief Appends a ball to the end of the linked list
- * @param head Pointer to the head of the linked list
- * @param tail Double pointer to the tail of the linked list
- * @param ball The ball object to be appended
- * @return A pointer to the newly created node
- * @details Creates a new node with the given ball object and appends it to the end of the list.
- *          If the list is empty, the new node becomes both the head and tail.
- * @date 2025-04-07
- * @author Kim Hyo Jin
+ * @brief Contiguous struct-of-arrays storage for ball objects
+ * @details Every ball property lives in its own densely packed array, so that
+ *          per-tick passes (movement, serialization, counting) stream linearly
+ *          through memory instead of chasing heap pointers. Slot i of every
+ *          array describes the same ball.
+ *          Properties are stored in a compact form: Q10.6 fixed-point
+ *          positions, 16-bit velocities in whole units per tick, a 1-byte
+ *          radius and a 1-byte palette index, so the movement pass reads
+ *          9 bytes per ball. Deletion swaps the last ball into
+ *          the freed slot, so the order of balls is not preserved.
+ *          An owner -> ball-set index, indexed by owner ID (the client socket
+ *          fd), is kept in sync on every insertion and removal so that
+ *          owner-scoped operations only visit the owner's balls.
+ *          dx/dy hold each ball's base velocity; the movement kernels scale it
+ *          by the owner's speed level (see scaleSpeed()), so speed commands
+ *          update a single value per owner.
+ */
+typedef struct {
+    uint16_t* x;        ///< Logical center x positions, Q10.6 (0 ~ BALL_WORLD_FIXED)
+    uint16_t* y;        ///< Logical center y positions, Q10.6 (0 ~ BALL_WORLD_FIXED)
+    int16_t* dx;        ///< Velocity x components (logical units per tick)
+    int16_t* dy;        ///< Velocity y components (logical units per tick)
+    uint8_t* radius;    ///< Logical radii (0 ~ BALL_MAX_RADIUS)
+    uint16_t* owner_id; ///< Owner IDs (client socket fd)
+    uint8_t* palette;   ///< Color of each ball as an index into ball_palette
+    int* id;            ///< Ball IDs (generational handles, see BallHandleSlot)
+    int* owner_slot;    ///< Position of each ball in its owner's ball set
+    int count;          ///< Number of balls currently stored
+    int capacity;       ///< Number of balls the arrays can hold without growing
+    OwnerBallSet* owners; ///< Ball sets indexed by owner ID
+    int* owner_speed_level; ///< Speed level of each owner (owner_capacity entries)
+    float* owner_speed_scale; ///< 2^level of each owner, for kernels without variable shifts
+    int owner_capacity; ///< Number of entries in owners and the owner speed tables
+    int scaled_owners;  ///< Number of owners whose speed level is not 0
+    BallHandleSlot* handles; ///< Handle table mapping ball IDs to list indices
+    int handle_count;   ///< Number of slots ever used
+    int handle_capacity; ///< Capacity of the handle table
+    int free_handle;    ///< Head of the free slot list (reused first), or -1
+    int free_handle_tail; ///< Tail of the free slot list (released last), or -1
+} BallList;
+
+/**
+ * @brief Memory used by a single ball in the struct-of-arrays storage
+ *        (including its entry in the owner index and the handle table)
+ */
+#define BALL_LIST_ELEM_SIZE \
+    (4 * sizeof(uint16_t) + 2 * sizeof(int16_t) + 2 * sizeof(uint8_t) + \
+     3 * sizeof(int) + sizeof(BallHandleSlot))
+
+/**
+ * @brief Converts a logical coordinate to the stored Q10.6 form
+ * @param pos Logical coordinate (clamped to 0.0 ~ 1000.0)
+ * @return Rounded fixed-point coordinate
+ */
+static inline uint16_t toFixedPos(float pos) {
+    if (pos <= 0.0f) return 0;
+    if (pos >= 1000.0f) return BALL_WORLD_FIXED;
+    return (uint16_t)(pos * BALL_FIXED_ONE + 0.5f);
+}
+
+/**
+ * @brief Converts a stored Q10.6 coordinate to a logical coordinate
+ * @param pos Fixed-point coordinate
+ * @return Logical coordinate (exact)
+ */
+static inline float fromFixedPos(uint16_t pos) {
+    return (float)pos * (1.0f / BALL_FIXED_ONE);
+}
+
+/**
+ * @brief Applies an owner speed level to a base velocity component
+ * @param v Base velocity component
+ * @param level Speed level (SPEED_LEVEL_MIN ~ SPEED_LEVEL_MAX)
+ * @return v * 2^level, with the magnitude clamped to 1 ~ MAX_SPEED (0 stays 0)
+ */
+static inline int scaleSpeed(int v, int level) {
+    if (v == 0 || level == 0) return v;
+    int a = (v < 0) ? -v : v;
+    a = (level > 0) ? (a << level) : (a >> -level);
+    if (a > MAX_SPEED) a = MAX_SPEED;
+    if (a < 1) a = 1;
+    return (v < 0) ? -a : a;
+}
+
+/**
+ * @brief Converts an effective velocity component back to a base velocity
+ * @param v Effective velocity component
+ * @param level Speed level (SPEED_LEVEL_MIN ~ SPEED_LEVEL_MAX)
+ * @return Rounded v / 2^level, with the magnitude clamped to 1 ~ MAX_SPEED (0 stays 0)
+ * @details Used when a velocity is changed from outside the kernels (collisions).
+ */
+static inline int unscaleSpeed(int v, int level) {
+    if (v == 0 || level == 0) return v;
+    int a = (v < 0) ? -v : v;
+    a = (level > 0) ? ((a + (1 << (level - 1))) >> level) : (a << -level);
+    if (a > MAX_SPEED) a = MAX_SPEED;
+    if (a < 1) a = 1;
+    return (v < 0) ? -a : a;
+}
+
+/**
+ * @brief Widens an owner's base speed range to include a velocity component
+ * @param set Ball set of the owner
+ * @param v Base velocity component (0 is ignored: it is never scaled)
+ */
+static inline void noteOwnerSpeed(OwnerBallSet* set, int v) {
+    int a = (v < 0) ? -v : v;
+    if (a == 0) return;
+    if (a < set->speed_min) set->speed_min = a;
+    if (a > set->speed_max) set->speed_max = a;
+}
+
+/**
+ * @brief Clamps a radius to 0 ~ BALL_MAX_RADIUS for storage
+ * @param r Radius
+ * @return Clamped radius
  */
-BallListNode* appendBall(BallListNode* head, BallListNode** tail, LogicalBall ball);
+static inline uint8_t toStoredRadius(int r) {
+    if (r < 0) return 0;
+    if (r > BALL_MAX_RADIUS) return BALL_MAX_RADIUS;
+    return (uint8_t)r;
+}
 
 /**
- * @brief Prints information about all balls in the linked list
- * @param head Pointer to the head of the linked list
- * @details Traverses the linked list and prints the properties of each ball object.
+ * @brief Initializes an empty ball list
+ * @param list Pointer to the ball list to be initialized
+ * @details Sets every array to NULL and the count and capacity to 0.
+ *          No memory is allocated until the first ball is appended.
+ */
+void initBallList(BallList* list);
+
+/**
+ * @brief Grows the ball list so that it can hold at least the given number of balls
+ * @param list Pointer to the ball list
+ * @param capacity Minimum number of balls the list must be able to hold
+ * @return 0 on success, -1 if memory allocation fails or the capacity would exceed INT_MAX
+ * @details Capacity grows geometrically, so repeated appends are amortized O(1).
+ *          On failure the list keeps its previous contents and capacity.
+ */
+int reserveBallList(BallList* list, int capacity);
+
+/**
+ * @brief Creates balls of an owner at random positions, in bulk
+ * @param list Pointer to the ball list
+ * @param count Number of balls to create (clamped so that at most
+ *              BALL_HANDLE_MAX_SLOTS balls are alive)
+ * @param radius Radius of the balls (clamped to BALL_MAX_RADIUS)
+ * @param owner_id The owner ID of the balls
+ * @return Number of balls created (less than count if memory or handles run out,
+ *         0 if the owner ID is outside 0 ~ BALL_MAX_OWNER_ID)
+ * @details Each ball gets a random position and diagonal direction. The
+ *          arrays, the owner set and the handle table are grown once up
+ *          front, and positions and directions are generated in batches of
+ *          SPAWN_BATCH straight into the arrays with the per-thread RNG
+ *          (see rng.h).
+ */
+int spawnBalls(BallList* list, int count, int radius, int owner_id);
+
+/**
+ * @brief Removes the ball at the given index
+ * @param list Pointer to the ball list
+ * @param index Index of the ball to be removed
+ * @details Moves the last ball into the freed slot (swap-remove), so removal is O(1).
+ *          Indices greater than or equal to the new count become invalid.
+ *          The owner index and the handle table are updated for both the removed
+ *          and the moved ball, and the removed ball's ID becomes invalid.
+ */
+void removeBallAt(BallList* list, int index);
+
+/**
+ * @brief Finds a ball by ID
+ * @param list Pointer to the ball list
+ * @param id Ball ID
+ * @return Index of the ball in the list, or -1 if no live ball has this ID
+ * @details O(1) lookup through the handle table. The index can be used to read
+ *          or update the ball's properties until the next insertion or removal.
+ */
+int findBall(const BallList* list, int id);
+
+/**
+ * @brief Removes every ball of an owner
+ * @param list Pointer to the ball list
+ * @param owner_id The owner ID of the balls
+ * @return Number of balls removed
+ * @details Costs O(number of balls owned). The owner's index storage is freed.
+ */
+int removeOwnerBalls(BallList* list, int owner_id);
+
+/**
+ * @brief Returns the ball set of an owner
+ * @param list Pointer to the ball list
+ * @param owner_id The owner ID of the balls
+ * @return Pointer to the owner's ball set, or NULL if the owner has never owned a ball
+ * @details The returned set is invalidated by the next insertion or removal.
+ */
+const OwnerBallSet* getOwnerBalls(const BallList* list, int owner_id);
+
+/**
+ * @brief Empties the base speed range of every owner before it is recomputed
+ * @param list Pointer to the ball list
+ * @details Call noteOwnerSpeed() for both velocity components of every ball
+ *          afterwards, otherwise speed commands see stale ranges.
+ */
+void resetOwnerSpeedRanges(BallList* list);
+
+/**
+ * @brief Prints information about all balls in the list
+ * @param list Pointer to the ball list
+ * @details Prints the properties of each ball object.
  *          This function is primarily used for debugging purposes.
  * @date 2025-04-07
  * @author Kim Hyo Jin
  */
-void printInfoBall(BallListNode *head);
+void printInfoBall(const BallList* list);
 
 /**
- * @brief Updates the position of all balls in the linked list
- * @param head Pointer to the head of the linked list
- * @details Traverses the linked list and updates the position of each ball object
- *          based on its current velocity. This function is called periodically to animate the balls.
- * @date 2025-04-07
- * @author Kim Hyo Jin
+ * @brief Sets the speed level of an owner
+ * @param list Pointer to the ball list
+ * @param owner_id The owner ID of the balls
+ * @param level New speed level (clamped to SPEED_LEVEL_MIN ~ SPEED_LEVEL_MAX)
+ * @return The level that was set (0 if the owner ID is invalid or memory allocation fails)
+ * @details O(1). Every ball of the owner moves at scaleSpeed(base, level)
+ *          from the next step on. The level is reset to 0 by removeOwnerBalls().
+ */
+int setOwnerSpeedLevel(BallList* list, int owner_id, int level);
+
+/**
+ * @brief Returns the speed level of an owner
+ * @param list Pointer to the ball list
+ * @param owner_id The owner ID of the balls
+ * @return Speed level of the owner (0 for an unknown owner)
  */
-void moveBallList(BallListNode* head);
+int getOwnerSpeedLevel(const BallList* list, int owner_id);
 
 /**
- * @brief Increases the velocity of all balls in the linked list
- * @param head Pointer to the head of the linked list
- * @details Traverses the linked list and increases the velocity (dx, dy) of each ball object.
- *          This function is called when the user requests to speed up the balls.
+ * @brief Increases the velocity of the balls of an owner
+ * @param list Pointer to the ball list
+ * @param owner_id The owner ID of the balls
+ * @return New speed level of the owner
+ * @details Raises the owner's speed level by one, which doubles the velocity
+ *          of each of the owner's balls up to MAX_SPEED. Once every ball is
+ *          at MAX_SPEED the level is left unchanged, so the next slow-down
+ *          takes effect at once. O(1): no ball is visited. This function is called when the user requests to speed up the balls.
  * @date 2025-04-07
  * @author Kim Hyo Jin
  */
-void speedUpBalls(BallListNode* head, int owner_id);
+int speedUpBalls(BallList* list, int owner_id);
 
 /**
- * @brief Decreases the velocity of all balls in the linked list
- * @param head Pointer to the head of the linked list
- * @details Traverses the linked list and decreases the velocity (dx, dy) of each ball object.
- *          This function is called when the user requests to slow down the balls.
+ * @brief Decreases the velocity of the balls of an owner
+ * @param list Pointer to the ball list
+ * @param owner_id The owner ID of the balls
+ * @return New speed level of the owner
+ * @details Lowers the owner's speed level by one, which halves the velocity
+ *          of each of the owner's balls down to a magnitude of 1. Once every
+ *          ball is at 1 the level is left unchanged, so the next speed-up
+ *          doubles at once. O(1): no ball is visited. This function is called when the user requests to slow down the balls.
  * @date 2025-04-07
  * @author Kim Hyo Jin
  */
-void speedDownBalls(BallListNode* head, int owner_id);
+int speedDownBalls(BallList* list, int owner_id);
 
 /**
- * @brief Frees all memory allocated for the linked list
- * @param head Double pointer to the head of the linked list
- * @details Traverses the linked list and frees the memory allocated for each node.
- *          After this function is called, the head pointer is set to NULL.
+ * @brief Frees all memory allocated for the ball list
+ * @param list Pointer to the ball list
+ * @details Frees every property array, the owner index, the owner speed levels and the handle table. After this function is called,
+ *          the list is empty and can be reused.
  * @date 2025-04-07
  * @author Kim Hyo Jin
  */
-void freeBallList(BallListNode** head);
+void freeBallList(BallList* list);
 
-#endif //LOCAL_BALL_NODE_H
\ No newline at end of file
+#endif //LOCAL_BALL_NODE_H
@@ -15,6 +15,8 @@
 
 #include "console_color.h"
 #include "localball_list.h"
+#include "collision.h"
+#include "snapshot.h"
 #include "log.h"
 
 // Command definitions
@@ -23,23 +25,27 @@
 #define CMD_SPEED_UP 'w'
 #define CMD_SPEED_DOWN 's'
 #define CMD_EXIT 'x'
+#define CMD_KILL 'k'
 
 // Ball properties for initialization
 #define START_BALL_COUNT 5
 #define START_BALL_RADIUS 20
+#define BALL_TEXT_MAX 64    ///< Upper bound of one serialized ball ("id,x.xx,y.yy,dx,dy,r,R,G,B|")
 
 /**
  * @brief Structure representing a ball manager
  * @details This structure manages a collection of balls and provides
  *          functionality for adding, removing, and updating balls.
+ *          The balls are stored contiguously in a struct-of-arrays list.
  * @date 2025-04-07
  * @author Kim Hyo Jin
  */
 typedef struct {
-    BallListNode* head;  ///< Pointer to the first ball in the list
-    BallListNode* tail;  ///< Pointer to the last ball in the list
+    BallList balls;      ///< Struct-of-arrays storage of every ball in the world
+    CollisionGrid collision; ///< Spatial grid used by the ball-ball collision stage
+    SnapshotStore snapshots; ///< Per-tick world snapshots, read without mutex_ball
     pthread_mutex_t mutex_ball; ///< Mutex for synchronizing ball list operations
-    int total_count;     ///< Total number of balls in the list
+    int total_count;     ///< Number of live balls in the list (ball IDs are issued by the handle table)
 } BallListManager;
 
 /**
@@ -47,10 +53,10 @@ typedef struct {
  * @param BallListManager* Pointer to the ball list manager
  * @param int Number of balls
  * @param int Radius of balls
- * @date 2025-04-07
- * @author Kim Hyo Jin
+ * @param int Owner ID of the requesting client
+ * @return 0 on success, -1 if the command could not be applied
  */
-typedef void (*CommandHandler)(BallListManager*, int, int, int);
+typedef int (*CommandHandler)(BallListManager*, int, int, int);
 
 /**
  * @brief Structure mapping commands to their handler functions
@@ -81,7 +87,7 @@ void ball_manager_init(BallListManager* manager);
 /**
  * @brief Destroys a ball list manager
  * @param manager Pointer to the ball list manager to be destroyed
- * @details Frees all nodes in the ball list and the manager itself.
+ * @details Frees the ball storage and destroys the mutex.
  * @date 2025-04-07
  * @author Kim Hyo Jin
  */
@@ -92,7 +98,9 @@ void ball_manager_destroy(BallListManager* manager);
  * @param manager Pointer to the ball list manager
  * @param count Number of balls to add
  * @param radius Radius of the balls to add
- * @details Creates and adds balls with the specified count and radius to the list.
+ * @details Creates and adds balls with the specified count and radius to the list
+ *          through the bulk spawner (spawnBalls()). Only a one-line summary is
+ *          printed, so large spawns do not stall the tick.
  * @date 2025-04-07
  * @author Kim Hyo Jin
  */
@@ -102,52 +110,65 @@ void add_ball(BallListManager* manager, int count, int radius, int owner_id);
  * @brief Deletes balls from the ball list
  * @param manager Pointer to the ball list manager
  * @param count Number of balls to delete
- * @details Removes the specified number of balls from the end of the list.
+ * @details Removes up to the specified number of the owner's most recently
+ *          added balls. Costs O(count), independent of the world size.
  * @date 2025-04-07
  * @author Kim Hyo Jin
  */
 void delete_ball(BallListManager* manager, int count, int owner_id);
 
+/**
+ * @brief Deletes a single ball of the owner by ID
+ * @param manager Pointer to the ball list manager
+ * @param ball_id ID of the ball to delete
+ * @param owner_id Client requesting the deletion
+ * @return Owner ID of the deleted ball, or -1 if the requester owns no live ball with this ID
+ * @details O(1) through the generational handle table. A stale ID fails
+ *          instead of deleting a newer ball until its slot's 11-bit
+ *          generation wraps (see BallHandleSlot). Another player's ball is
+ *          treated as missing, so a client cannot delete balls it does not own.
+ */
+int kill_ball(BallListManager* manager, int ball_id, int owner_id);
+
 /**
  * @brief Deletes balls from the ball list by socket
  * @param manager Pointer to the ball list manager
  * @param socket_fd The socket file descriptor of the client
  * @details Deletes all balls owned by the specified client from the ball list.
+ *          Costs O(number of balls owned by the client).
  * @date 2025-04-07
  * @author Kim Hyo Jin
  */
 void delete_ball_by_socket(BallListManager* manager, int socket_fd);
 
 /**
- * @brief Updates the positions of all balls
+ * @brief Resolves ball-ball collisions of all balls
  * @param manager Pointer to the ball list manager
- * @details Updates the position and velocity of all balls in the list.
- * @date 2025-04-07
- * @author Kim Hyo Jin
+ * @details Runs one collision step over the uniform grid (see collision.h).
+ *          Called once per tick after the balls have been moved.
  */
-void move_all_ball(BallListManager* manager);
+void collide_all_ball(BallListManager* manager);
 
 /**
- * @brief Serializes the ball list into a string
- * @param manager Pointer to the ball list manager
- * @return Serialized ball list string (memory must be freed by caller)
- * @details Converts all ball information in the list to a string format.
- * @date 2025-04-07
- * @author Kim Hyo Jin
+ * @brief Encodes every ball of a world snapshot into a caller-provided buffer
+ * @param snap Snapshot taken with snapshot_acquire() (NULL encodes nothing)
+ * @param buf Destination, at least snap->count * BALL_TEXT_MAX bytes
+ * @return Number of bytes written (no terminating '\0')
+ * @details Formats the numbers without snprintf() and never reallocates,
+ *          so the per-tick frame is encoded in one pass.
  */
-char* serialize_ball_list(BallListManager* manager, int owner_id);
-
-char* serialize_ball_list_all(BallListManager* manager);
+size_t encode_snapshot_all(const WorldSnapshot* snap, char* buf);
 
 /**
  * @brief Counts the number of balls by owner
- * @param head Pointer to the head of the ball list
+ * @param list Pointer to the ball list
  * @param owner_id The owner ID of the balls
  * @return The number of balls owned by the specified client
+ * @details O(1): read from the owner index.
  * @date 2025-04-07
  * @author Kim Hyo Jin
  */
-int count_ball_by_owner(BallListNode* head, int owner_id);
+int count_ball_by_owner(const BallList* list, int owner_id);
 
 /**
  * @brief Logs the memory usage of the ball list
@@ -166,10 +187,11 @@ void log_ball_memory_usage(BallListManager* manager, const char* action, int fd,
  * @param count Number of balls to add
  * @param radius Radius of the balls to add
  * @param owner_id The owner ID of the balls
+ * @return 0
  * @date 2025-04-07
  * @author Kim Hyo Jin
  */
-void handle_add(BallListManager* m, int count, int radius, int owner_id);
+int handle_add(BallListManager* m, int count, int radius, int owner_id);
 
 /**
  * @brief Handles the delete ball command
@@ -177,10 +199,11 @@ void handle_add(BallListManager* m, int count, int radius, int owner_id);
  * @param count Number of balls to delete
  * @param radius Unused parameter (maintained for function signature consistency)
  * @param owner_id The owner ID of the balls
+ * @return 0
  * @date 2025-04-07
  * @author Kim Hyo Jin
  */
-void handle_delete(BallListManager* m, int count, int radius, int owner_id);
+int handle_delete(BallListManager* m, int count, int radius, int owner_id);
 
 /**
  * @brief Handles the speed up command
@@ -188,10 +211,11 @@ void handle_delete(BallListManager* m, int count, int radius, int owner_id);
  * @param count Number of balls to speed up
  * @param radius Unused parameter (maintained for function signature consistency)
  * @param owner_id The owner ID of the balls
+ * @return 0
  * @date 2025-04-07
  * @author Kim Hyo Jin
  */
-void handle_speed_up(BallListManager* m, int count, int radius, int owner_id);
+int handle_speed_up(BallListManager* m, int count, int radius, int owner_id);
 
 /**
  * @brief Handles the speed down command
@@ -199,10 +223,21 @@ void handle_speed_up(BallListManager* m, int count, int radius, int owner_id);
  * @param count Number of balls to slow down
  * @param radius Unused parameter (maintained for function signature consistency)
  * @param owner_id The owner ID of the balls
+ * @return 0
  * @date 2025-04-07
  * @author Kim Hyo Jin
  */
-void handle_speed_down(BallListManager* m, int count, int radius, int owner_id);
+int handle_speed_down(BallListManager* m, int count, int radius, int owner_id);
+
+/**
+ * @brief Handles the targeted delete command (k:<id>)
+ * @param m Pointer to the ball list manager
+ * @param ball_id ID of the ball to delete
+ * @param radius Unused parameter (maintained for function signature consistency)
+ * @param owner_id The owner ID of the requesting client (only its own balls may be deleted)
+ * @return 0 if the ball was deleted, -1 if the client owns no live ball with this ID
+ */
+int handle_kill(BallListManager* m, int ball_id, int radius, int owner_id);
 
 /**
  * @brief Dispatches commands to their handler functions
@@ -211,10 +246,11 @@ void handle_speed_down(BallListManager* m, int count, int radius, int owner_id);
  * @param radius Radius of balls for command processing
  * @param owner_id The owner ID of the balls
  * @param m Pointer to the ball list manager
+ * @return Result of the handler, or -1 if the command is unknown
  * @details Calls the appropriate handler function based on the command.
  * @date 2025-04-07
  * @author Kim Hyo Jin
  */
-void dispatch_command(BallListManager* m, char cmd, int count, int radius, int owner_id);
+int dispatch_command(BallListManager* m, char cmd, int count, int radius, int owner_id);
 
 #endif // LOCAL_BALL_MANAGER_H
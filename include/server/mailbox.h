@@ -0,0 +1,134 @@
+#ifndef MAILBOX_H
+#define MAILBOX_H
+
+#include <pthread.h>
+#include <stdint.h>
+#include "task.h"
+#include "input_buffer.h"
+#include "out_queue.h"
+
+#define MAILBOX_CAPACITY 64         ///< Commands queued per connection (must be a power of two)
+#define MAILBOX_DRAIN_BUDGET 8      ///< Commands a worker runs before handing the mailbox back
+#define MAILBOX_PAGE_SIZE 64        ///< Mailboxes allocated together on first use
+#define MAILBOX_MAX_PAGES 1024      ///< Pages in the table (fds below MAILBOX_PAGE_SIZE * MAILBOX_MAX_PAGES)
+
+/**
+ * @brief Ordered command queue of one connection
+ * @details The reactor that owns the connection is the only producer. The
+ *          consumer is whichever worker holds the mailbox's token: the
+ *          producer that finds the mailbox unscheduled submits one token
+ *          (a Task carrying only the fd) to the worker pool, and the worker
+ *          that takes it runs the queued commands in order, then clears
+ *          scheduled and submits the token again if more commands arrived.
+ *          At most one worker processes a connection at a time, so its
+ *          commands run in arrival order however the tokens are stolen,
+ *          while different connections run in parallel.
+ */
+typedef struct {
+    uint32_t head;          ///< Next command to run (written by the token holder)
+    char pad0[TASK_CACHE_LINE - sizeof(uint32_t)];
+    uint32_t tail;          ///< Next free position (written by the reactor)
+    int scheduled;          ///< 1 while a token is queued or held by a worker (atomic)
+    int closed;             ///< Set when the connection ends; later commands are dropped (atomic)
+    int eof_queued;         ///< Reactor only: the disconnect has been queued
+    int fence_set;          ///< Token holder only: fence_ring/fence_pos are valid
+    int fence_ring;         ///< Command ring that received this connection's last world command
+    uint32_t fence_pos;     ///< Position in fence_ring just past that command
+    unsigned long long scheduled_ns; ///< When the current token was submitted (queue wait metric)
+    char pad1[TASK_CACHE_LINE - 5 * sizeof(int) - 2 * sizeof(uint32_t) - sizeof(unsigned long long)];
+    Task slots[MAILBOX_CAPACITY]; ///< Queued commands (circular)
+    InputBuffer input;      ///< Reactor only: received bytes not yet split into commands
+    OutQueue out;           ///< Bytes waiting to be written to the connection (own mutex)
+} Mailbox;
+
+/**
+ * @brief fd-indexed table of connection mailboxes
+ * @details Pages are allocated on first use and kept until the table is
+ *          destroyed, so a Mailbox pointer stays valid for the server's
+ *          lifetime and lookups need no lock. Any thread that writes to a
+ *          client finds the client's outbound queue here by fd.
+ */
+typedef struct {
+    Mailbox* pages[MAILBOX_MAX_PAGES]; ///< Mailbox pages (atomic pointers)
+    pthread_mutex_t grow_mutex;        ///< Serializes page allocation
+} MailboxTable;
+
+/**
+ * @brief Initializes an empty mailbox table
+ * @param table Pointer to the table to be initialized
+ */
+void mailbox_table_init(MailboxTable* table);
+
+/**
+ * @brief Frees every mailbox page
+ * @param table Pointer to the mailbox table
+ * @details Commands still queued are dropped; their buffers are released
+ *          with the buffer slab.
+ */
+void mailbox_table_destroy(MailboxTable* table);
+
+/**
+ * @brief Returns the mailbox of a connection, allocating its page if needed
+ * @param table Pointer to the mailbox table
+ * @param fd Client socket
+ * @return The mailbox, or NULL if fd is out of range or memory allocation fails
+ */
+Mailbox* mailbox_get(MailboxTable* table, int fd);
+
+/**
+ * @brief Prepares a mailbox for a newly accepted connection (reactor side)
+ * @param box Pointer to the mailbox
+ * @param fd Socket of the connection
+ * @param flush_list Flush list of the accepting reactor (io_uring backend), or NULL
+ * @details Clears the closed and disconnect flags left by a previous
+ *          connection that had the same fd and opens its outbound queue.
+ */
+void mailbox_open(Mailbox* box, int fd, OutFlushList* flush_list);
+
+/**
+ * @brief Queues a command (reactor side)
+ * @param box Pointer to the mailbox
+ * @param task Command to queue (the mailbox takes over its buffer)
+ * @param use_reserve Whether the last slot, kept for the disconnect, may be used
+ * @return 1 if queued, 0 if the mailbox is full
+ */
+int mailbox_push(Mailbox* box, const Task* task, int use_reserve);
+
+/**
+ * @brief Claims the right to submit the mailbox's token
+ * @param box Pointer to the mailbox
+ * @return 1 if the caller must submit a token, 0 if one is already queued or held
+ */
+int mailbox_schedule(Mailbox* box);
+
+/**
+ * @brief Takes the oldest queued command (token holder)
+ * @param box Pointer to the mailbox
+ * @param task Receives the command
+ * @return 1 if a command was taken, 0 if the mailbox is empty
+ */
+int mailbox_pop(Mailbox* box, Task* task);
+
+/**
+ * @brief Gives the token back (token holder)
+ * @param box Pointer to the mailbox
+ * @return 1 if commands are still queued and the caller must submit the token again
+ */
+int mailbox_release(Mailbox* box);
+
+/**
+ * @brief Marks the connection as ended (token holder)
+ * @param box Pointer to the mailbox
+ * @details Commands queued or pushed afterwards are dropped by
+ *          mailbox_is_closed() checks until mailbox_open().
+ */
+void mailbox_close(Mailbox* box);
+
+/**
+ * @brief Tells whether the connection of the mailbox has ended
+ * @param box Pointer to the mailbox
+ * @return Non-zero if closed
+ */
+int mailbox_is_closed(const Mailbox* box);
+
+#endif // MAILBOX_H
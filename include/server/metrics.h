@@ -0,0 +1,119 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <pthread.h>
+#include <stddef.h>
+
+#define METRICS_LINE_SIZE 256       ///< Buffer size that always fits metrics_format()
+
+/**
+ * @brief One sample of the worker pool's state
+ */
+typedef struct {
+    int workers;                    ///< Running worker threads
+    int target_workers;             ///< Workers the pool is scaling to
+    int busy_workers;               ///< Workers that were running a task when sampled
+    int queue_depth;                ///< Tasks waiting in every inbox and deque
+    unsigned long long wait_avg_us; ///< Moving average of the queue wait (microseconds)
+    unsigned long long wait_max_us; ///< Longest queue wait during the last interval (microseconds)
+    unsigned long long local_pops;  ///< Tasks workers took from their own queues (total)
+    unsigned long long steals;      ///< Tasks workers stole from each other (total)
+} PoolMetrics;
+
+/**
+ * @brief One sample of the clients' outbound queues
+ */
+typedef struct {
+    int clients;                    ///< Connected clients
+    int backlogged;                 ///< Clients with unsent bytes queued
+    unsigned long long queued_bytes; ///< Unsent bytes over every client
+    unsigned long long max_bytes;   ///< Unsent bytes of the most backlogged client
+    int max_fd;                     ///< Most backlogged client (-1 if no client is backlogged)
+    unsigned long long dropped;     ///< Stale ball states dropped (total)
+    unsigned long long disconnects; ///< Clients disconnected for exceeding the cap (total)
+} OutboundMetrics;
+
+/**
+ * @brief Latest metrics published by the worker manager
+ * @details Written once per sampling interval and read by the 'm' command,
+ *          so a plain mutex is enough. The two totals are counted as the
+ *          events happen, with atomic increments.
+ */
+typedef struct {
+    pthread_mutex_t mutex;          ///< Protects pool and outbound
+    PoolMetrics pool;               ///< Last worker pool sample
+    OutboundMetrics outbound;       ///< Last outbound queue sample
+    unsigned long long states_dropped;   ///< Stale ball states dropped so far (atomic)
+    unsigned long long slow_disconnects; ///< Slow consumers disconnected so far (atomic)
+} ServerMetrics;
+
+/**
+ * @brief Reads the monotonic clock
+ * @return CLOCK_MONOTONIC time in nanoseconds
+ * @details Used to time how long a mailbox token waits in the worker pool.
+ */
+unsigned long long metrics_now_ns(void);
+
+/**
+ * @brief Initializes the metrics store with an all-zero sample
+ * @param metrics Pointer to the metrics store
+ */
+void metrics_init(ServerMetrics* metrics);
+
+/**
+ * @brief Frees the resources of the metrics store
+ * @param metrics Pointer to the metrics store
+ */
+void metrics_destroy(ServerMetrics* metrics);
+
+/**
+ * @brief Replaces the published worker pool sample
+ * @param metrics Pointer to the metrics store
+ * @param sample New sample
+ */
+void metrics_publish_pool(ServerMetrics* metrics, const PoolMetrics* sample);
+
+/**
+ * @brief Copies the published worker pool sample
+ * @param metrics Pointer to the metrics store
+ * @param out Receives the sample
+ */
+void metrics_read_pool(ServerMetrics* metrics, PoolMetrics* out);
+
+/**
+ * @brief Replaces the published outbound queue sample
+ * @param metrics Pointer to the metrics store
+ * @param sample New sample
+ */
+void metrics_publish_outbound(ServerMetrics* metrics, const OutboundMetrics* sample);
+
+/**
+ * @brief Copies the published outbound queue sample
+ * @param metrics Pointer to the metrics store
+ * @param out Receives the sample
+ */
+void metrics_read_outbound(ServerMetrics* metrics, OutboundMetrics* out);
+
+/**
+ * @brief Formats a worker pool sample as one "key=value" line
+ * @param sample Sample to format
+ * @param buf Destination buffer (METRICS_LINE_SIZE bytes always suffice)
+ * @param size Size of buf
+ * @return Length of the line, as snprintf()
+ * @details Example: "METRICS workers=4 target=4 busy=1 depth=0 wait_avg_us=35
+ *          wait_max_us=120 local=1200 steals=87\n"
+ */
+int metrics_format(const PoolMetrics* sample, char* buf, size_t size);
+
+/**
+ * @brief Formats an outbound queue sample as one "key=value" line
+ * @param sample Sample to format
+ * @param buf Destination buffer (METRICS_LINE_SIZE bytes always suffice)
+ * @param size Size of buf
+ * @return Length of the line, as snprintf()
+ * @details Example: "OUTBOUND clients=3 backlogged=1 queued=65536 max=65536
+ *          max_fd=7 dropped=12 disconnected=0\n"
+ */
+int metrics_format_outbound(const OutboundMetrics* sample, char* buf, size_t size);
+
+#endif // METRICS_H
@@ -0,0 +1,252 @@
+#ifndef OUT_QUEUE_H
+#define OUT_QUEUE_H
+
+#include <pthread.h>
+#include <stddef.h>
+#include <sys/uio.h>
+
+#define OUT_QUEUE_DEFAULT_LIMIT (4 * 1024 * 1024) ///< Default cap on unsent bytes per client (--outbound-limit)
+#define OUT_QUEUE_MIN_LIMIT 4096    ///< Smallest accepted --outbound-limit
+#define OUT_QUEUE_OVERFLOW (-1)     ///< out_queue_send(): the cap was exceeded and the client was disconnected
+#define OUT_QUEUE_IOV_MAX 64        ///< Queued frames written by one writev() call
+
+#define OUT_FRAME_REPLY 0           ///< Command reply: always delivered in order
+#define OUT_FRAME_STATE 1           ///< Ball state: superseded by the next one, may be dropped
+
+/**
+ * @brief What to do with a client that reads slower than the server writes
+ */
+typedef enum {
+    SLOW_CONSUMER_LATEST,           ///< Drop queued ball states that were not started; keep only the newest
+    SLOW_CONSUMER_DISCONNECT        ///< Disconnect the client as soon as its queue exceeds the cap
+} SlowConsumerPolicy;
+
+/**
+ * @brief Reference-counted frame shared by every client it is sent to
+ * @details The fan-out thread encodes each tick's world state once into a
+ *          SharedFrame and hands the same bytes to every client. A client
+ *          whose socket cannot take the whole frame keeps a reference in its
+ *          queue instead of a copy; the frame is freed when the last
+ *          reference is released, i.e. after the slowest client has written
+ *          it (or dropped or closed it).
+ */
+typedef struct {
+    int refs;                       ///< References held (atomic)
+    size_t len;                     ///< Encoded bytes in data
+    size_t capacity;                ///< Size of data
+    char data[];                    ///< Frame bytes
+} SharedFrame;
+
+/**
+ * @brief Bytes waiting to be written to a client
+ * @details Either a reference to a SharedFrame or a private copy (replies).
+ */
+typedef struct OutFrame {
+    struct OutFrame* next;          ///< Next frame in the queue
+    SharedFrame* shared;            ///< Referenced frame, or NULL when the bytes follow in copy
+    const char* data;               ///< First unqueued byte (inside shared->data or copy)
+    size_t len;                     ///< Bytes queued from data
+    size_t sent;                    ///< Bytes of data already written to the socket
+    int kind;                       ///< OUT_FRAME_REPLY or OUT_FRAME_STATE
+    char copy[];                    ///< Private bytes when shared is NULL
+} OutFrame;
+
+/**
+ * @brief Outbound queue of one connection
+ * @details Every thread that writes to a client (reactor, workers, the
+ *          simulation and fan-out threads) goes through the client's queue,
+ *          so a frame is never interleaved with another one even when the
+ *          non-blocking socket only takes part of it. While the queue is
+ *          empty a frame is sent straight away; whatever the socket does not
+ *          take is queued (by reference for a SharedFrame, copied otherwise)
+ *          and written by the owning reactor with writev() when epoll reports
+ *          the socket writable again (EPOLLOUT), or with the io_uring backend
+ *          by the reactor's batched sends (see OutFlushList). The number of
+ *          unsent bytes is capped; what happens at the cap is decided by the
+ *          SlowConsumerPolicy.
+ */
+typedef struct OutQueue {
+    pthread_mutex_t mutex;          ///< Protects every other field and serializes writes to the socket
+    OutFrame* head;                 ///< Oldest frame (possibly partly sent)
+    OutFrame* tail;                 ///< Newest frame
+    size_t bytes;                   ///< Unsent bytes, including an in-flight batch (read without the mutex for metrics)
+    int frames;                     ///< Frames queued or in flight
+    int closed;                     ///< Set when the connection ends; later frames are discarded
+    unsigned long long dropped;     ///< Ball states dropped since the connection was opened
+    int fd;                         ///< Socket of the current connection
+    unsigned generation;            ///< Incremented by every out_queue_open(); tells stale completions apart
+    struct OutFlushList* flush_list; ///< Reactor that sends deferred frames (NULL: direct sends and EPOLLOUT)
+    struct OutQueue* flush_next;    ///< Next queue in flush_list
+    int flush_queued;               ///< Whether the queue is in flush_list
+    int inflight;                   ///< Whether a batch has been handed to the kernel and not completed
+} OutQueue;
+
+/**
+ * @brief Outbound queues waiting for one reactor to send them (io_uring backend)
+ * @details Senders do not write ball states to the socket themselves: they
+ *          queue the frame and push the queue here (once, until the reactor
+ *          takes it). Pushing onto an empty list signals wake_fd, so a
+ *          tick's fan-out wakes each reactor about once, and the reactor
+ *          submits one send per queue in a single io_uring_enter() call.
+ */
+typedef struct OutFlushList {
+    struct OutQueue* head;          ///< Queues to send (lock-free stack, atomic)
+    int wake_fd;                    ///< eventfd signalled when the list becomes non-empty
+} OutFlushList;
+
+/**
+ * @brief Frames of one queue handed to the kernel in one vectored send
+ * @details The frames are detached from the queue while the send is in
+ *          flight, so closing or reopening the connection cannot free bytes
+ *          the kernel is still reading; out_queue_complete() gives back what
+ *          was not written.
+ */
+typedef struct {
+    OutQueue* queue;                ///< Queue the frames came from
+    unsigned generation;            ///< Connection the frames belong to
+    int fd;                         ///< Socket to send to
+    int count;                      ///< Frames (and iovecs) in the batch
+    OutFrame* frames;               ///< Detached frames, oldest first
+    struct iovec iov[OUT_QUEUE_IOV_MAX]; ///< Unsent bytes of each frame
+} OutBatch;
+
+/**
+ * @brief Allocates a shared frame holding one reference
+ * @param capacity Bytes the frame can hold
+ * @return The frame (len 0), or NULL if memory allocation fails
+ */
+SharedFrame* shared_frame_alloc(size_t capacity);
+
+/**
+ * @brief Drops a reference and frees the frame with the last one
+ * @param frame Frame to release (NULL is ignored)
+ */
+void shared_frame_release(SharedFrame* frame);
+
+/**
+ * @brief Initializes an empty, closed outbound queue
+ * @param q Pointer to the queue
+ */
+void out_queue_init(OutQueue* q);
+
+/**
+ * @brief Frees the queued frames and the mutex of an outbound queue
+ * @param q Pointer to the queue
+ */
+void out_queue_destroy(OutQueue* q);
+
+/**
+ * @brief Opens the queue for a new connection on its fd
+ * @param q Pointer to the queue
+ * @param fd Socket of the connection
+ * @param flush_list Reactor list that sends deferred frames, or NULL to send
+ *                   directly and flush on EPOLLOUT (epoll backend)
+ */
+void out_queue_open(OutQueue* q, int fd, OutFlushList* flush_list);
+
+/**
+ * @brief Discards the queued frames and rejects later ones
+ * @param q Pointer to the queue
+ * @details Must be called before the socket is closed, so no thread writes
+ *          to an fd that has been handed to a new connection.
+ */
+void out_queue_close(OutQueue* q);
+
+/**
+ * @brief Sends a frame to a client, queueing what the socket does not take
+ * @param q Outbound queue of the client
+ * @param fd Client socket (non-blocking)
+ * @param data Frame bytes
+ * @param len Number of bytes
+ * @param kind OUT_FRAME_REPLY or OUT_FRAME_STATE
+ * @param limit Cap on unsent bytes
+ * @param policy What to do when the client falls behind
+ * @return Number of queued ball states dropped to make room (0 or more), or
+ *         OUT_QUEUE_OVERFLOW if the cap was exceeded: the queue was closed and
+ *         the socket shut down, so the reactor sees the disconnect
+ * @details With SLOW_CONSUMER_LATEST a new ball state replaces every queued
+ *          state that has not started to be written, and the cap only
+ *          applies to the remaining bytes (replies and a partly written
+ *          frame). With SLOW_CONSUMER_DISCONNECT nothing is dropped and the
+ *          cap applies to everything. When the queue has a flush list, ball
+ *          states are never sent directly: they wait for the reactor's
+ *          batched send (replies still go out at once when nothing is queued),
+ *          and since the socket has not been offered the new state yet, only
+ *          the bytes already queued count against the cap.
+ */
+int out_queue_send(OutQueue* q, int fd, const char* data, size_t len, int kind,
+                   size_t limit, SlowConsumerPolicy policy);
+
+/**
+ * @brief Sends a shared frame to a client without copying it
+ * @param q Outbound queue of the client
+ * @param fd Client socket (non-blocking)
+ * @param frame Frame to send; the caller keeps its own reference
+ * @param kind OUT_FRAME_REPLY or OUT_FRAME_STATE
+ * @param limit Cap on unsent bytes
+ * @param policy What to do when the client falls behind
+ * @return Same as out_queue_send()
+ * @details Like out_queue_send(), but an unsent remainder is queued as a
+ *          new reference to frame.
+ */
+int out_queue_send_shared(OutQueue* q, int fd, SharedFrame* frame, int kind,
+                          size_t limit, SlowConsumerPolicy policy);
+
+/**
+ * @brief Writes queued frames until the queue is empty or the socket is full
+ * @param q Outbound queue of the client
+ * @param fd Client socket (non-blocking)
+ * @details Called by the reactor on EPOLLOUT. Gathers up to
+ *          OUT_QUEUE_IOV_MAX frames per writev() call. A write error leaves
+ *          the frames queued; the reactor then sees the error on the read side.
+ */
+void out_queue_flush(OutQueue* q, int fd);
+
+/**
+ * @brief Initializes an empty flush list
+ * @param list Pointer to the list
+ * @param wake_fd eventfd of the reactor that drains the list
+ */
+void out_flush_list_init(OutFlushList* list, int wake_fd);
+
+/**
+ * @brief Takes every queue pushed to the list so far
+ * @param list Pointer to the list
+ * @return First queue (chained through flush_next, newest first), or NULL
+ * @details Read a queue's flush_next before passing it to out_queue_take():
+ *          after that the queue may be pushed again.
+ */
+OutQueue* out_flush_list_take(OutFlushList* list);
+
+/**
+ * @brief Detaches the oldest queued frames into a send batch
+ * @param q Queue taken from a flush list
+ * @param batch Receives up to OUT_QUEUE_IOV_MAX frames
+ * @return Frames in the batch; 0 if the queue is closed, empty or already
+ *         has a batch in flight
+ */
+int out_queue_take(OutQueue* q, OutBatch* batch);
+
+/**
+ * @brief Finishes a send batch and prepares the next one
+ * @param batch Batch filled by out_queue_take() or a previous call
+ * @param result Bytes written, or a negative errno
+ * @return Frames in the refilled batch when more frames are queued (submit
+ *         it again), 0 when the queue is done for now
+ * @details Written frames are freed (releasing their shared frames), the
+ *          rest go back to the head of the queue. A batch whose connection
+ *          was closed or replaced is simply freed. On an error the batch is
+ *          dropped; the reactor sees the broken connection on the read side.
+ */
+int out_queue_complete(OutBatch* batch, long result);
+
+/**
+ * @brief Reads the queue depth of a client
+ * @param q Outbound queue of the client
+ * @param bytes Receives the unsent bytes
+ * @param frames Receives the queued frames
+ * @param dropped Receives the ball states dropped since the connection opened
+ */
+void out_queue_stats(OutQueue* q, size_t* bytes, int* frames, unsigned long long* dropped);
+
+#endif // OUT_QUEUE_H
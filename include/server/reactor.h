@@ -0,0 +1,108 @@
+#ifndef REACTOR_H
+#define REACTOR_H
+
+#include <pthread.h>
+#include <sys/socket.h>
+#include "server.h"
+#include "uring.h"
+
+#define REACTOR_MAX_EVENTS 64       ///< Events handled per epoll_wait() call
+#define REACTOR_WAIT_TIMEOUT_MS 1000 ///< epoll_wait() timeout, bounds the shutdown latency
+
+/**
+ * @brief One vectored send submitted to io_uring
+ * @details Owned by the reactor from submission to completion (the kernel
+ *          reads msg and the batch's iovecs in between) and recycled after.
+ */
+typedef struct ReactorSend {
+    OutBatch batch;                 ///< Frames being sent
+    struct msghdr msg;              ///< Message header pointing at batch.iov
+    int active;                     ///< Whether the send is in flight
+    struct ReactorSend* next_free;  ///< Next recycled send
+    struct ReactorSend* next_all;   ///< Next allocated send (freed by reactor_destroy())
+} ReactorSend;
+
+/**
+ * @brief One network event loop
+ * @details Each reactor owns a listening socket, an epoll instance and the
+ *          connections it accepted: it reads their commands into the
+ *          connections' mailboxes and queues their disconnects. With several
+ *          reactors every listening socket is bound to the same port with
+ *          SO_REUSEPORT, so the kernel spreads incoming connections across
+ *          them. Reactors reach shared state through queues: commands and
+ *          the initial ball spawn of a new connection go to the connection
+ *          mailboxes (the spawn goes to the reactor command ring with
+ *          --apply-at-tick), so a reactor never takes mutex_ball. Only the
+ *          client table is updated directly, under mutex_client.
+ *
+ *          With --io-backend io_uring the loop runs on an io_uring instance
+ *          instead: a multishot accept on the listening socket, a multishot
+ *          recv per connection reading into provided buffers, and ball
+ *          states sent as one vectored send per client, all submitted with
+ *          a single io_uring_enter() per round. The reactor falls back to
+ *          epoll when io_uring cannot be set up.
+ */
+typedef struct {
+    int id;                 ///< Reactor index (0 runs on the main thread)
+    int listen_fd;          ///< Listening socket of this reactor
+    IoBackend backend;      ///< Backend in use (after a possible fallback)
+    int epoll_fd;           ///< Epoll instance of this reactor (-1 with io_uring)
+    Uring ring;             ///< io_uring instance (io_uring backend)
+    int wake_fd;            ///< eventfd signalled when flush becomes non-empty (-1 with epoll)
+    unsigned long long wake_value; ///< Buffer of the pending eventfd read
+    OutFlushList flush;     ///< Outbound queues waiting for a batched send
+    ReactorSend* free_sends; ///< Recycled send requests
+    ReactorSend* all_sends; ///< Every allocated send request
+    unsigned long long sends; ///< Vectored sends submitted (statistics)
+    pthread_t thread;       ///< Thread running the loop (unused for reactor 0)
+    SharedContext* ctx;     ///< Shared server state
+    Task pending[TASK_QUEUE_BATCH]; ///< Connection tokens collected in the current epoll round
+    int pending_count;      ///< Number of tokens in pending
+} Reactor;
+
+/**
+ * @brief Sets a file descriptor to non-blocking mode
+ * @param fd File descriptor
+ */
+void set_nonblocking(int fd);
+
+/**
+ * @brief Creates the listening socket and the epoll or io_uring instance of a reactor
+ * @param reactor Pointer to the reactor to be initialized
+ * @param id Reactor index
+ * @param ctx Shared server state
+ * @param port TCP port to listen on
+ * @param reuse_port Whether to set SO_REUSEPORT (required when several reactors share the port)
+ * @return 0 on success, -1 on failure (nothing is left open)
+ * @details Uses ctx->config.io_backend; if io_uring was requested but cannot
+ *          be set up (old kernel, seccomp, missing feature) a warning is
+ *          printed and the reactor uses epoll.
+ */
+int reactor_init(Reactor* reactor, int id, SharedContext* ctx, int port, int reuse_port);
+
+/**
+ * @brief Runs the event loop of a reactor until keep_running is cleared
+ * @param arg Pointer to the Reactor
+ * @return NULL
+ * @details Accepts connections, registers them in the client table and
+ *          creates their initial balls, reads each ready connection until
+ *          EAGAIN (the sockets are edge-triggered), splits the received
+ *          bytes into newline-terminated commands with the connection's
+ *          input buffer, appends the commands to the connection's mailbox
+ *          and submits one token per newly scheduled mailbox to the worker
+ *          pool. A disconnect is queued behind the
+ *          connection's commands and cleaned up by the worker. With the
+ *          io_uring backend the same steps run on completions, and the
+ *          queues on the reactor's flush list are sent in one batch.
+ */
+void* reactor_thread(void* arg);
+
+/**
+ * @brief Closes the listening socket and epoll or io_uring instance of a reactor
+ * @param reactor Pointer to the reactor
+ * @details Must be called after every thread that sends to clients has
+ *          stopped, since their queues may still wake the reactor.
+ */
+void reactor_destroy(Reactor* reactor);
+
+#endif // REACTOR_H
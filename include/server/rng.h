@@ -0,0 +1,50 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+
+#define RNG_LANES 8     ///< Independent xoshiro128** streams interleaved by rng_fill()
+
+/**
+ * @brief Per-thread random number generator state
+ * @details Holds RNG_LANES independent xoshiro128** states stored lane-major,
+ *          so that rng_fill() advances every lane with the same instruction
+ *          sequence and the compiler can keep the lanes in SIMD registers.
+ *          Each thread owns one state (thread-local storage), seeded lazily
+ *          on first use, so no lock or shared cache line is touched when
+ *          generating numbers.
+ */
+typedef struct {
+    uint32_t s[4][RNG_LANES];   ///< xoshiro128** state words of each lane
+    int next_lane;              ///< Lane used by the next rng_next() call
+    int seeded;                 ///< Non-zero once the state has been seeded
+} RngState;
+
+/**
+ * @brief Seeds the calling thread's generator
+ * @param seed Seed value (every lane is derived from it with splitmix64)
+ * @details Optional: a thread that never calls this is seeded from the clock
+ *          and a global counter, so concurrent threads get different streams.
+ *          A fixed seed makes the sequence reproducible.
+ */
+void rng_seed(uint64_t seed);
+
+/**
+ * @brief Returns the next 32-bit random number of the calling thread
+ * @return Uniformly distributed 32-bit value
+ * @details Thread-safe without locking. Replaces rand(), which serializes on
+ *          a libc lock and is not safe to call from several threads.
+ */
+uint32_t rng_next(void);
+
+/**
+ * @brief Fills an array with 32-bit random numbers
+ * @param out Destination array
+ * @param n Number of values to generate
+ * @details Advances RNG_LANES lanes per iteration; the inner loop has no
+ *          dependency between lanes and is vectorized by the compiler.
+ *          Used by the bulk ball spawner.
+ */
+void rng_fill(uint32_t* out, int n);
+
+#endif // RNG_H
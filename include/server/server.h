@@ -11,14 +11,67 @@
 #include "localballmanager.h"
 #include "client_list_manager.h"
 #include "task.h"
+#include "worker_pool.h"
+#include "mailbox.h"
+#include "buffer_slab.h"
+#include "command_ring.h"
+#include "sim_pool.h"
+#include "tick_scheduler.h"
 #include "log.h"
+#include "affinity.h"
+#include "metrics.h"
+#include "udp_channel.h"
 
 #define SERVER_PORT 5100
-#define NUM_WORKERS 4
+#define DEFAULT_MIN_WORKERS 2   ///< Workers kept running when idle
+#define DEFAULT_MAX_WORKERS 8   ///< Workers the pool may grow to under load
+#define MAX_WORKERS 32          ///< Upper bound of --max-workers
+#define WORKER_SCALE_INTERVAL_MS 100 ///< Period at which the worker manager samples the pool
+#define WORKER_GROW_DEPTH 4     ///< Queued tokens at which the pool grows
+#define WORKER_GROW_WAIT_US 2000 ///< Longest queue wait of an interval at which the pool grows
+#define WORKER_SHRINK_IDLE_MS 5000 ///< Time a worker must have stayed spare before the pool shrinks
+#define METRICS_LOG_INTERVAL_MS 10000 ///< Pool metrics are logged every N ms
+#define CMD_METRICS 'm'         ///< Command replying with the current pool and outbound queue metrics
+#define METRICS_MAX_CLIENT_LINES 64 ///< Clients listed individually in the 'm' reply
+#define CMD_UDP 'u'             ///< Command registering the UDP port ball states are sent to ("u:<port>", "u:0" = back to TCP)
+#define REACTOR_COMMAND_RING -1  ///< Ring index passed by reactor threads (the shared reactor ring)
+#define DEFAULT_REACTORS 1      ///< Network threads (each with its own epoll loop)
+#define MAX_REACTORS 64         ///< Upper bound of --reactors
+#define DEFAULT_SIM_THREADS 1   ///< Single-threaded simulation step by default
+#define STATS_LOG_INTERVAL_TICKS 1000  ///< Simulation counters are logged every N ticks
 
 // sig_atomic_t guarantees atomic read/write operations
 extern volatile sig_atomic_t keep_running;
-extern TaskQueue* global_task_queue;
+extern WorkerPool* global_worker_pool;
+
+/**
+ * @brief Network I/O backend of the reactors
+ */
+typedef enum {
+    IO_BACKEND_EPOLL,   ///< epoll_wait() + accept()/recv(); queued bytes are flushed on EPOLLOUT
+    IO_BACKEND_URING    ///< io_uring: multishot accept and recv, ball states sent in one batch per tick
+} IoBackend;
+
+/**
+ * @brief Server runtime configuration
+ * @details Filled with defaults and then overridden by command line options
+ *          (see parse_server_config()).
+ */
+typedef struct {
+    int sim_threads;    ///< Number of threads moving balls each tick (1 = single-threaded)
+    int collisions;     ///< Whether the ball-ball collision stage runs each tick
+    int tick_hz;        ///< Simulation/broadcast rate in Hz
+    int max_catchup;    ///< Maximum simulation steps run after a late wakeup
+    int apply_at_tick;  ///< Whether commands are applied by the simulation thread at tick boundaries
+    int max_clients;    ///< Maximum number of connected clients
+    int reactors;       ///< Number of reactor (network) threads
+    int min_workers;    ///< Workers kept running when idle
+    int max_workers;    ///< Workers the pool may grow to
+    size_t outbound_limit;  ///< Cap on unsent bytes queued per client
+    SlowConsumerPolicy slow_consumer; ///< What happens to a client that reaches outbound_limit
+    IoBackend io_backend;   ///< Requested reactor backend (a reactor falls back to epoll if io_uring is unavailable)
+    ThreadLayout affinity; ///< CPU set of each thread role
+} ServerConfig;
 
 /**
  * @brief Global state context structure shared across the game
@@ -31,25 +84,66 @@ extern TaskQueue* global_task_queue;
 typedef struct {
     BallListManager* ball_list_manager;     ///< Ball list manager
     ClientListManager* client_list_manager; ///< Client list manager
-    TaskQueue *task_queue;                  ///< Task queue for processing commands
-    int epoll_fd;                          ///< Epoll file descriptor for event handling
+    WorkerPool* worker_pool;                ///< Per-worker deques of connection tokens (work stealing)
+    MailboxTable* mailboxes;                ///< Per-connection ordered command queues
+    BufferSlab* buffer_slab;                ///< Command buffers referenced by queued tasks
+    CommandRing* command_rings;             ///< One ring per worker, drained by the simulation thread (--apply-at-tick)
+    SharedCommandRing* reactor_commands;    ///< Ring shared by the reactor threads (--apply-at-tick)
+    ServerMetrics* metrics;                 ///< Latest samples published by the worker manager
+    UdpChannel* udp;                        ///< Snapshot datagram sender (used by the fan-out thread only)
+    ServerConfig config;                   ///< Runtime configuration
 } SharedContext;
 
+/**
+ * @brief Thread handle of one worker slot
+ * @details Owned by the worker manager thread; the worker only sets exited.
+ */
+typedef struct {
+    pthread_t tid;          ///< Thread ID
+    int slot;               ///< Worker pool slot (also the index of its command ring)
+    int running;            ///< Whether a thread has been started and not joined yet
+    int exited;             ///< Set by the worker when it leaves its loop (atomic)
+    SharedContext* ctx;     ///< Shared context
+} WorkerHandle;
+
+/**
+ * @brief Parses the server command line options
+ * @param argc Argument count
+ * @param argv Argument vector
+ * @param config Pointer to the configuration to fill
+ * @return 0 on success, -1 if an option is invalid (usage has been printed)
+ * @details Supported options (see also print_usage()):
+ *          --sim-threads N : number of simulation threads per tick (1 ~ SIM_POOL_MAX_THREADS)
+ *          --no-collisions : disable the ball-ball collision stage
+ *          --tick-hz N     : simulation/broadcast rate (1 ~ MAX_TICK_HZ)
+ *          --max-catchup N : maximum steps run after a late wakeup (at least 1)
+ *          --apply-at-tick : apply commands on the simulation thread at tick boundaries
+ *          --max-clients N : maximum number of connected clients (1 ~ CLIENT_TABLE_MAX_CLIENTS)
+ *          --reactors N    : number of reactor threads (1 ~ MAX_REACTORS)
+ *          --affinity ROLE=CPULIST : pin a thread role to CPUs (repeatable)
+ *          --min-workers N / --max-workers N : elastic worker pool bounds (1 ~ MAX_WORKERS)
+ *          --outbound-limit BYTES : unsent bytes queued per client (at least OUT_QUEUE_MIN_LIMIT)
+ *          --slow-consumer latest|disconnect : policy for clients that fall behind
+ *          --io-backend epoll|io_uring : reactor I/O backend
+ */
+int parse_server_config(int argc, char** argv, ServerConfig* config);
+
 /**
  * @brief Initializes the server manager
+ * @param config Parsed runtime configuration (copied into the context)
  * @return Pointer to the newly created SharedContext
  * @details Creates and initializes the shared context with ball list manager,
- *          client list manager, task queue, and epoll file descriptor.
+ *          client list manager, worker pool, buffer slab and command rings.
  * @date 2025-04-07
  * @author Kim Hyo Jin
  */
-SharedContext* manager_init();
+SharedContext* manager_init(const ServerConfig* config);
 
 /**
  * @brief Destroys the server manager
  * @param arg Pointer to the SharedContext to be destroyed
  * @details Frees all resources used by the shared context, including
- *          the ball list manager, client list manager, and task queue.
+ *          the ball list manager, client list manager, and worker pool.
  * @date 2025-04-07
  * @author Kim Hyo Jin
  */
@@ -68,24 +162,48 @@ void manager_destroy(SharedContext* arg);
 char parseCommand(const char* cmdStr, int* ball_count, int* radius);
 
 /**
- * @brief Broadcasts the ball state to all clients
- * @param client_mgr Pointer to the client list manager
- * @param ball_mgr Pointer to the ball list manager
- * @details Serializes the ball list into a string and sends it to all connected clients.
- * @date 2025-04-07
- * @author Kim Hyo Jin
+ * @brief Sends bytes to a client through its outbound queue
+ * @param ctx Pointer to the SharedContext
+ * @param fd Client socket
+ * @param data Bytes to send
+ * @param len Number of bytes
+ * @param kind OUT_FRAME_REPLY for command replies, OUT_FRAME_STATE for ball states
+ * @details Never blocks. Every write to a connected client goes through
+ *          here, so frames are never interleaved; the --outbound-limit cap
+ *          and the --slow-consumer policy are applied, and dropped states and
+ *          slow-consumer disconnects are counted in the metrics.
  */
-void broadcast_ball_state(ClientListManager* client_mgr, BallListManager* ball_mgr);
+void client_send(SharedContext* ctx, int fd, const char* data, size_t len, int kind);
+
+/**
+ * @brief Sends a shared frame to a client through its outbound queue
+ * @param ctx Pointer to the SharedContext
+ * @param fd Client socket
+ * @param frame Frame to send; the caller keeps its own reference
+ * @param kind OUT_FRAME_REPLY for command replies, OUT_FRAME_STATE for ball states
+ * @details Same as client_send(), but bytes the socket does not take are
+ *          queued as a reference to the frame instead of a copy.
+ */
+void client_send_frame(SharedContext* ctx, int fd, SharedFrame* frame, int kind);
 
 /**
  * @brief Broadcasts the ball state to all clients
- * @param client_mgr Pointer to the client list manager
- * @param ball_mgr Pointer to the ball list manager
- * @details Serializes the ball list into a string and sends it to all connected clients.
+ * @param ctx Pointer to the SharedContext
+ * @param snap World snapshot to send (NULL sends nothing)
+ * @details Encodes the snapshot once, without any lock, into a SharedFrame
+ *          and sends that frame to every connected client under
+ *          mutex_client. An empty world is sent as a single '|', so clients
+ *          clear the balls they still draw. A client that cannot keep up no longer delays the
+ *          others: what its socket does not take waits in its outbound queue
+ *          as a reference to the frame, which is freed once the last client
+ *          has written or dropped it. Clients that registered a UDP port
+ *          get the same frame as sequence-numbered datagrams instead (cut
+ *          into fragments once per tick, see UdpChannel).
  * @date 2025-04-07
  * @author Kim Hyo Jin
  */
-void broadcast_ball_state_all(ClientListManager* client_mgr, BallListManager* ball_mgr);    
+void broadcast_ball_state_all(SharedContext* ctx, const WorldSnapshot* snap);
+
 /**
  * @brief Logs a client connection event
  * @param fd Client file descriptor
@@ -107,25 +225,98 @@ void log_client_connect(int fd, struct sockaddr_in* cliaddr);
 void log_client_disconnect(int fd, const char* reason);
 
 
+/**
+ * @brief Queues a world command, waiting while the ring is full
+ * @param ctx Pointer to the SharedContext
+ * @param ring Command ring of the calling thread (worker index or REACTOR_COMMAND_RING)
+ * @param command Command to apply on the next tick
+ * @details Used with --apply-at-tick for commands that must not be dropped
+ *          (initial balls of a new client, deleting a leaving client's balls).
+ *          Yields until the simulation thread drains the ring; gives up only
+ *          when the server is shutting down.
+ */
+void submit_world_command_wait(SharedContext* ctx, int ring, const WorldCommand* command);
+
+/**
+ * @brief Waits until this connection's previous world command has been consumed
+ * @param ctx Shared context
+ * @param box Mailbox of the connection (held by the caller)
+ * @param ring Command ring the caller is about to push into
+ * @details --apply-at-tick only. When a connection's mailbox moves to another
+ *          worker, its previous command may still sit in the former worker's
+ *          ring (or in the reactor ring). Waiting until the simulation thread
+ *          has taken it keeps the connection's commands in order, because a
+ *          command pushed afterwards is applied in a later drain.
+ */
+void wait_world_command_fence(SharedContext* ctx, Mailbox* box, int ring);
+
+/**
+ * @brief Records the position of the world command just pushed for a connection
+ * @param ctx Shared context
+ * @param box Mailbox of the connection
+ * @param ring Command ring the command was pushed into (worker index or REACTOR_COMMAND_RING)
+ */
+void mark_world_command_fence(SharedContext* ctx, Mailbox* box, int ring);
+
 /**
  * @brief Worker thread function
- * @param arg Pointer to the SharedContext
+ * @param arg Pointer to the WorkerHandle of the worker's slot
  * @return NULL
- * @details Processes tasks from the task queue, handling commands and
- *          updating ball states.
+ * @details Takes connection tokens from the worker pool (its own deque, its
+ *          inbox or stolen from another worker) and runs up to
+ *          MAILBOX_DRAIN_BUDGET commands of that connection in order,
+ *          handling commands and updating ball states. With --apply-at-tick the worker only parses
+ *          and validates commands and pushes them into its own command ring
+ *          (replying "Server busy" when the ring is full) instead of locking
+ *          mutex_ball. The thread exits when the pool is stopped or its slot
+ *          is retired.
  * @date 2025-04-07
  * @author Kim Hyo Jin
  */
 void* worker_thread(void* arg);
 
+/**
+ * @brief Worker manager thread function (elastic worker pool)
+ * @param arg Pointer to the SharedContext
+ * @return NULL
+ * @details Starts min_workers workers, then samples the pool every
+ *          WORKER_SCALE_INTERVAL_MS. It starts one more worker (up to
+ *          max_workers) when WORKER_GROW_DEPTH tokens are queued or a token
+ *          waited WORKER_GROW_WAIT_US during the interval, and retires the
+ *          highest worker (down to min_workers) once at least one worker has
+ *          been spare for WORKER_SHRINK_IDLE_MS. It also samples the
+ *          clients' outbound queues. Every sample is
+ *          published to the metrics store (the 'm' command) and logged every
+ *          METRICS_LOG_INTERVAL_MS. On shutdown it joins every worker.
+ */
+void* worker_manager_thread(void* arg);
+
 /**
  * @brief Ball state broadcast thread function
  * @param arg Pointer to the SharedContext
  * @return NULL
- * @details Periodically broadcasts the current ball state to all clients.
+ * @details Runs the fixed-timestep simulation loop driven by a TickScheduler:
+ *          moves the balls (catching up on missed ticks), resolves
+ *          collisions, and publishes a world snapshot once per wakeup.
+ *          With --apply-at-tick it first drains every command ring and applies
+ *          the commands in ring order, and is then the only thread that
+ *          modifies the ball list, so mutex_ball is not taken.
+ *          This is the only thread that publishes snapshots.
  * @date 2025-04-07
  * @author Kim Hyo Jin
  */
 void* cycle_broadcast_ball_state(void* arg);
 
+/**
+ * @brief Snapshot fan-out thread function
+ * @param arg Pointer to the SharedContext
+ * @return NULL
+ * @details Waits for each published snapshot, encodes it once without
+ *          holding mutex_ball and sends the shared frame to every client, so
+ *          slow sends no longer stall the simulation or the command workers.
+ *          This is the only path that sends ball states; a command's effect
+ *          reaches the clients with the next tick.
+ */
+void* snapshot_fanout_thread(void* arg);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,68 @@
+#ifndef SIM_POOL_H
+#define SIM_POOL_H
+
+#include <pthread.h>
+#include "localball_list.h"
+
+#define SIM_POOL_MAX_THREADS 64       ///< Upper bound for the simulation thread count
+#define SIM_POOL_MIN_BALLS_PER_THREAD 4096 ///< Below this many balls per thread the step runs single-threaded
+#define SIM_POOL_CHUNK_ALIGN 8        ///< Partition boundaries are aligned to the widest SIMD kernel
+
+struct SimPool;
+
+/**
+ * @brief Structure representing one helper thread of a simulation pool
+ */
+typedef struct {
+    pthread_t tid;          ///< Thread ID
+    int index;              ///< Chunk index moved by this thread (0 is the calling thread)
+    struct SimPool* pool;   ///< Pool the thread belongs to
+} SimHelper;
+
+/**
+ * @brief Structure representing a pool of simulation threads
+ * @details The ball range is partitioned into one contiguous chunk per thread.
+ *          The calling thread (the tick thread) moves the first chunk itself
+ *          and the helper threads move the others. Two barriers per tick mark
+ *          the start and the end of the step, so the list is never touched by
+ *          a helper outside sim_pool_step().
+ */
+typedef struct SimPool {
+    SimHelper* helpers;               ///< Helper threads (num_threads - 1)
+    int num_threads;                  ///< Total number of threads taking part in a step
+    pthread_barrier_t start_barrier;  ///< Released when a step starts (or on shutdown)
+    pthread_barrier_t done_barrier;   ///< Released when every chunk has been moved
+    BallList* list;                   ///< Ball list of the current step
+    int active_threads;               ///< Number of threads that get a chunk in the current step
+    int stop;                         ///< Set by sim_pool_destroy() to end the helpers
+} SimPool;
+
+/**
+ * @brief Initializes a simulation pool
+ * @param pool Pointer to the pool to be initialized
+ * @param num_threads Total number of simulation threads, including the caller
+ * @return 0 on success, -1 on failure
+ * @details Starts num_threads - 1 helper threads. A pool with one thread
+ *          starts no helpers and moves every ball on the calling thread.
+ *          If a helper cannot be started the pool is unusable and must not
+ *          be stepped or destroyed; the server treats this as fatal.
+ */
+int sim_pool_init(SimPool* pool, int num_threads);
+
+/**
+ * @brief Moves every ball in the list one step using the whole pool
+ * @param pool Pointer to the simulation pool
+ * @param list Pointer to the ball list to be moved
+ * @details Blocks until every chunk has been moved. Each ball is updated
+ *          independently, so the result is identical to move_balls(list, 0, count).
+ *          Small lists are moved on the calling thread only.
+ */
+void sim_pool_step(SimPool* pool, BallList* list);
+
+/**
+ * @brief Stops the helper threads and frees the pool's resources
+ * @param pool Pointer to the simulation pool
+ */
+void sim_pool_destroy(SimPool* pool);
+
+#endif // SIM_POOL_H
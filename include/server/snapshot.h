@@ -0,0 +1,143 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <pthread.h>
+#include "localball_list.h"
+
+#define SNAPSHOT_MAX_READERS 64     ///< Maximum number of threads registered as snapshot readers
+#define SNAPSHOT_SPARE_POOL 2       ///< Reclaimed snapshots kept for reuse (double buffering)
+#define SNAPSHOT_CACHE_LINE 64      ///< Reader slots are padded to a cache line
+
+/**
+ * @brief Immutable copy of the world published once per tick
+ * @details Holds the compact ball properties with the balls grouped by
+ *          owner: the balls of owner o are [owner_start[o], owner_start[o + 1]).
+ *          Velocities already include the owner's speed level. A snapshot is
+ *          never modified after it has been published; it is reclaimed once
+ *          no reader holds a reference and no reader can still be loading it.
+ */
+typedef struct WorldSnapshot {
+    unsigned long long tick;    ///< Simulation step the snapshot was taken after
+    int count;                  ///< Number of balls
+    int capacity;               ///< Capacity of the per-ball arrays
+    uint16_t* x;                ///< Q10.6 x positions
+    uint16_t* y;                ///< Q10.6 y positions
+    int16_t* dx;                ///< Effective velocity x components
+    int16_t* dy;                ///< Effective velocity y components
+    uint8_t* radius;            ///< Radii
+    uint8_t* palette;           ///< Palette indices
+    uint16_t* owner_id;         ///< Owner IDs
+    int* id;                    ///< Ball IDs
+    int* owner_start;           ///< Start of each owner's range (owner_count + 1 entries)
+    int owner_count;            ///< Number of owner IDs covered by owner_start
+    int owner_capacity;         ///< Capacity of owner_start
+    int refs;                   ///< Reference count (the store holds one while current)
+    unsigned long long retire_epoch; ///< Global epoch at which the snapshot was replaced
+    struct WorldSnapshot* next; ///< Link in the retired or spare list
+} WorldSnapshot;
+
+/**
+ * @brief Epoch slot of one reader thread
+ */
+typedef struct {
+    unsigned long long epoch;   ///< Epoch observed on entry, 0 when not reading
+    int in_use;                 ///< Whether a thread owns the slot
+    char pad[SNAPSHOT_CACHE_LINE - sizeof(unsigned long long) - sizeof(int)];
+} SnapshotReader;
+
+/**
+ * @brief Single-writer store of world snapshots
+ * @details The simulation thread is the only writer: it builds a snapshot
+ *          from the live list and swaps it in with an atomic exchange.
+ *          Readers pin the current snapshot with snapshot_acquire(), which
+ *          enters an epoch only for the few instructions between loading the
+ *          pointer and taking a reference. The writer frees (or keeps for
+ *          reuse) a replaced snapshot once its reference count is zero and
+ *          every reader has left the epoch in which it was replaced.
+ */
+typedef struct {
+    WorldSnapshot* current;             ///< Latest snapshot (atomic)
+    unsigned long long global_epoch;    ///< Incremented on every publication (atomic)
+    SnapshotReader readers[SNAPSHOT_MAX_READERS]; ///< Reader epoch slots
+    WorldSnapshot* retired;             ///< Replaced snapshots awaiting reclamation (writer only)
+    WorldSnapshot* spare;               ///< Reclaimed snapshots ready for reuse (writer only)
+    int spare_count;                    ///< Number of snapshots in spare
+    pthread_mutex_t wait_mutex;         ///< Protects published_seq for waiting readers
+    pthread_cond_t published;           ///< Signaled after every publication
+    unsigned long long published_seq;   ///< Number of snapshots published
+    int stopping;                       ///< Set by snapshot_wake_all() to end every wait
+} SnapshotStore;
+
+/**
+ * @brief Initializes an empty snapshot store
+ * @param store Pointer to the store to be initialized
+ */
+void snapshot_store_init(SnapshotStore* store);
+
+/**
+ * @brief Frees every snapshot of the store
+ * @param store Pointer to the snapshot store
+ * @details Must only be called after every reader has released its snapshots.
+ */
+void snapshot_store_destroy(SnapshotStore* store);
+
+/**
+ * @brief Registers the calling thread as a reader
+ * @param store Pointer to the snapshot store
+ * @return Reader slot to pass to snapshot_acquire(), or -1 if every slot is taken
+ */
+int snapshot_reader_register(SnapshotStore* store);
+
+/**
+ * @brief Releases a reader slot
+ * @param store Pointer to the snapshot store
+ * @param reader Reader slot returned by snapshot_reader_register()
+ */
+void snapshot_reader_unregister(SnapshotStore* store, int reader);
+
+/**
+ * @brief Takes a reference to the current snapshot
+ * @param store Pointer to the snapshot store
+ * @param reader Reader slot of the calling thread
+ * @return The current snapshot, or NULL if none has been published yet
+ * @details Lock-free. The snapshot stays valid until snapshot_release(),
+ *          however many newer snapshots are published in the meantime.
+ */
+WorldSnapshot* snapshot_acquire(SnapshotStore* store, int reader);
+
+/**
+ * @brief Drops a reference taken with snapshot_acquire()
+ * @param snap Snapshot to release (NULL is ignored)
+ */
+void snapshot_release(WorldSnapshot* snap);
+
+/**
+ * @brief Publishes a snapshot of the live ball list
+ * @param store Pointer to the snapshot store
+ * @param list Pointer to the live ball list (the caller holds mutex_ball)
+ * @param tick Simulation step the list has reached
+ * @return 0 on success, -1 if memory allocation fails (the previous snapshot stays current)
+ * @details Writer side, called by the simulation thread only. Copies the list
+ *          into a reclaimed or new snapshot grouped by owner, swaps it in,
+ *          reclaims replaced snapshots that are no longer reachable and
+ *          wakes the threads blocked in snapshot_wait().
+ */
+int snapshot_publish(SnapshotStore* store, const BallList* list, unsigned long long tick);
+
+/**
+ * @brief Waits until a snapshot newer than the last one seen is published
+ * @param store Pointer to the snapshot store
+ * @param last_seq In: publication count last seen; out: current publication count
+ * @param timeout_ms Maximum time to wait in milliseconds
+ * @return 1 if a newer snapshot is available, 0 on timeout or after snapshot_wake_all()
+ */
+int snapshot_wait(SnapshotStore* store, unsigned long long* last_seq, int timeout_ms);
+
+/**
+ * @brief Wakes every thread blocked in snapshot_wait()
+ * @param store Pointer to the snapshot store
+ * @details Used on shutdown: later calls to snapshot_wait() return immediately.
+ */
+void snapshot_wake_all(SnapshotStore* store);
+
+#endif // SNAPSHOT_H
@@ -2,6 +2,7 @@
 #define TASK_H
 
 #include <pthread.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
@@ -9,46 +10,75 @@
 
 #include "console_color.h"
 
-extern volatile sig_atomic_t keep_running;
-
-#define TASK_QUEUE_CAPACITY 128  // Maximum queue size
+#define TASK_QUEUE_CAPACITY 128  // Maximum queue size (must be a power of two)
+#define TASK_QUEUE_BATCH 16      // Maximum number of tasks moved by one batch call
+#define TASK_QUEUE_SPIN 64       // Empty/full retries before sleeping on the futex
+#define TASK_CACHE_LINE 64       // Producer and consumer positions live on separate cache lines
+#define TASK_DISCONNECT -1       // Task length marking the disconnect queued when the peer closes
+#define TASK_CONNECT -2          // Task length marking the initial ball spawn queued on accept
 
 /**
  * @brief Structure representing a task to be processed
  * @details This structure contains information about a command to be executed,
  *          including the client file descriptor, received data, and data length.
+ *          The data lives in a BufferSlab buffer owned by the task: the producer
+ *          allocates it and the thread that processes the task returns it, so
+ *          the queue only moves these 16 bytes.
  * @date 2025-04-07
  * @author Kim Hyo Jin
  */
 typedef struct {
     int fd;                      // Client file descriptor
-    char data[BUFSIZ];          // Received data
-    int length;                 // Data length
+    int length;                  // Data length (excluding the terminating '\0')
+    char* data;                  // Received data, '\0'-terminated (BufferSlab buffer)
 } Task;
 
+/**
+ * @brief One slot of the task ring
+ * @details seq tells the slot's state relative to a queue position pos:
+ *          seq == pos means the slot is free for the producer of pos,
+ *          seq == pos + 1 means it holds the task of pos.
+ */
+typedef struct {
+    uint32_t seq;                // Slot sequence number (atomic)
+    Task task;                   // Stored task
+} TaskCell;
+
 /**
  * @brief Structure representing a task queue
- * @details This structure manages a queue of tasks using a circular buffer,
- *          with synchronization mechanisms for thread safety. The queue is
- *          implemented as a circular buffer with front and rear pointers.
+ * @details Bounded lock-free multi-producer/multi-consumer ring (Vyukov's
+ *          algorithm). Producers and consumers each claim positions with a
+ *          compare-and-swap on their own counter and hand slots over through
+ *          the per-slot sequence number, so no lock is shared between the
+ *          epoll thread and the workers. A batch call claims several
+ *          consecutive positions with a single compare-and-swap.
+ *          Threads only sleep after spinning on an empty (or full) ring; they
+ *          sleep on a futex word that is bumped, and woken, only when a thread
+ *          is actually waiting.
  * @date 2025-04-07
  * @author Kim Hyo Jin
  */
 typedef struct {
-    Task queue[TASK_QUEUE_CAPACITY];  // Task storage space (circular queue)
-    int front;                        // Queue front index
-    int rear;                         // Queue rear index
-    int count;                        // Current number of tasks
+    uint32_t enqueue_pos;            // Next position to produce (atomic)
+    char pad0[TASK_CACHE_LINE - sizeof(uint32_t)];
+    uint32_t dequeue_pos;            // Next position to consume (atomic)
+    char pad1[TASK_CACHE_LINE - sizeof(uint32_t)];
+
+    uint32_t not_empty;              // Futex word bumped when tasks are pushed to a waiting consumer
+    uint32_t empty_waiters;          // Consumers sleeping (or about to) on not_empty
+    uint32_t not_full;               // Futex word bumped when slots are freed for a waiting producer
+    uint32_t full_waiters;           // Producers sleeping (or about to) on not_full
+    int stopping;                    // Set by task_queue_wake_all(); pops return 0 from then on
+    int spin_limit;                  // Retries before sleeping (TASK_QUEUE_SPIN, 1 on a single CPU)
+    char pad2[TASK_CACHE_LINE - 4 * sizeof(uint32_t) - 2 * sizeof(int)];
 
-    pthread_mutex_t mutex;           // Mutex for queue access
-    pthread_cond_t cond;             // Condition variable (signals when tasks are available)
+    TaskCell cells[TASK_QUEUE_CAPACITY]; // Task storage space (circular queue)
 } TaskQueue;
 
 /**
  * @brief Initializes a new task queue
  * @param q Pointer to the task queue to be initialized
- * @details Initializes the task queue by setting front, rear, and count to 0,
- *          and initializing the mutex and condition variables. This function
+ * @details Marks every slot free for its first position. This function
  *          must be called before any other task queue operations.
  * @date 2025-04-07
  * @author Kim Hyo Jin
@@ -56,34 +86,66 @@ typedef struct {
 void task_queue_init(TaskQueue* q);
 
 /**
- * @brief Adds a task to the queue
+ * @brief Adds several tasks to the queue
  * @param q Pointer to the task queue
- * @param task Task to be added
- * @details Adds a task to the end of the queue. If the queue is full, the function
- *          will wait until space becomes available. This function is typically called
- *          by the main thread (epoll loop) to add new tasks.
- * @date 2025-04-07
- * @author Kim Hyo Jin
+ * @param tasks Tasks to be added, in order
+ * @param count Number of tasks
+ * @return Number of tasks added (less than count only if the queue is stopped)
+ * @details Claims as many consecutive free slots as are available with one
+ *          compare-and-swap and waits only when the queue is full. Waiting
+ *          consumers are woken once per call rather than once per task.
  */
-void task_queue_push(TaskQueue* q, Task task);
+int task_queue_push_batch(TaskQueue* q, const Task* tasks, int count);
 
 /**
- * @brief Removes a task from the queue
+ * @brief Removes up to max tasks from the queue
  * @param q Pointer to the task queue
- * @return The task removed from the queue
- * @details Removes a task from the front of the queue. If the queue is empty, the function
- *          will wait until a task becomes available, unless keep_running is false.
- *          This function is typically called by worker threads to process tasks.
- * @date 2025-04-07
- * @author Kim Hyo Jin
+ * @param tasks Receives the removed tasks, in queue order
+ * @param max Capacity of tasks
+ * @return Number of tasks removed (at least 1), or 0 if the queue was stopped
+ * @details Waits until at least one task is available, then takes every
+ *          ready task up to max with a single compare-and-swap.
+ */
+int task_queue_pop_batch(TaskQueue* q, Task* tasks, int max);
+
+/**
+ * @brief Adds as many tasks as fit without waiting
+ * @param q Pointer to the task queue
+ * @param tasks Tasks to be added, in order
+ * @param count Number of tasks
+ * @return Number of leading tasks added (0 if the queue is full or stopped)
+ */
+int task_queue_try_push_batch(TaskQueue* q, const Task* tasks, int count);
+
+/**
+ * @brief Removes up to max ready tasks without waiting
+ * @param q Pointer to the task queue
+ * @param tasks Receives the removed tasks, in queue order
+ * @param max Capacity of tasks
+ * @return Number of tasks removed (0 if the queue is empty or stopped)
+ */
+int task_queue_try_pop_batch(TaskQueue* q, Task* tasks, int max);
+
+/**
+ * @brief Tells whether the queue currently holds no ready task
+ * @param q Pointer to the task queue
+ * @return Non-zero if empty
+ * @details A snapshot only: other threads may push or pop right after.
+ */
+int task_queue_is_empty(TaskQueue* q);
+
+/**
+ * @brief Stops the queue and wakes every waiting thread
+ * @param q Pointer to the task queue
+ * @details Async-signal-safe (atomic store plus futex syscalls), so it can be
+ *          called from the SIGINT handler.
  */
-Task task_queue_pop(TaskQueue* q);
+void task_queue_wake_all(TaskQueue* q);
 
 /**
  * @brief Frees all resources used by the task queue
  * @param q Pointer to the task queue to be destroyed
- * @details Frees the task queue and all associated resources, including
- *          destroying the mutex and condition variables.
+ * @details Frees the task queue. No thread may still be using it.
  * @date 2025-04-07
  * @author Kim Hyo Jin
  */
@@ -0,0 +1,54 @@
+#ifndef TICK_SCHEDULER_H
+#define TICK_SCHEDULER_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+#define DEFAULT_TICK_HZ 33          ///< Simulation/broadcast rate (about 30 ms per tick)
+#define MAX_TICK_HZ 1000            ///< Upper bound accepted for the tick rate
+#define DEFAULT_MAX_CATCHUP 5       ///< Maximum simulation steps run after a single wakeup
+
+/**
+ * @brief Fixed-timestep scheduler driven by a periodic timerfd
+ * @details The timer fires on an absolute CLOCK_MONOTONIC grid, so the tick
+ *          period does not drift with the time spent simulating and
+ *          broadcasting. When the tick thread falls behind, the number of
+ *          expirations tells how many steps were missed; up to max_catchup
+ *          of them are run and the rest are skipped.
+ */
+typedef struct {
+    int timer_fd;                   ///< timerfd file descriptor
+    int tick_hz;                    ///< Tick rate in Hz
+    int max_catchup;                ///< Maximum steps run per wakeup
+    unsigned long long ticks;       ///< Timer expirations observed since startup
+    unsigned long long steps;       ///< Simulation steps run since startup
+    unsigned long long late_ticks;  ///< Wakeups that found more than one expiration (overrun)
+    unsigned long long skipped_ticks; ///< Expirations dropped because of the catch-up cap
+} TickScheduler;
+
+/**
+ * @brief Initializes a tick scheduler and arms its timer
+ * @param sched Pointer to the scheduler to be initialized
+ * @param tick_hz Tick rate in Hz (1 ~ MAX_TICK_HZ)
+ * @param max_catchup Maximum number of steps to run per wakeup (at least 1)
+ * @return 0 on success, -1 on failure
+ */
+int tick_scheduler_init(TickScheduler* sched, int tick_hz, int max_catchup);
+
+/**
+ * @brief Waits for the next tick
+ * @param sched Pointer to the tick scheduler
+ * @return Number of simulation steps to run now (0 if interrupted)
+ * @details Blocks until the timer expires. If several periods elapsed since
+ *          the last wakeup, the tick is counted as late and the missed steps
+ *          are returned, capped at max_catchup; the excess is counted as skipped.
+ */
+int tick_scheduler_wait(TickScheduler* sched);
+
+/**
+ * @brief Disarms the timer and closes the timerfd
+ * @param sched Pointer to the tick scheduler
+ */
+void tick_scheduler_destroy(TickScheduler* sched);
+
+#endif // TICK_SCHEDULER_H
@@ -0,0 +1,88 @@
+#ifndef UDP_CHANNEL_H
+#define UDP_CHANNEL_H
+
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include "out_queue.h"
+
+struct mmsghdr;
+
+#define UDP_DATAGRAM_MAX 1200       ///< Largest datagram sent (stays under a typical path MTU)
+#define UDP_HEADER_MAX 48           ///< Room reserved for the datagram header
+#define UDP_MAX_FRAGMENTS 65535     ///< Fragments per snapshot (header field limit)
+
+/**
+ * @brief Sender of sequence-numbered snapshot datagrams
+ * @details Clients that registered a UDP port with "u:<port>" receive ball
+ *          states here instead of on their TCP stream, so a lost packet
+ *          only loses one tick instead of delaying every later one. Each
+ *          tick's encoded frame is cut at ball boundaries into fragments of
+ *          at most UDP_DATAGRAM_MAX bytes; every fragment starts with the
+ *          header "S<seq> <index>/<count>\n" followed by whole balls
+ *          ("id,x,y,dx,dy,radius,r,g,b|" each), so a client can tell which
+ *          tick a fragment belongs to and apply only the newest complete one.
+ *          The fragments are prepared once per tick; the addresses of the
+ *          registered clients are collected while the client list is locked,
+ *          and the fragments are sent to each of them with one sendmmsg()
+ *          call after the lock is released. Only the fan-out thread uses the
+ *          channel.
+ */
+typedef struct {
+    int fd;                         ///< UDP socket (-1 if it could not be opened)
+    const SharedFrame* frame;       ///< Frame the fragments point into
+    int count;                      ///< Fragments of the prepared frame
+    int capacity;                   ///< Fragments the arrays can hold
+    struct iovec* iov;              ///< Two per fragment: header, ball range
+    struct mmsghdr* msgs;           ///< One message per fragment
+    char* headers;                  ///< UDP_HEADER_MAX bytes per fragment
+    struct sockaddr_in* peers;      ///< Clients the prepared frame goes to
+    int peer_count;                 ///< Addresses in peers
+    int peer_capacity;              ///< Addresses peers can hold
+    unsigned long long datagrams;   ///< Datagrams sent (statistics)
+    unsigned long long dropped;     ///< Datagrams the socket did not accept (statistics)
+} UdpChannel;
+
+/**
+ * @brief Opens the UDP socket, bound to port
+ * @param udp Pointer to the channel to be initialized
+ * @param port UDP port the datagrams are sent from
+ * @return 0 on success, -1 on failure (the channel is left disabled, fd = -1)
+ */
+int udp_channel_init(UdpChannel* udp, int port);
+
+/**
+ * @brief Closes the socket and frees the fragment arrays
+ * @param udp Pointer to the channel
+ */
+void udp_channel_destroy(UdpChannel* udp);
+
+/**
+ * @brief Splits an encoded frame into datagrams
+ * @param udp Pointer to the channel
+ * @param frame Encoded ball states; must stay alive until udp_channel_flush()
+ * @param seq Sequence number of the frame (the snapshot tick)
+ * @return Number of fragments, or -1 if memory allocation fails
+ * @details An empty frame gives one fragment without balls, so clients see
+ *          the world become empty.
+ */
+int udp_channel_prepare(UdpChannel* udp, const SharedFrame* frame, unsigned long long seq);
+
+/**
+ * @brief Adds a client the prepared fragments are sent to
+ * @param udp Pointer to the channel
+ * @param addr Client's UDP address (copied)
+ * @return 0 on success, -1 if memory allocation fails (send the frame on TCP instead)
+ */
+int udp_channel_add_peer(UdpChannel* udp, const struct sockaddr_in* addr);
+
+/**
+ * @brief Sends the prepared fragments to every added client and clears the list
+ * @param udp Pointer to the channel
+ * @return Number of datagrams the socket accepted
+ * @details Call without holding the client list mutex. Never blocks:
+ *          fragments the socket buffer cannot take are dropped, and the
+ *          client waits for the next tick.
+ */
+int udp_channel_flush(UdpChannel* udp);
+
+#endif // UDP_CHANNEL_H
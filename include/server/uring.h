@@ -0,0 +1,117 @@
+#ifndef URING_H
+#define URING_H
+
+#include <stddef.h>
+#include <linux/io_uring.h>
+
+#define URING_SQ_ENTRIES 1024       ///< Submission queue size of a reactor ring
+#define URING_CQ_ENTRIES 8192       ///< Completion queue size (sends of every client complete in one tick)
+#define URING_BUF_GROUP 0           ///< Provided buffer group used by multishot recv
+#define URING_BUF_COUNT 256         ///< Receive buffers in the group (power of two)
+#define URING_BUF_SIZE 2048         ///< Bytes per receive buffer
+
+/**
+ * @brief One io_uring instance driven with raw system calls
+ * @details Thin wrapper over io_uring_setup()/io_uring_enter() and the
+ *          mmap()ed submission and completion rings, so the server does not
+ *          depend on liburing. Each reactor owns one ring and is its only
+ *          submitter, so no field is locked. A ring of provided receive
+ *          buffers can be registered for multishot recv: the kernel picks a
+ *          free buffer for every completion and the reactor gives it back
+ *          with uring_buffer_recycle() once the bytes are copied out.
+ */
+typedef struct {
+    int fd;                         ///< io_uring file descriptor (-1 if not set up)
+    unsigned* sq_head;              ///< Kernel: first SQE not yet consumed
+    unsigned* sq_tail;              ///< User: one past the last SQE published
+    unsigned* sq_array;             ///< Indirection array (index i maps to SQE i)
+    unsigned sq_mask;               ///< Submission ring mask
+    unsigned sq_entries;            ///< Submission ring size
+    unsigned sq_pending;            ///< SQEs filled but not yet passed to io_uring_enter()
+    struct io_uring_sqe* sqes;      ///< SQE array
+    unsigned* cq_head;              ///< User: first CQE not yet seen
+    unsigned* cq_tail;              ///< Kernel: one past the last CQE posted
+    unsigned cq_mask;               ///< Completion ring mask
+    struct io_uring_cqe* cqes;      ///< CQE ring
+    void* sq_ring;                  ///< mmap()ed submission ring
+    size_t sq_ring_size;            ///< Size of sq_ring
+    void* cq_ring;                  ///< mmap()ed completion ring (same as sq_ring with IORING_FEAT_SINGLE_MMAP)
+    size_t cq_ring_size;            ///< Size of cq_ring
+    size_t sqes_size;               ///< Size of sqes
+    struct io_uring_buf_ring* buf_ring; ///< Provided buffer ring (NULL if not registered)
+    char* buf_base;                 ///< Receive buffers (URING_BUF_COUNT * URING_BUF_SIZE)
+    unsigned short buf_tail;        ///< Local copy of the buffer ring tail
+    unsigned long long enters;      ///< io_uring_enter() calls made (statistics)
+} Uring;
+
+/**
+ * @brief Creates an io_uring instance and maps its rings
+ * @param ring Pointer to the ring to be initialized
+ * @return 0 on success, -1 if io_uring is unavailable or lacks a needed feature (errno is set)
+ */
+int uring_init(Uring* ring);
+
+/**
+ * @brief Registers the provided receive buffers (group URING_BUF_GROUP)
+ * @param ring Pointer to the ring
+ * @return 0 on success, -1 on failure (errno is set)
+ */
+int uring_setup_buffers(Uring* ring);
+
+/**
+ * @brief Unmaps the rings, frees the receive buffers and closes the ring
+ * @param ring Pointer to the ring
+ * @details Requests still in flight are cancelled by the kernel.
+ */
+void uring_destroy(Uring* ring);
+
+/**
+ * @brief Returns a cleared SQE to fill
+ * @param ring Pointer to the ring
+ * @return The SQE, published by the next uring_submit_and_wait()
+ * @details When the submission ring is full the pending SQEs are submitted
+ *          first, so a caller never runs out of entries.
+ */
+struct io_uring_sqe* uring_get_sqe(Uring* ring);
+
+/**
+ * @brief Submits the pending SQEs and waits for completions
+ * @param ring Pointer to the ring
+ * @param wait_nr Completions to wait for (0 only submits)
+ * @param timeout_ms Longest wait in milliseconds
+ * @return 0 on success or timeout, -1 on error (errno is set; EINTR on a signal)
+ * @details One io_uring_enter() call covers every SQE filled since the
+ *          previous call.
+ */
+int uring_submit_and_wait(Uring* ring, unsigned wait_nr, int timeout_ms);
+
+/**
+ * @brief Returns the oldest unseen completion
+ * @param ring Pointer to the ring
+ * @return The CQE, or NULL if none is posted
+ */
+struct io_uring_cqe* uring_peek_cqe(Uring* ring);
+
+/**
+ * @brief Marks the completion returned by uring_peek_cqe() as consumed
+ * @param ring Pointer to the ring
+ */
+void uring_cqe_seen(Uring* ring);
+
+/**
+ * @brief Returns the receive buffer chosen for a completion
+ * @param ring Pointer to the ring
+ * @param cqe Completion with IORING_CQE_F_BUFFER set
+ * @param bid Receives the buffer ID to pass to uring_buffer_recycle()
+ * @return Start of the received bytes
+ */
+char* uring_buffer(Uring* ring, const struct io_uring_cqe* cqe, unsigned* bid);
+
+/**
+ * @brief Gives a receive buffer back to the kernel
+ * @param ring Pointer to the ring
+ * @param bid Buffer ID returned by uring_buffer()
+ */
+void uring_buffer_recycle(Uring* ring, unsigned bid);
+
+#endif // URING_H
@@ -0,0 +1,166 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <stdint.h>
+#include "task.h"
+
+#define TASK_DEQUE_CAPACITY 256     ///< Tasks held by one worker's deque (must be a power of two)
+#define WORKER_POOL_REFILL TASK_QUEUE_BATCH ///< Tasks moved from the inbox to the deque at once
+#define WORKER_POOL_STEAL_RETRIES 4 ///< Retries of a steal that lost a race before moving on
+
+/**
+ * @brief Chase-Lev work-stealing deque of one worker
+ * @details The owning worker pushes and pops at the bottom without any
+ *          compare-and-swap except when taking the last task; other workers
+ *          steal from the top with a compare-and-swap on top. Fixed capacity:
+ *          the owner only refills it from its inbox when there is room.
+ */
+typedef struct {
+    long top;                       ///< Next task to steal (atomic, advanced by CAS)
+    char pad0[TASK_CACHE_LINE - sizeof(long)];
+    long bottom;                    ///< Next free position of the owner (atomic)
+    char pad1[TASK_CACHE_LINE - sizeof(long)];
+    Task slots[TASK_DEQUE_CAPACITY]; ///< Circular task storage
+} TaskDeque;
+
+/**
+ * @brief Per-worker scheduling state
+ * @details The counters are written by the owning worker only.
+ */
+typedef struct {
+    TaskQueue inbox;                ///< Tasks handed to this worker by the reactors (MPMC)
+    TaskDeque deque;                ///< Tasks taken from the inbox, stealable by other workers
+    unsigned long long local_pops;  ///< Tasks taken from its own inbox or deque
+    unsigned long long steals;      ///< Tasks taken from another worker's deque or inbox
+} WorkerSlot;
+
+/**
+ * @brief Work-stealing scheduler of the command workers
+ * @details Replaces the single shared task queue. Reactors spread their
+ *          task batches round-robin over the workers' inboxes. A worker
+ *          moves a batch from its inbox into its deque and runs the tasks
+ *          in arrival order; a worker with nothing to do steals the newest
+ *          tasks of a busy worker's deque, or the oldest of its inbox, so a
+ *          heavy command (e.g. a:10000) no longer holds up the tasks queued
+ *          behind it. Idle workers sleep on one futex word that is bumped
+ *          only when a worker is waiting.
+ *          The number of running workers is elastic: slots are allocated for
+ *          max_workers, submissions target the first target_workers slots
+ *          and a worker whose slot is at or above the target finishes the
+ *          tasks already in its queues and exits. Queues of retired slots
+ *          stay visible to thieves, so nothing queued there is lost.
+ */
+typedef struct {
+    WorkerSlot* workers;            ///< One slot per possible worker (max_workers)
+    int max_workers;                ///< Number of slots
+    int target_workers;             ///< Submissions go to slots [0, target); workers at or above it retire (atomic)
+    int busy_workers;               ///< Workers running a task right now (atomic)
+    unsigned long long wait_avg_ns; ///< Moving average of the time tasks wait in the queues (atomic)
+    unsigned long long wait_max_ns; ///< Longest wait since the last worker_pool_take_wait_max() (atomic)
+    uint32_t next_inbox;            ///< Round-robin cursor of worker_pool_submit() (atomic)
+    uint32_t work_seq;              ///< Futex word bumped when work arrives for an idle worker
+    uint32_t idle_waiters;          ///< Workers sleeping (or about to) on work_seq
+    int stopping;                   ///< Set by worker_pool_wake_all(); worker_pool_next() returns 0
+} WorkerPool;
+
+/**
+ * @brief Initializes a worker pool
+ * @param pool Pointer to the pool to be initialized
+ * @param max_workers Number of worker slots (each worker calls worker_pool_next() with its slot)
+ * @param target_workers Initial number of slots receiving tasks
+ * @return 0 on success, -1 if memory allocation fails
+ */
+int worker_pool_init(WorkerPool* pool, int max_workers, int target_workers);
+
+/**
+ * @brief Hands a batch of tasks to the workers
+ * @param pool Pointer to the worker pool
+ * @param tasks Tasks to be processed
+ * @param count Number of tasks
+ * @return Number of tasks handed over (less than count only if the pool is stopped)
+ * @details Pushes into the next inbox in round-robin order, spills into the
+ *          following inboxes when it is full and waits only when every inbox
+ *          is full. Wakes an idle worker once per call. Only for reactors:
+ *          workers empty the inboxes, so a worker waiting here could wait
+ *          forever (workers use worker_pool_resubmit()).
+ */
+int worker_pool_submit(WorkerPool* pool, const Task* tasks, int count);
+
+/**
+ * @brief Hands a task back to the pool from a worker, without ever waiting
+ * @param pool Pointer to the worker pool
+ * @param worker Index of the calling worker
+ * @param task Task to be processed again (a mailbox token)
+ * @return 1 if queued, 0 if the worker's deque and every inbox are full
+ * @details Pushes onto the caller's own deque, where thieves can take it,
+ *          and falls back to the inboxes. On 0 the caller keeps the task and
+ *          processes it itself.
+ */
+int worker_pool_resubmit(WorkerPool* pool, int worker, const Task* task);
+
+/**
+ * @brief Takes the next task of a worker
+ * @param pool Pointer to the worker pool
+ * @param worker Index of the calling worker
+ * @param task Receives the task
+ * @return 1 if a task was taken, 0 if the pool was stopped or the worker was retired
+ * @details Tries the worker's deque, then its inbox, then steals from the
+ *          other workers, and sleeps when every queue is empty. A worker
+ *          whose slot is at or above target_workers only empties its own
+ *          queues and then returns 0.
+ */
+int worker_pool_next(WorkerPool* pool, int worker, Task* task);
+
+/**
+ * @brief Changes the number of slots receiving tasks
+ * @param pool Pointer to the worker pool
+ * @param target New target (1 ~ max_workers)
+ * @details Lowering the target retires the workers of the slots above it;
+ *          sleeping workers are woken so that they notice.
+ */
+void worker_pool_set_target(WorkerPool* pool, int target);
+
+/**
+ * @brief Records how long a task waited before a worker took it
+ * @param pool Pointer to the worker pool
+ * @param wait_ns Time between submission and the start of processing
+ */
+void worker_pool_record_wait(WorkerPool* pool, unsigned long long wait_ns);
+
+/**
+ * @brief Returns and resets the longest wait recorded since the last call
+ * @param pool Pointer to the worker pool
+ * @return Longest wait in nanoseconds
+ */
+unsigned long long worker_pool_take_wait_max(WorkerPool* pool);
+
+/**
+ * @brief Returns the number of tasks queued in every inbox and deque
+ * @param pool Pointer to the worker pool
+ * @return Approximate queue depth (the queues keep changing while it is read)
+ */
+int worker_pool_depth(WorkerPool* pool);
+
+/**
+ * @brief Stops the pool and wakes every sleeping worker and reactor
+ * @param pool Pointer to the worker pool
+ * @details Async-signal-safe (atomic stores plus futex syscalls), so it can be
+ *          called from the SIGINT handler.
+ */
+void worker_pool_wake_all(WorkerPool* pool);
+
+/**
+ * @brief Prints the local pop and steal counters of every worker
+ * @param pool Pointer to the worker pool
+ */
+void worker_pool_report(const WorkerPool* pool);
+
+/**
+ * @brief Frees the resources of a worker pool
+ * @param pool Pointer to the worker pool
+ * @details Tasks still queued are dropped; their buffers are released with
+ *          the buffer slab. No thread may still be using the pool.
+ */
+void worker_pool_destroy(WorkerPool* pool);
+
+#endif // WORKER_POOL_H
@@ -0,0 +1,58 @@
+#include "locked_task_queue.h"
+
+void locked_task_queue_init(LockedTaskQueue* q) {
+    memset(q, 0, sizeof(LockedTaskQueue));
+    pthread_mutex_init(&q->mutex, NULL);
+    pthread_cond_init(&q->cond, NULL);
+}
+
+void locked_task_queue_push(LockedTaskQueue* q, const LockedTask* task) {
+    pthread_mutex_lock(&q->mutex);
+
+    while (q->count == TASK_QUEUE_CAPACITY && !q->stopping) {
+        pthread_cond_wait(&q->cond, &q->mutex);
+    }
+    if (q->stopping) {
+        pthread_mutex_unlock(&q->mutex);
+        return;
+    }
+
+    q->queue[q->rear] = *task;
+    q->rear = (q->rear + 1) % TASK_QUEUE_CAPACITY;
+    q->count++;
+
+    pthread_cond_signal(&q->cond);
+    pthread_mutex_unlock(&q->mutex);
+}
+
+int locked_task_queue_pop(LockedTaskQueue* q, LockedTask* task) {
+    pthread_mutex_lock(&q->mutex);
+
+    while (q->count == 0 && !q->stopping) {
+        pthread_cond_wait(&q->cond, &q->mutex);
+    }
+    if (q->stopping) {
+        pthread_mutex_unlock(&q->mutex);
+        return 0;
+    }
+
+    *task = q->queue[q->front];
+    q->front = (q->front + 1) % TASK_QUEUE_CAPACITY;
+    q->count--;
+
+    pthread_cond_signal(&q->cond);
+    pthread_mutex_unlock(&q->mutex);
+    return 1;
+}
+
+void locked_task_queue_wake_all(LockedTaskQueue* q) {
+    pthread_mutex_lock(&q->mutex);
+    q->stopping = 1;
+    pthread_cond_broadcast(&q->cond);
+    pthread_mutex_unlock(&q->mutex);
+}
+
+void locked_task_queue_destroy(LockedTaskQueue* q) {
+    pthread_mutex_destroy(&q->mutex);
+    pthread_cond_destroy(&q->cond);
+}
@@ -0,0 +1,214 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "task.h"
+#include "buffer_slab.h"
+#include "locked_task_queue.h"
+
+#define BENCH_DEFAULT_TASKS 1000000
+#define BENCH_DEFAULT_PRODUCERS 1       // 서버의 epoll 스레드
+#define BENCH_DEFAULT_CONSUMERS 4       // NUM_WORKERS
+#define BENCH_MAX_THREADS 64
+#define BENCH_POP_BATCH 4               // WORKER_TASK_BATCH
+
+typedef enum {
+    BENCH_LOCKED,       // 기존 mutex + condvar 큐 (BUFSIZ 작업을 값으로 복사)
+    BENCH_RING,         // 락프리 링 + 슬랩 버퍼, 배치 크기 1 (서버는 쓰지 않는 방식: 비교용)
+    BENCH_RING_BATCH    // 락프리 링, 배치 push/pop
+} BenchMode;
+
+typedef struct {
+    BenchMode mode;
+    LockedTaskQueue* locked;
+    TaskQueue* ring;
+    BufferSlab* slab;           // 링 모드의 명령 버퍼
+    long tasks;                 // 전체 작업 수
+    int producers;
+    long consumed;              // 소비된 작업 수 (atomic)
+    long long fd_sum;           // 소비된 작업 fd의 합 (검증용, atomic)
+} Bench;
+
+typedef struct {
+    Bench* bench;
+    int index;
+} BenchThread;
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// 실제 명령과 비슷한 짧은 페이로드 (기존 방식: 작업 안에 복사)
+static void make_locked_task(LockedTask* task, long n) {
+    task->fd = (int)(n % 1000);
+    task->length = snprintf(task->data, sizeof(task->data), "a:%ld", n % 100);
+}
+
+// 서버의 epoll 스레드와 같이 슬랩 버퍼에 복사
+static int make_task(BufferSlab* slab, Task* task, long n) {
+    char cmd[32];
+    int len = snprintf(cmd, sizeof(cmd), "a:%ld", n % 100);
+    task->data = buffer_slab_alloc(slab, (size_t)len + 1);
+    if (!task->data) return -1;
+    memcpy(task->data, cmd, (size_t)len + 1);
+    task->fd = (int)(n % 1000);
+    task->length = len;
+    return 0;
+}
+
+static void* producer_main(void* arg) {
+    BenchThread* t = (BenchThread*)arg;
+    Bench* b = t->bench;
+    long begin = b->tasks * t->index / b->producers;
+    long end = b->tasks * (t->index + 1) / b->producers;
+    Task batch[TASK_QUEUE_BATCH];
+    LockedTask* locked_task = NULL;
+
+    if (b->mode == BENCH_LOCKED) {
+        locked_task = malloc(sizeof(LockedTask));
+        if (!locked_task) return NULL;
+    }
+
+    for (long n = begin; n < end; ) {
+        if (b->mode == BENCH_RING_BATCH) {
+            int k = 0;
+            while (k < TASK_QUEUE_BATCH && n < end) {
+                if (make_task(b->slab, &batch[k], n++) == 0) k++;
+            }
+            task_queue_push_batch(b->ring, batch, k);
+        } else if (b->mode == BENCH_RING) {
+            if (make_task(b->slab, &batch[0], n++) == 0) task_queue_push_batch(b->ring, &batch[0], 1);
+        } else {
+            make_locked_task(locked_task, n++);
+            locked_task_queue_push(b->locked, locked_task);
+        }
+    }
+    free(locked_task);
+    return NULL;
+}
+
+static void* consumer_main(void* arg) {
+    BenchThread* t = (BenchThread*)arg;
+    Bench* b = t->bench;
+    Task batch[BENCH_POP_BATCH];
+    LockedTask* locked_task = NULL;
+
+    if (b->mode == BENCH_LOCKED) {
+        locked_task = malloc(sizeof(LockedTask));
+        if (!locked_task) return NULL;
+    }
+
+    for (;;) {
+        int n;
+        long long sum = 0;
+        if (b->mode == BENCH_LOCKED) {
+            n = locked_task_queue_pop(b->locked, locked_task);
+            if (n) sum = locked_task->fd;
+        } else {
+            n = task_queue_pop_batch(b->ring, batch, (b->mode == BENCH_RING) ? 1 : BENCH_POP_BATCH);
+            for (int i = 0; i < n; i++) {
+                sum += batch[i].fd;
+                buffer_slab_free(b->slab, batch[i].data);
+            }
+        }
+        if (n == 0) break;  // 큐가 중지됨
+
+        __atomic_add_fetch(&b->fd_sum, sum, __ATOMIC_RELAXED);
+
+        // 마지막 작업을 꺼낸 스레드가 나머지 소비자를 깨움
+        if (__atomic_add_fetch(&b->consumed, n, __ATOMIC_ACQ_REL) == b->tasks) {
+            if (b->mode == BENCH_LOCKED) locked_task_queue_wake_all(b->locked);
+            else task_queue_wake_all(b->ring);
+        }
+    }
+    free(locked_task);
+    return NULL;
+}
+
+static int run_bench(BenchMode mode, const char* name, long tasks, int producers, int consumers) {
+    Bench b;
+    memset(&b, 0, sizeof(b));
+    b.mode = mode;
+    b.tasks = tasks;
+    b.producers = producers;
+
+    if (mode == BENCH_LOCKED) {
+        b.locked = malloc(sizeof(LockedTaskQueue));
+        if (!b.locked) return -1;
+        locked_task_queue_init(b.locked);
+    } else {
+        b.ring = malloc(sizeof(TaskQueue));
+        b.slab = malloc(sizeof(BufferSlab));
+        if (!b.ring || !b.slab) {
+            free(b.ring);
+            free(b.slab);
+            return -1;
+        }
+        task_queue_init(b.ring);
+        buffer_slab_init(b.slab);
+    }
+
+    pthread_t threads[2 * BENCH_MAX_THREADS];
+    BenchThread args[2 * BENCH_MAX_THREADS];
+    double start = now_sec();
+
+    for (int i = 0; i < consumers; i++) {
+        args[i] = (BenchThread){ &b, i };
+        pthread_create(&threads[i], NULL, consumer_main, &args[i]);
+    }
+    for (int i = 0; i < producers; i++) {
+        args[consumers + i] = (BenchThread){ &b, i };
+        pthread_create(&threads[consumers + i], NULL, producer_main, &args[consumers + i]);
+    }
+    for (int i = 0; i < consumers + producers; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    double elapsed = now_sec() - start;
+
+    long long expected = 0;
+    for (long n = 0; n < tasks; n++) expected += n % 1000;
+    int ok = (b.consumed == tasks && b.fd_sum == expected);
+
+    printf("%-12s %10ld tasks  %8.3f s  %8.2f Mtasks/s  %s\n",
+           name, tasks, elapsed, (double)tasks / elapsed / 1e6, ok ? "ok" : "MISMATCH");
+
+    if (b.locked) {
+        locked_task_queue_destroy(b.locked);
+        free(b.locked);
+    }
+    if (b.ring) free(b.ring);
+    if (b.slab) {
+        buffer_slab_destroy(b.slab);
+        free(b.slab);
+    }
+    return ok ? 0 : -1;
+}
+
+int main(int argc, char** argv) {
+    long tasks = argc > 1 ? atol(argv[1]) : BENCH_DEFAULT_TASKS;
+    int producers = argc > 2 ? atoi(argv[2]) : BENCH_DEFAULT_PRODUCERS;
+    int consumers = argc > 3 ? atoi(argv[3]) : BENCH_DEFAULT_CONSUMERS;
+
+    if (tasks <= 0 || producers < 1 || producers > BENCH_MAX_THREADS ||
+        consumers < 1 || consumers > BENCH_MAX_THREADS) {
+        fprintf(stderr, "Usage: %s [tasks] [producers 1-%d] [consumers 1-%d]\n",
+                argv[0], BENCH_MAX_THREADS, BENCH_MAX_THREADS);
+        return 1;
+    }
+
+    printf("Task queue benchmark: %d producer(s), %d consumer(s), capacity %d\n",
+           producers, consumers, TASK_QUEUE_CAPACITY);
+    printf("Queue footprint: mutex %zu bytes, ring %zu bytes\n",
+           sizeof(LockedTaskQueue), sizeof(TaskQueue));
+
+    int rc = 0;
+    rc |= run_bench(BENCH_LOCKED, "mutex", tasks, producers, consumers);
+    rc |= run_bench(BENCH_RING, "ring-1", tasks, producers, consumers);
+    rc |= run_bench(BENCH_RING_BATCH, "ring-batch", tasks, producers, consumers);
+    printf("ring-1 moves one task per call; the server only uses batch calls (ring-batch)\n");
+    return rc ? 1 : 0;
+}
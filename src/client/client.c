@@ -31,6 +31,7 @@ SharedContext* manager_init() {
         return NULL;
     }
     pthread_mutex_init(&arg->mutex_ball, NULL);
+    arg->udp_fd = -1;
 
     return arg;
 }
@@ -102,6 +103,12 @@ void* socket_recv_thread(void* arg) {
             printf(COLOR_RED "[Warning] Received buffer is full. Data may be truncated!\n" COLOR_RESET);
         }
 
+        if (ctx->udp_fd >= 0) {
+            // 상태는 UDP로 받음: TCP로는 응답만 출력 (등록 전에 도착한 상태 프레임은 버림)
+            if (strchr(recv_buf, '|') == NULL) printf("%s", recv_buf);
+            continue;
+        }
+
         pthread_mutex_lock(&ctx->ball_list_manager->mutex_ball);
         updateBallListFromSerialized(ctx->ball_list_manager, recv_buf, ctx->framebuffer->vinfo.xres, ctx->framebuffer->vinfo.yres);
         pthread_mutex_unlock(&ctx->ball_list_manager->mutex_ball);
@@ -110,6 +117,76 @@ void* socket_recv_thread(void* arg) {
     pthread_exit(NULL);
 }
 
+// 서버 -> 클라이언트 UDP 상태 수신 스레드 : 가장 최신 시퀀스의 조각을 모두 모으면 적용
+void* udp_recv_thread(void* arg) {
+
+    SharedContext* ctx = (SharedContext*)arg;
+
+    char datagram[UDP_DATAGRAM_MAX + 1];
+    char* slots = NULL;         // 조각 하나당 UDP_DATAGRAM_MAX 바이트
+    int* slot_len = NULL;       // 받은 조각의 길이 (-1 = 아직 안 옴)
+    char* frame = NULL;         // 조각을 이어 붙인 상태 문자열
+    int capacity = 0;
+    unsigned long long assembling = 0, applied = 0;
+    int count = 0, received = 0;
+
+    while (keep_running)
+    {
+        ssize_t len = recv(ctx->udp_fd, datagram, UDP_DATAGRAM_MAX, 0);
+        if (len < 0) continue;      // 제한 시간 만료 (keep_running 확인)
+        datagram[len] = '\0';
+
+        unsigned long long seq;
+        int index, total, header;
+        if (sscanf(datagram, "S%llu %d/%d\n%n", &seq, &index, &total, &header) != 3) continue;
+        if (total <= 0 || total > UDP_MAX_FRAGMENTS || index < 0 || index >= total) continue;
+
+        // 이미 적용했거나 조립 중인 것보다 오래된 틱은 버림
+        if (seq <= applied || seq < assembling) continue;
+        if (seq > assembling) {
+            // 더 새로운 틱: 조립 중이던 틱은 포기하고 새로 시작
+            if (total > capacity) {
+                char* s = realloc(slots, (size_t)total * UDP_DATAGRAM_MAX);
+                if (s) slots = s;
+                int* l = realloc(slot_len, sizeof(int) * (size_t)total);
+                if (l) slot_len = l;
+                char* f = realloc(frame, (size_t)total * UDP_DATAGRAM_MAX + 1);
+                if (f) frame = f;
+                if (!s || !l || !f) continue;
+                capacity = total;
+            }
+            assembling = seq;
+            count = total;
+            received = 0;
+            for (int i = 0; i < count; i++) slot_len[i] = -1;
+        }
+        if (total != count || slot_len[index] >= 0) continue;   // 조각 수가 다르거나 중복
+
+        slot_len[index] = (int)len - header;
+        memcpy(slots + (size_t)index * UDP_DATAGRAM_MAX, datagram + header, (size_t)slot_len[index]);
+        if (++received < count) continue;
+
+        // 모든 조각 도착: 순서대로 이어 붙여 공 리스트 교체
+        size_t off = 0;
+        for (int i = 0; i < count; i++) {
+            memcpy(frame + off, slots + (size_t)i * UDP_DATAGRAM_MAX, (size_t)slot_len[i]);
+            off += (size_t)slot_len[i];
+        }
+        frame[off] = '\0';
+        applied = seq;
+
+        pthread_mutex_lock(&ctx->ball_list_manager->mutex_ball);
+        updateBallListFromSerialized(ctx->ball_list_manager, frame, ctx->framebuffer->vinfo.xres, ctx->framebuffer->vinfo.yres);
+        pthread_mutex_unlock(&ctx->ball_list_manager->mutex_ball);
+    }
+
+    free(slots);
+    free(slot_len);
+    free(frame);
+    printf(COLOR_GREEN "[Client] UDP Recv Thread Shutting down..." COLOR_RESET);
+    pthread_exit(NULL);
+}
+
 // 클라이언트 ->  서버 송신 스레드 : 입력  명령 받기 및 전송
 void* socket_send_thread(void* arg) {
 
@@ -144,7 +221,11 @@ void* socket_send_thread(void* arg) {
                 if (fgets(input, sizeof(input), stdin) == NULL) continue;
                 input[strcspn(input, "\n")] = '\0';
 
-                send(ctx->socket_fd, input, strlen(input), 0);
+                // 서버는 '\n'으로 명령을 구분하므로 줄 끝을 붙여 전송
+                size_t len = strlen(input);
+                input[len] = '\n';
+                send(ctx->socket_fd, input, len + 1, 0);
+                input[len] = '\0';
 
                 if(strcmp(input, "x") == 0) {
                     break;
@@ -152,7 +233,7 @@ void* socket_send_thread(void* arg) {
             }
         }
     }
-    send(ctx->socket_fd, "x", 1, 0);
+    send(ctx->socket_fd, "x\n", 2, 0);
     printf(COLOR_GREEN "[Client] Socket Send Thread Shutting down..." COLOR_RESET);
     pthread_exit(NULL);
 }
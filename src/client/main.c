@@ -27,7 +27,8 @@ int main(int argc, char **argv)
 {
   struct sockaddr_in servaddr;
 
-  pthread_t tid_render, tid_socket_send, tid_socket_recv;
+  pthread_t tid_render, tid_socket_send, tid_socket_recv, tid_udp_recv;
+  int udp_port = 0;
 
   SharedContext* arg = manager_init();
   if(arg == NULL)
@@ -40,10 +41,19 @@ int main(int argc, char **argv)
 
   // 서버 주소
   if (argc < 2) {
-    printf("Usage : %s <SERVER_IP>\n", argv[0]);
+    printf("Usage : %s <SERVER_IP> [UDP_PORT]\n", argv[0]);
     return -1;
   }
 
+  // 선택: 공 상태를 UDP로 받을 포트 (명령과 응답은 계속 TCP)
+  if (argc >= 3) {
+    udp_port = atoi(argv[2]);
+    if (udp_port <= 0 || udp_port > 65535) {
+      printf("Invalid UDP port: %s\n", argv[2]);
+      return -1;
+    }
+  }
+
   // 소켓 초기화
   if ((arg->socket_fd = socket(AF_INET, SOCK_STREAM, 0)) < 0) {
     perror("socket()");
@@ -65,6 +75,30 @@ int main(int argc, char **argv)
       return -1;
   }
 
+  if (udp_port > 0) {
+    struct sockaddr_in udpaddr;
+    struct timeval tv = { 0, UDP_RECV_TIMEOUT_MS * 1000 };
+    int rcvbuf = 1 << 20;   // 한 틱의 조각이 한꺼번에 도착하므로 수신 버퍼를 넉넉히
+
+    memset(&udpaddr, 0, sizeof(udpaddr));
+    udpaddr.sin_family = AF_INET;
+    udpaddr.sin_addr.s_addr = htonl(INADDR_ANY);
+    udpaddr.sin_port = htons(udp_port);
+
+    if ((arg->udp_fd = socket(AF_INET, SOCK_DGRAM, 0)) < 0 ||
+        bind(arg->udp_fd, (struct sockaddr*)&udpaddr, sizeof(udpaddr)) < 0) {
+      perror("UDP socket()/bind()");
+      return -1;
+    }
+    setsockopt(arg->udp_fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(arg->udp_fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+    // 서버에 포트 등록: 다음 틱부터 상태가 UDP로 옴
+    char reg[32];
+    int n = snprintf(reg, sizeof(reg), "u:%d\n", udp_port);
+    send(arg->socket_fd, reg, n, 0);
+  }
+
 
   // 키보드 입력 스레드 생성
   if(pthread_create(&tid_render, NULL, render_thread, arg) != 0)
@@ -93,9 +127,21 @@ int main(int argc, char **argv)
     return -1;
   }
 
+  // 서버 -> 클라이언트 UDP 상태 수신용 스레드
+  if(arg->udp_fd >= 0 && pthread_create(&tid_udp_recv, NULL, udp_recv_thread, arg) != 0)
+  {
+    perror("pthread_create()");
+    close(arg->udp_fd);
+    arg->udp_fd = -1;
+  }
+
   pthread_join(tid_render, NULL);
   pthread_join(tid_socket_recv, NULL);
   pthread_join(tid_socket_send, NULL);
+  if (arg->udp_fd >= 0) {
+    pthread_join(tid_udp_recv, NULL);
+    close(arg->udp_fd);
+  }
   
   shutdown(arg->socket_fd, SHUT_RDWR); //  소켓 읽기 쓰기 종료 신호
   close(arg->socket_fd);
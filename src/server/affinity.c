@@ -0,0 +1,181 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include "affinity.h"
+#include "console_color.h"
+
+static const char* role_names[ROLE_COUNT] = { "reactor", "worker", "sim", "fanout" };
+
+static cpu_set_t startup_mask;  // 프로세스 시작 시 허용된 CPU (affinity_unpin_self 에서 복원)
+static int startup_saved = 0;
+
+static inline int cpu_list_has(const CpuList* list, int cpu) {
+    return (list->mask[cpu / 64] >> (cpu % 64)) & 1;
+}
+
+static inline void cpu_list_add(CpuList* list, int cpu) {
+    if (!cpu_list_has(list, cpu)) {
+        list->mask[cpu / 64] |= 1ULL << (cpu % 64);
+        list->cpu_count++;
+    }
+}
+
+void affinity_layout_init(ThreadLayout* layout) {
+    memset(layout, 0, sizeof(ThreadLayout));
+    if (!startup_saved && sched_getaffinity(0, sizeof(startup_mask), &startup_mask) == 0) {
+        startup_saved = 1;
+    }
+}
+
+int affinity_parse(ThreadLayout* layout, const char* spec) {
+    const char* eq = strchr(spec, '=');
+    if (!eq) {
+        fprintf(stderr, "Invalid --affinity value (expected ROLE=CPULIST): %s\n", spec);
+        return -1;
+    }
+
+    int role = -1;
+    for (int r = 0; r < ROLE_COUNT; r++) {
+        if ((size_t)(eq - spec) == strlen(role_names[r]) && strncmp(spec, role_names[r], eq - spec) == 0) {
+            role = r;
+            break;
+        }
+    }
+    if (role < 0) {
+        fprintf(stderr, "Unknown --affinity role (reactor, worker, sim, fanout): %s\n", spec);
+        return -1;
+    }
+
+    // CPU 목록 파싱: "0-3,8,10-11"
+    CpuList list;
+    memset(&list, 0, sizeof(list));
+    const char* p = eq + 1;
+    while (*p) {
+        char* end;
+        long first = strtol(p, &end, 10);
+        if (end == p) break;
+        long last = first;
+        if (*end == '-') {
+            p = end + 1;
+            last = strtol(p, &end, 10);
+            if (end == p) break;
+        }
+        if (first < 0 || last < first || last >= AFFINITY_MAX_CPUS) break;
+        for (long cpu = first; cpu <= last; cpu++) {
+            if (startup_saved && !CPU_ISSET((int)cpu, &startup_mask)) {
+                fprintf(stderr, "CPU %ld is not available to the server (--affinity %s)\n", cpu, spec);
+                return -1;
+            }
+            cpu_list_add(&list, (int)cpu);
+        }
+        p = end;
+        if (*p == ',') p++;
+        else if (*p != '\0') break;
+    }
+    if (*p != '\0' || list.cpu_count == 0) {
+        fprintf(stderr, "Invalid --affinity CPU list: %s\n", spec);
+        return -1;
+    }
+
+    layout->roles[role] = list;
+    return 0;
+}
+
+int affinity_pin_self(const ThreadLayout* layout, ThreadRole role) {
+    const CpuList* list = &layout->roles[role];
+    if (list->cpu_count == 0) return 0;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu = 0; cpu < AFFINITY_MAX_CPUS && cpu < CPU_SETSIZE; cpu++) {
+        if (cpu_list_has(list, cpu)) CPU_SET(cpu, &set);
+    }
+
+    int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (rc != 0) {
+        errno = rc;
+        perror(COLOR_RED "[Affinity] pthread_setaffinity_np" COLOR_RESET);
+        return -1;
+    }
+    return 0;
+}
+
+int affinity_unpin_self(void) {
+    if (!startup_saved) return 0;
+    int rc = pthread_setaffinity_np(pthread_self(), sizeof(startup_mask), &startup_mask);
+    if (rc != 0) {
+        errno = rc;
+        perror(COLOR_RED "[Affinity] pthread_setaffinity_np" COLOR_RESET);
+        return -1;
+    }
+    return 0;
+}
+
+// sysfs의 cpuN/nodeM 링크로 CPU가 속한 NUMA 노드 확인 (없으면 -1)
+static int cpu_numa_node(int cpu) {
+    char path[64];
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d", cpu);
+    DIR* dir = opendir(path);
+    if (!dir) return -1;
+
+    int node = -1;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (strncmp(entry->d_name, "node", 4) == 0 && entry->d_name[4] >= '0' && entry->d_name[4] <= '9') {
+            node = atoi(entry->d_name + 4);
+            break;
+        }
+    }
+    closedir(dir);
+    return node;
+}
+
+// CPU 집합을 "0-3,8" 형태로 출력
+static void print_cpu_list(const CpuList* list) {
+    int first = 1;
+    for (int cpu = 0; cpu < AFFINITY_MAX_CPUS; cpu++) {
+        if (!cpu_list_has(list, cpu)) continue;
+        int last = cpu;
+        while (last + 1 < AFFINITY_MAX_CPUS && cpu_list_has(list, last + 1)) last++;
+        if (last == cpu) printf("%s%d", first ? "" : ",", cpu);
+        else printf("%s%d-%d", first ? "" : ",", cpu, last);
+        first = 0;
+        cpu = last;
+    }
+}
+
+void affinity_report(const ThreadLayout* layout) {
+    printf(COLOR_BLUE "[Affinity] Thread layout" COLOR_RESET);
+    for (int r = 0; r < ROLE_COUNT; r++) {
+        const CpuList* list = &layout->roles[r];
+        printf("  %-8s: ", role_names[r]);
+        if (list->cpu_count == 0) {
+            printf("unpinned\n");
+            continue;
+        }
+
+        printf("cpus ");
+        print_cpu_list(list);
+
+        // 역할이 걸친 NUMA 노드 (sysfs에 노드 정보가 없으면 생략)
+        unsigned long long nodes = 0;
+        for (int cpu = 0; cpu < AFFINITY_MAX_CPUS; cpu++) {
+            if (!cpu_list_has(list, cpu)) continue;
+            int node = cpu_numa_node(cpu);
+            if (node >= 0 && node < 64) nodes |= 1ULL << node;
+        }
+        if (nodes) {
+            printf(" (node");
+            for (int n = 0; n < 64; n++) {
+                if (nodes & (1ULL << n)) printf(" %d", n);
+            }
+            printf(")");
+        }
+        printf("\n");
+    }
+}
@@ -0,0 +1,236 @@
+#include <pthread.h>
+#include "ball_kernel.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BALL_KERNEL_X86 1
+#endif
+
+void move_balls_scalar(BallList* list, int begin, int end) {
+    uint16_t* x = list->x;
+    uint16_t* y = list->y;
+    int16_t* dx = list->dx;
+    int16_t* dy = list->dy;
+    const uint8_t* radius = list->radius;
+    const uint16_t* owner = list->owner_id;
+    const int* level = list->owner_speed_level;
+    int scaled = list->scaled_owners > 0;
+
+    // Q10.6 좌표를 int32로 넓혀 계산 (속도는 정수 단위이므로 << 6)
+    for (int i = begin; i < end; i++) {
+        int lo = radius[i] << BALL_FIXED_SHIFT;
+        int hi = BALL_WORLD_FIXED - lo;
+
+        // 소유자 속도 단계를 적용한 실제 속도 (반사 시 부호만 바뀜)
+        int vx = scaled ? scaleSpeed(dx[i], level[owner[i]]) : dx[i];
+        int vy = scaled ? scaleSpeed(dy[i], level[owner[i]]) : dy[i];
+        int px = x[i] + (vx << BALL_FIXED_SHIFT);
+        int py = y[i] + (vy << BALL_FIXED_SHIFT);
+
+        // 좌우 경계 반사 처리
+        if (px <= lo || px >= hi) {
+            dx[i] = -dx[i];
+            px -= vx << BALL_FIXED_SHIFT;  // 반사 후 한 칸 이동
+        }
+
+        // 상하 경계 반사 처리
+        if (py <= lo || py >= hi) {
+            dy[i] = -dy[i];
+            py -= vy << BALL_FIXED_SHIFT;
+        }
+
+        x[i] = (uint16_t)px;
+        y[i] = (uint16_t)py;
+    }
+}
+
+#ifdef BALL_KERNEL_X86
+
+// 부호 있는 int32 4개를 uint16으로 변환 (SSE2에는 packus_epi32가 없으므로
+// 32768을 빼서 packs_epi32로 포화 변환한 뒤 부호 비트를 뒤집어 되돌림)
+static inline __m128i pack_u16_sse2(__m128i a, __m128i b) {
+    const __m128i bias32 = _mm_set1_epi32(32768);
+    const __m128i bias16 = _mm_set1_epi16((short)0x8000);
+    __m128i p = _mm_packs_epi32(_mm_sub_epi32(a, bias32), _mm_sub_epi32(b, bias32));
+    return _mm_xor_si128(p, bias16);
+}
+
+// 한 축(x 또는 y)에 대해 4개 공 이동 + 경계 반사 (분기 없이 마스크 사용)
+// vel은 저장된 기본 속도, eff는 소유자 속도 단계가 적용된 실제 속도
+static inline void move_axis_sse2(__m128i* pos, __m128i* vel, __m128i eff, __m128i lo, __m128i hi) {
+    __m128i p = _mm_add_epi32(*pos, _mm_slli_epi32(eff, BALL_FIXED_SHIFT));
+
+    // p <= lo  ||  p >= hi
+    __m128i mask = _mm_or_si128(_mm_cmpgt_epi32(_mm_add_epi32(lo, _mm_set1_epi32(1)), p),
+                                _mm_cmpgt_epi32(p, _mm_sub_epi32(hi, _mm_set1_epi32(1))));
+
+    // 반사된 공만 속도 부호 반전
+    __m128i neg = _mm_sub_epi32(_mm_setzero_si128(), *vel);
+    __m128i v = _mm_or_si128(_mm_and_si128(mask, neg), _mm_andnot_si128(mask, *vel));
+
+    // 반사된 공만 한 칸 되돌아 이동
+    p = _mm_sub_epi32(p, _mm_and_si128(mask, _mm_slli_epi32(eff, BALL_FIXED_SHIFT)));
+
+    *pos = p;
+    *vel = v;
+}
+
+// 소유자 속도 단계 적용 (SSE2에는 가변 시프트가 없으므로 2^level 배율을 float로 곱함):
+// sign(v) * clamp(trunc(|v| * scale), 1, MAX_SPEED), v == 0이면 0. |v| * 2^11 < 2^24 이므로 정확함
+static inline __m128i scale_speed_sse2(__m128i vel, __m128 scale) {
+    __m128i sgn = _mm_srai_epi32(vel, 31);
+    __m128i a = _mm_sub_epi32(_mm_xor_si128(vel, sgn), sgn);
+    __m128 af = _mm_mul_ps(_mm_cvtepi32_ps(a), scale);
+    af = _mm_min_ps(_mm_max_ps(af, _mm_set1_ps(1.0f)), _mm_set1_ps((float)MAX_SPEED));
+    a = _mm_sub_epi32(_mm_xor_si128(_mm_cvttps_epi32(af), sgn), sgn);
+    return _mm_andnot_si128(_mm_cmpeq_epi32(vel, _mm_setzero_si128()), a);
+}
+
+// 8개 공의 한 축: uint16/int16을 int32 두 묶음으로 넓혀 이동 후 다시 좁힘
+static inline void move_axis8_sse2(uint16_t* p, int16_t* v, int scaled, __m128 scale0, __m128 scale1,
+                                   __m128i lo0, __m128i hi0, __m128i lo1, __m128i hi1) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i pos16 = _mm_loadu_si128((const __m128i*)p);
+    __m128i vel16 = _mm_loadu_si128((const __m128i*)v);
+
+    __m128i pos0 = _mm_unpacklo_epi16(pos16, zero);
+    __m128i pos1 = _mm_unpackhi_epi16(pos16, zero);
+    __m128i vel0 = _mm_srai_epi32(_mm_unpacklo_epi16(vel16, vel16), 16);
+    __m128i vel1 = _mm_srai_epi32(_mm_unpackhi_epi16(vel16, vel16), 16);
+    __m128i eff0 = scaled ? scale_speed_sse2(vel0, scale0) : vel0;
+    __m128i eff1 = scaled ? scale_speed_sse2(vel1, scale1) : vel1;
+
+    move_axis_sse2(&pos0, &vel0, eff0, lo0, hi0);
+    move_axis_sse2(&pos1, &vel1, eff1, lo1, hi1);
+
+    _mm_storeu_si128((__m128i*)p, pack_u16_sse2(pos0, pos1));
+    _mm_storeu_si128((__m128i*)v, _mm_packs_epi32(vel0, vel1));
+}
+
+void move_balls_sse2(BallList* list, int begin, int end) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i world = _mm_set1_epi32(BALL_WORLD_FIXED);
+    const float* sc = list->owner_speed_scale;
+    const uint16_t* o = list->owner_id;
+    int scaled = list->scaled_owners > 0;
+    int i = begin;
+
+    for (; i + 8 <= end; i += 8) {
+        __m128i r16 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(list->radius + i)), zero);
+        __m128i lo0 = _mm_slli_epi32(_mm_unpacklo_epi16(r16, zero), BALL_FIXED_SHIFT);
+        __m128i lo1 = _mm_slli_epi32(_mm_unpackhi_epi16(r16, zero), BALL_FIXED_SHIFT);
+        __m128i hi0 = _mm_sub_epi32(world, lo0);
+        __m128i hi1 = _mm_sub_epi32(world, lo1);
+
+        // 소유자별 배율 모으기 (SSE2에는 gather가 없으므로 스칼라 로드)
+        __m128 scale0 = _mm_setzero_ps(), scale1 = _mm_setzero_ps();
+        if (scaled) {
+            scale0 = _mm_set_ps(sc[o[i + 3]], sc[o[i + 2]], sc[o[i + 1]], sc[o[i]]);
+            scale1 = _mm_set_ps(sc[o[i + 7]], sc[o[i + 6]], sc[o[i + 5]], sc[o[i + 4]]);
+        }
+
+        move_axis8_sse2(list->x + i, list->dx + i, scaled, scale0, scale1, lo0, hi0, lo1, hi1);
+        move_axis8_sse2(list->y + i, list->dy + i, scaled, scale0, scale1, lo0, hi0, lo1, hi1);
+    }
+
+    move_balls_scalar(list, i, end);
+}
+
+// 소유자 속도 단계 적용: sign(v) * clamp(|v| << left >> right, 1, MAX_SPEED), v == 0이면 0
+__attribute__((target("avx2")))
+static inline __m256i scale_speed_avx2(__m256i vel, __m256i left, __m256i right) {
+    __m256i a = _mm256_srlv_epi32(_mm256_sllv_epi32(_mm256_abs_epi32(vel), left), right);
+    a = _mm256_max_epi32(_mm256_min_epi32(a, _mm256_set1_epi32(MAX_SPEED)), _mm256_set1_epi32(1));
+    return _mm256_sign_epi32(a, vel);
+}
+
+__attribute__((target("avx2")))
+static inline void move_axis_avx2(uint16_t* p, int16_t* v, __m256i lo, __m256i hi,
+                                  int scaled, __m256i left, __m256i right) {
+    __m256i pos = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)p));
+    __m256i vel = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)v));
+    __m256i eff = scaled ? scale_speed_avx2(vel, left, right) : vel;
+
+    pos = _mm256_add_epi32(pos, _mm256_slli_epi32(eff, BALL_FIXED_SHIFT));
+
+    // pos <= lo  ||  pos >= hi
+    __m256i mask = _mm256_or_si256(_mm256_cmpgt_epi32(_mm256_add_epi32(lo, _mm256_set1_epi32(1)), pos),
+                                   _mm256_cmpgt_epi32(pos, _mm256_sub_epi32(hi, _mm256_set1_epi32(1))));
+
+    // 반사된 공만 속도 부호 반전
+    __m256i neg = _mm256_sub_epi32(_mm256_setzero_si256(), vel);
+    vel = _mm256_blendv_epi8(vel, neg, mask);
+
+    // 반사된 공만 한 칸 되돌아 이동
+    pos = _mm256_sub_epi32(pos, _mm256_and_si256(mask, _mm256_slli_epi32(eff, BALL_FIXED_SHIFT)));
+
+    // 128비트 레인별로 좁힌 뒤 (0, 2) 64비트 묶음을 모아 하위 128비트에 저장
+    __m256i pos16 = _mm256_permute4x64_epi64(_mm256_packus_epi32(pos, pos), 0x08);
+    __m256i vel16 = _mm256_permute4x64_epi64(_mm256_packs_epi32(vel, vel), 0x08);
+    _mm_storeu_si128((__m128i*)p, _mm256_castsi256_si128(pos16));
+    _mm_storeu_si128((__m128i*)v, _mm256_castsi256_si128(vel16));
+}
+
+__attribute__((target("avx2")))
+void move_balls_avx2(BallList* list, int begin, int end) {
+    const __m256i world = _mm256_set1_epi32(BALL_WORLD_FIXED);
+    const __m256i zero = _mm256_setzero_si256();
+    int scaled = list->scaled_owners > 0;
+    int i = begin;
+
+    for (; i + 8 <= end; i += 8) {
+        __m256i lo = _mm256_slli_epi32(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(list->radius + i))),
+                                       BALL_FIXED_SHIFT);
+        __m256i hi = _mm256_sub_epi32(world, lo);
+
+        // 소유자별 속도 단계를 gather 한 뒤 왼쪽/오른쪽 시프트 양으로 분리
+        __m256i left = zero, right = zero;
+        if (scaled) {
+            __m256i owner = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(list->owner_id + i)));
+            __m256i level = _mm256_i32gather_epi32(list->owner_speed_level, owner, 4);
+            left = _mm256_max_epi32(level, zero);
+            right = _mm256_max_epi32(_mm256_sub_epi32(zero, level), zero);
+        }
+
+        move_axis_avx2(list->x + i, list->dx + i, lo, hi, scaled, left, right);
+        move_axis_avx2(list->y + i, list->dy + i, lo, hi, scaled, left, right);
+    }
+
+    move_balls_scalar(list, i, end);
+}
+
+#else
+
+void move_balls_sse2(BallList* list, int begin, int end) {
+    move_balls_scalar(list, begin, end);
+}
+
+void move_balls_avx2(BallList* list, int begin, int end) {
+    move_balls_scalar(list, begin, end);
+}
+
+#endif
+
+static MoveKernel selected_kernel = move_balls_scalar;
+static const char* selected_name = "scalar";
+static pthread_once_t kernel_once = PTHREAD_ONCE_INIT;
+
+// CPUID로 사용 가능한 가장 넓은 커널 선택 (최초 1회)
+static void select_kernel(void) {
+#ifdef BALL_KERNEL_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        selected_kernel = move_balls_avx2;
+        selected_name = "avx2";
+    } else if (__builtin_cpu_supports("sse2")) {
+        selected_kernel = move_balls_sse2;
+        selected_name = "sse2";
+    }
+#endif
+    printf(COLOR_BLUE "[Kernel] Ball integration kernel: %s" COLOR_RESET, selected_name);
+}
+
+void move_balls(BallList* list, int begin, int end) {
+    pthread_once(&kernel_once, select_kernel);
+    selected_kernel(list, begin, end);
+}
@@ -0,0 +1,150 @@
+#include <stdlib.h>
+#include <string.h>
+#include "buffer_slab.h"
+
+#define SLAB_RING_MASK (SLAB_CLASS_MAX_BUFFERS - 1)
+#define SLAB_CLASS_HEAP 0xFFu   // 슬랩 한도를 넘어 malloc()으로 받은 버퍼
+
+#if (SLAB_CLASS_MAX_BUFFERS & SLAB_RING_MASK) != 0
+#error "SLAB_CLASS_MAX_BUFFERS must be a power of two"
+#endif
+
+// 크기 등급별 사용 가능 바이트 (마지막 등급은 recv 한 번의 최대 크기 + '\0')
+static const size_t slab_class_sizes[SLAB_CLASS_COUNT] = { 64, 256, 1024, BUFSIZ + 1 };
+
+// 버퍼 앞 헤더에 등급 기록
+static inline char* tag_buffer(char* raw, uint32_t cls) {
+    memcpy(raw, &cls, sizeof(cls));
+    return raw + SLAB_HEADER_SIZE;
+}
+
+static inline uint32_t buffer_class(const char* buf) {
+    uint32_t cls;
+    memcpy(&cls, buf - SLAB_HEADER_SIZE, sizeof(cls));
+    return cls;
+}
+
+// 빈 버퍼 링에 넣기 (링이 가득 차면 0)
+static int ring_push(SlabClass* c, char* buf) {
+    uint32_t pos = __atomic_load_n(&c->push_pos, __ATOMIC_RELAXED);
+    for (;;) {
+        uint32_t seq = __atomic_load_n(&c->seq[pos & SLAB_RING_MASK], __ATOMIC_ACQUIRE);
+        int32_t diff = (int32_t)(seq - pos);
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&c->push_pos, &pos, pos + 1, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) break;
+        } else if (diff < 0) {
+            return 0;
+        } else {
+            pos = __atomic_load_n(&c->push_pos, __ATOMIC_RELAXED);
+        }
+    }
+    c->slots[pos & SLAB_RING_MASK] = buf;
+    __atomic_store_n(&c->seq[pos & SLAB_RING_MASK], pos + 1, __ATOMIC_RELEASE);
+    return 1;
+}
+
+// 빈 버퍼 링에서 꺼내기 (비어 있으면 NULL)
+static char* ring_pop(SlabClass* c) {
+    uint32_t pos = __atomic_load_n(&c->pop_pos, __ATOMIC_RELAXED);
+    for (;;) {
+        uint32_t seq = __atomic_load_n(&c->seq[pos & SLAB_RING_MASK], __ATOMIC_ACQUIRE);
+        int32_t diff = (int32_t)(seq - (pos + 1));
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&c->pop_pos, &pos, pos + 1, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) break;
+        } else if (diff < 0) {
+            return NULL;
+        } else {
+            pos = __atomic_load_n(&c->pop_pos, __ATOMIC_RELAXED);
+        }
+    }
+    char* buf = c->slots[pos & SLAB_RING_MASK];
+    __atomic_store_n(&c->seq[pos & SLAB_RING_MASK], pos + SLAB_CLASS_MAX_BUFFERS, __ATOMIC_RELEASE);
+    return buf;
+}
+
+void buffer_slab_init(BufferSlab* slab) {
+    memset(slab, 0, sizeof(BufferSlab));
+    for (int k = 0; k < SLAB_CLASS_COUNT; k++) {
+        SlabClass* c = &slab->classes[k];
+        c->buffer_size = slab_class_sizes[k];
+        for (uint32_t i = 0; i < SLAB_CLASS_MAX_BUFFERS; i++) c->seq[i] = i;
+        pthread_mutex_init(&c->grow_mutex, NULL);
+    }
+}
+
+// 청크 하나를 할당해 버퍼로 나누고, 하나는 반환하고 나머지는 링에 넣음
+static char* slab_grow(SlabClass* c, uint32_t cls) {
+    pthread_mutex_lock(&c->grow_mutex);
+
+    // 잠금을 기다리는 사이 다른 스레드가 이미 채웠을 수 있음
+    char* buf = ring_pop(c);
+    if (buf || c->owned + SLAB_CHUNK_BUFFERS > SLAB_CLASS_MAX_BUFFERS) {
+        pthread_mutex_unlock(&c->grow_mutex);
+        return buf;
+    }
+
+    size_t stride = SLAB_HEADER_SIZE + ((c->buffer_size + 7) & ~(size_t)7);
+    void** chunks = (void**)realloc(c->chunks, sizeof(void*) * (size_t)(c->chunk_count + 1));
+    char* chunk = (char*)malloc(stride * SLAB_CHUNK_BUFFERS);
+    if (chunks) c->chunks = chunks;
+    if (!chunks || !chunk) {
+        free(chunk);
+        pthread_mutex_unlock(&c->grow_mutex);
+        return NULL;
+    }
+    c->chunks[c->chunk_count++] = chunk;
+    c->owned += SLAB_CHUNK_BUFFERS;
+
+    buf = tag_buffer(chunk, cls);
+    for (int i = 1; i < SLAB_CHUNK_BUFFERS; i++) {
+        ring_push(c, tag_buffer(chunk + stride * (size_t)i, cls));
+    }
+
+    pthread_mutex_unlock(&c->grow_mutex);
+    return buf;
+}
+
+char* buffer_slab_alloc(BufferSlab* slab, size_t size) {
+    uint32_t cls = 0;
+    while (cls < SLAB_CLASS_COUNT && slab->classes[cls].buffer_size < size) cls++;
+
+    if (cls < SLAB_CLASS_COUNT) {
+        SlabClass* c = &slab->classes[cls];
+        char* buf = ring_pop(c);
+        if (!buf) buf = slab_grow(c, cls);
+        if (buf) return buf;
+    }
+
+    // 등급보다 크거나 등급이 한도에 도달한 경우
+    char* raw = (char*)malloc(SLAB_HEADER_SIZE + size);
+    if (!raw) {
+        perror(COLOR_RED "[Error] Buffer allocation failed" COLOR_RESET);
+        return NULL;
+    }
+    return tag_buffer(raw, SLAB_CLASS_HEAP);
+}
+
+void buffer_slab_free(BufferSlab* slab, char* buf) {
+    if (!buf) return;
+    uint32_t cls = buffer_class(buf);
+    if (cls == SLAB_CLASS_HEAP) {
+        free(buf - SLAB_HEADER_SIZE);
+        return;
+    }
+    // 등급이 가진 버퍼 수가 링 크기를 넘지 않으므로 항상 들어감
+    ring_push(&slab->classes[cls], buf);
+}
+
+void buffer_slab_destroy(BufferSlab* slab) {
+    for (int k = 0; k < SLAB_CLASS_COUNT; k++) {
+        SlabClass* c = &slab->classes[k];
+        for (int i = 0; i < c->chunk_count; i++) free(c->chunks[i]);
+        free(c->chunks);
+        c->chunks = NULL;
+        c->chunk_count = 0;
+        c->owned = 0;
+        pthread_mutex_destroy(&c->grow_mutex);
+    }
+}
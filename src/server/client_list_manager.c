@@ -1,132 +1,147 @@
-
 #include "client_list_manager.h"
 
-SocketContext create_client(int csock, struct sockaddr_in cliaddr)
+SocketContext create_client(int csock, struct sockaddr_in cliaddr, int epoll_fd)
 {
     SocketContext s;
     s.csock = csock;
     s.cliaddr= cliaddr;
+    s.epoll_fd = epoll_fd;
+    s.udp_port = 0;     // "u:<port>"를 보내기 전까지는 TCP로 상태 수신
     return s;
 }
 
-ClientNode* create_client_node(SocketContext ctx) {
-    ClientNode* node = (ClientNode*)malloc(sizeof(ClientNode));
-    if (!node) return NULL;
-    node->ctx = ctx;
-    node->next = NULL;
-    return node;
+// fd 인덱스가 fd를 담을 수 있도록 확장 (새 항목은 -1)
+static int reserve_fd_index(ClientListManager* manager, int fd) {
+    if (fd < manager->fd_capacity) return 0;
+
+    int cap = manager->fd_capacity > 0 ? manager->fd_capacity : CLIENT_TABLE_INIT_CAPACITY;
+    while (cap <= fd) cap *= 2;
+
+    int* slots = (int*)realloc(manager->slot_of_fd, sizeof(int) * (size_t)cap);
+    if (!slots) return -1;
+    for (int i = manager->fd_capacity; i < cap; i++) slots[i] = -1;
+
+    manager->slot_of_fd = slots;
+    manager->fd_capacity = cap;
+    return 0;
+}
+
+// 밀집 배열에 한 명 더 넣을 공간 확보 (max_clients 까지)
+static int reserve_client_slot(ClientListManager* manager) {
+    if (manager->client_count < manager->client_capacity) return 0;
+
+    int cap = manager->client_capacity > 0 ? manager->client_capacity * 2 : CLIENT_TABLE_INIT_CAPACITY;
+    if (cap > manager->max_clients) cap = manager->max_clients;
+
+    SocketContext* clients = (SocketContext*)realloc(manager->clients, sizeof(SocketContext) * (size_t)cap);
+    if (!clients) return -1;
+
+    manager->clients = clients;
+    manager->client_capacity = cap;
+    return 0;
 }
 
-ClientNode* append_client(ClientNode* head, ClientNode** tail, SocketContext ctx) {
+int add_client(ClientListManager* manager, int csock, struct sockaddr_in cliaddr, int epoll_fd) {
+    if (csock < 0) return -1;
+
+    if (manager->client_count >= manager->max_clients) {
+        printf(COLOR_YELLOW "[Warning] Client table full (%d clients), socket %d refused." COLOR_RESET,
+               manager->max_clients, csock);
+        return -1;
+    }
 
-    ClientNode* newnode = NULL;
-    if((newnode =create_client_node(ctx)) == NULL)
+    if (reserve_fd_index(manager, csock) < 0 || reserve_client_slot(manager) < 0) {
         perror( COLOR_RED "[Error] Memory allocation failed" COLOR_RESET);
+        return -1;
+    }
 
-    if (head == NULL) {
-        head = newnode;
-        *tail = newnode;
-    } else {
-        (*tail)->next = newnode;
-        *tail = newnode;
+    if (manager->slot_of_fd[csock] >= 0) {
+        printf(COLOR_YELLOW "[Warning] Client with socket %d already registered." COLOR_RESET, csock);
+        return -1;
     }
 
-    printf( COLOR_GREEN "[Success] client(soket : %d) added successfully." COLOR_RESET, ctx.csock);
+    int slot = manager->client_count++;
+    manager->clients[slot] = create_client(csock, cliaddr, epoll_fd);
+    manager->slot_of_fd[csock] = slot;
 
-    return head;
+    printf( COLOR_GREEN "[Success] client(soket : %d) added successfully." COLOR_RESET, csock);
+    return 0;
 }
 
-void add_client(ClientListManager* manager, int csock, struct sockaddr_in cliaddr) {
-    SocketContext s = create_client(csock, cliaddr);
-    manager->head = append_client(manager->head, &manager->tail, s);
+SocketContext* find_client(ClientListManager* manager, int socket_fd) {
+    if (socket_fd < 0 || socket_fd >= manager->fd_capacity) return NULL;
+    int slot = manager->slot_of_fd[socket_fd];
+    return (slot >= 0) ? &manager->clients[slot] : NULL;
 }
 
-ClientNode* remove_client_by_socket(int socket_fd, ClientNode** head, ClientNode** tail) {
-    if (*head == NULL) return NULL;
-
-    ClientNode* cur = *head;
-    ClientNode* prev = NULL;
-
-    while (cur) {
-        if (cur->ctx.csock == socket_fd) {
-            if (prev == NULL) {
-                // 첫 번째 노드를 제거
-                *head = cur->next;
-                if (*tail == cur) *tail = NULL; // 유일한 노드였을 때
-            } else {
-                // 중간 또는 마지막 노드를 제거
-                prev->next = cur->next;
-                if (*tail == cur) *tail = prev;
-            }
-
-            printf(COLOR_GREEN "[Success] Client (socket: %d) removed by socket.\n" COLOR_RESET, socket_fd);
-            return cur; // 호출자가 free() 해야 함
-        }
-
-        prev = cur;
-        cur = cur->next;
+int remove_client_by_socket(ClientListManager* manager, int socket_fd, SocketContext* removed) {
+    SocketContext* client = find_client(manager, socket_fd);
+    if (!client) {
+        printf(COLOR_YELLOW "[Warning] Client with socket %d not found." COLOR_RESET, socket_fd);
+        return 0;
+    }
+
+    int slot = manager->slot_of_fd[socket_fd];
+    int last = --manager->client_count;
+    if (removed) *removed = *client;
+
+    // 마지막 클라이언트를 빈 자리로 옮김
+    if (slot != last) {
+        manager->clients[slot] = manager->clients[last];
+        manager->slot_of_fd[manager->clients[slot].csock] = slot;
     }
+    manager->slot_of_fd[socket_fd] = -1;
 
-    printf(COLOR_YELLOW "[Warning] Client with socket %d not found.\n" COLOR_RESET, socket_fd);
-    return NULL;
+    printf(COLOR_GREEN "[Success] Client (socket: %d) removed by socket." COLOR_RESET, socket_fd);
+    return 1;
 }
 
 
-void client_list_manager_init(ClientListManager* manager) {
+void client_list_manager_init(ClientListManager* manager, int max_clients) {
 
     memset(manager, 0,sizeof(ClientListManager));
-    manager->head = NULL;
-    manager->tail = NULL;
+    if (max_clients < 1) max_clients = 1;
+    if (max_clients > CLIENT_TABLE_MAX_CLIENTS) max_clients = CLIENT_TABLE_MAX_CLIENTS;
+    manager->max_clients = max_clients;
     pthread_mutex_init(&manager->mutex_client, NULL);
-    manager->client_count = 0;
 }
 
 void client_list_manager_destroy(ClientListManager* manager) {
-    pthread_mutex_destroy(&manager->mutex_client);
-    printf( COLOR_GREEN "Mutex 'mutex_client' has been destroyed." COLOR_RESET);
-    free_client_list(&manager->head);
-}
-
-void free_client_list(ClientNode** head) {
-    ClientNode* cur = *head;
-    while (cur != NULL) {
-        ClientNode* tmp = cur;
-        cur = cur->next;
-
+    for (int i = 0; i < manager->client_count; i++) {
         // 소켓 정리
-        if (tmp->ctx.csock > 0) {
-            shutdown(tmp->ctx.csock,SHUT_RDWR);
-            close(tmp->ctx.csock);
-            printf(COLOR_BLUE "[Closed] socket fd %d\n" COLOR_RESET, tmp->ctx.csock);
-        }
-
-        free(tmp);
+        int fd = manager->clients[i].csock;
+        shutdown(fd, SHUT_RDWR);
+        close(fd);
+        printf(COLOR_BLUE "[Closed] socket fd %d\n" COLOR_RESET, fd);
     }
-    *head = NULL;
-    printf(COLOR_GREEN "Freed memory of the client linked list." COLOR_RESET);
-}
+    free(manager->clients);
+    free(manager->slot_of_fd);
+    manager->clients = NULL;
+    manager->slot_of_fd = NULL;
+    manager->client_count = 0;
+    manager->client_capacity = 0;
+    manager->fd_capacity = 0;
+    printf(COLOR_GREEN "Freed memory of the client table." COLOR_RESET);
 
+    pthread_mutex_destroy(&manager->mutex_client);
+    printf( COLOR_GREEN "Mutex 'mutex_client' has been destroyed." COLOR_RESET);
+}
 
 
-void print_clients(ClientNode* head) {
 
-    int i = 0;
+void print_clients(const ClientListManager* manager) {
 
-    if(!head)
+    if(manager->client_count == 0)
     {
         printf(COLOR_YELLOW "\nNo data available.\n\n" COLOR_RESET);
         return;
     }
 
-    ClientNode *cur = head;
-
     printf("\n................................... \n");
-    while (cur)
+    for (int i = 0; i < manager->client_count; i++)
     {
-        printf("client socket fd : %d\n", cur->ctx.csock);
-        cur = cur->next;
-        i++;
+        printf("client socket fd : %d\n", manager->clients[i].csock);
     }
-    printf("\ntotal : %d\n",i);
+    printf("\ntotal : %d\n", manager->client_count);
     printf("................................... \n\n");
 }
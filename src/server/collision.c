@@ -0,0 +1,298 @@
+#include <math.h>
+#include "collision.h"
+
+void collision_grid_init(CollisionGrid* grid) {
+    memset(grid, 0, sizeof(CollisionGrid));
+}
+
+void collision_grid_destroy(CollisionGrid* grid) {
+    free(grid->cell_start);
+    free(grid->ball_cell);
+    free(grid->sorted_index);
+    free(grid->sorted_x);
+    free(grid->sorted_y);
+    free(grid->sorted_r);
+    free(grid->sorted_dx);
+    free(grid->sorted_dy);
+    memset(grid, 0, sizeof(CollisionGrid));
+}
+
+// 공 개수/셀 개수에 맞게 작업 배열 확장
+static int grid_reserve(CollisionGrid* grid, int balls, int cells) {
+    if (balls > grid->ball_capacity) {
+        int cap = grid->ball_capacity > 0 ? grid->ball_capacity : BALL_LIST_INIT_CAPACITY;
+        while (cap < balls) cap *= 2;
+
+        int* cell = (int*)realloc(grid->ball_cell, sizeof(int) * (size_t)cap);
+        if (cell) grid->ball_cell = cell;
+        int* idx = (int*)realloc(grid->sorted_index, sizeof(int) * (size_t)cap);
+        if (idx) grid->sorted_index = idx;
+        float* sx = (float*)realloc(grid->sorted_x, sizeof(float) * (size_t)cap);
+        if (sx) grid->sorted_x = sx;
+        float* sy = (float*)realloc(grid->sorted_y, sizeof(float) * (size_t)cap);
+        if (sy) grid->sorted_y = sy;
+        float* sr = (float*)realloc(grid->sorted_r, sizeof(float) * (size_t)cap);
+        if (sr) grid->sorted_r = sr;
+        int* sdx = (int*)realloc(grid->sorted_dx, sizeof(int) * (size_t)cap);
+        if (sdx) grid->sorted_dx = sdx;
+        int* sdy = (int*)realloc(grid->sorted_dy, sizeof(int) * (size_t)cap);
+        if (sdy) grid->sorted_dy = sdy;
+
+        if (!cell || !idx || !sx || !sy || !sr || !sdx || !sdy) return -1;
+        grid->ball_capacity = cap;
+    }
+
+    if (cells + 1 > grid->cell_capacity) {
+        int* start = (int*)realloc(grid->cell_start, sizeof(int) * (size_t)(cells + 1));
+        if (!start) return -1;
+        grid->cell_start = start;
+        grid->cell_capacity = cells + 1;
+    }
+    return 0;
+}
+
+static inline int clamp_cell(float pos, float cell_size, int limit) {
+    int c = (int)(pos / cell_size);
+    if (c < 0) return 0;
+    if (c >= limit) return limit - 1;
+    return c;
+}
+
+static inline int round_velocity(float v) {
+    int r = (int)(v + (v >= 0.0f ? 0.5f : -0.5f));
+    if (r == 0) return (v >= 0.0f) ? 1 : -1;    // 속도 0인 공은 다시 움직이지 않으므로 최소 크기 1 유지
+    if (r > MAX_SPEED) return MAX_SPEED;
+    if (r < MIN_SPEED) return MIN_SPEED;
+    return r;
+}
+
+static inline float clamp_position(float pos, float radius) {
+    if (pos < radius) return radius;
+    if (pos > WORLD_SIZE - radius) return WORLD_SIZE - radius;
+    return pos;
+}
+
+// 계수 정렬로 셀 단위 그리드 재구성
+static int grid_rebuild(CollisionGrid* grid, const BallList* list) {
+    int n = list->count;
+    int scaled = list->scaled_owners > 0;
+
+    // 셀 크기는 보통 크기의 공 기준: 반지름 히스토그램에서 더 큰 공이 소수만 남는 반지름 선택
+    // (큰 공 몇 개가 그리드 전체를 성기게 만들지 않도록 함)
+    int histogram[BALL_MAX_RADIUS + 1] = { 0 };
+    for (int i = 0; i < n; i++) {
+        histogram[list->radius[i]]++;
+    }
+    int large_max = n / COLLISION_LARGE_SHARE;
+    if (large_max < COLLISION_LARGE_MIN) large_max = COLLISION_LARGE_MIN;
+    int cell_radius = BALL_MAX_RADIUS, larger = 0;
+    while (cell_radius > 0 && larger + histogram[cell_radius] <= large_max) {
+        larger += histogram[cell_radius];
+        cell_radius--;
+    }
+
+    float cell_size = 2.0f * (float)cell_radius;
+    if (cell_size < COLLISION_MIN_CELL_SIZE) cell_size = COLLISION_MIN_CELL_SIZE;
+    // 공이 몇 개뿐이면 모두 큰 공 버킷에 들어가 셀 반지름이 0이 됨: 빈 셀 수십만 개를
+    // 지우고 훑는 대신 월드 전체를 셀 하나로 두고 모든 쌍을 검사
+    if (n <= large_max) cell_size = WORLD_SIZE;
+    int cols = (int)ceilf(WORLD_SIZE / cell_size);
+    int rows = cols;
+    int cells = cols * rows;
+
+    // 셀보다 큰 공은 마지막 셀 뒤의 별도 버킷(인덱스 cells)에 모음
+    if (grid_reserve(grid, n, cells + 1) < 0) return -1;
+    grid->cell_size = cell_size;
+    grid->cols = cols;
+    grid->rows = rows;
+
+    // (1) 셀별 개수 세기
+    int* start = grid->cell_start;
+    memset(start, 0, sizeof(int) * (size_t)(cells + 2));
+    for (int i = 0; i < n; i++) {
+        int c = cells;
+        if (2.0f * (float)list->radius[i] <= cell_size) {
+            int cx = clamp_cell(fromFixedPos(list->x[i]), cell_size, cols);
+            int cy = clamp_cell(fromFixedPos(list->y[i]), cell_size, rows);
+            c = cy * cols + cx;
+        }
+        grid->ball_cell[i] = c;
+        start[c + 1]++;
+    }
+
+    // (2) 누적합으로 셀 시작 위치 계산
+    for (int c = 0; c <= cells; c++) {
+        start[c + 1] += start[c];
+    }
+
+    // (3) 셀 순서로 흩뿌리기 (start[c]를 쓰기 커서로 사용한 뒤 복원)
+    //     고정소수점 위치는 여기서 float로 변환 (변환은 정확함)
+    for (int i = 0; i < n; i++) {
+        int pos = start[grid->ball_cell[i]]++;
+        grid->sorted_index[pos] = i;
+        grid->sorted_x[pos] = fromFixedPos(list->x[i]);
+        grid->sorted_y[pos] = fromFixedPos(list->y[i]);
+        grid->sorted_r[pos] = (float)list->radius[i];
+        // 충돌 응답은 소유자 속도 단계가 적용된 실제 속도로 계산
+        int lv = scaled ? list->owner_speed_level[list->owner_id[i]] : 0;
+        grid->sorted_dx[pos] = scaleSpeed(list->dx[i], lv);
+        grid->sorted_dy[pos] = scaleSpeed(list->dy[i], lv);
+    }
+    for (int c = cells + 1; c > 0; c--) {
+        start[c] = start[c - 1];
+    }
+    start[0] = 0;
+
+    return 0;
+}
+
+// 겹친 두 공(정렬된 배열의 a, b 위치)에 탄성 충돌 응답 적용
+static void resolve_pair(CollisionGrid* grid, int a, int b, float nx, float ny, float dist) {
+    float* sx = grid->sorted_x;
+    float* sy = grid->sorted_y;
+    int* sdx = grid->sorted_dx;
+    int* sdy = grid->sorted_dy;
+    float ra = grid->sorted_r[a];
+    float rb = grid->sorted_r[b];
+    float ma = ra * ra;
+    float mb = rb * rb;
+    float total = ma + mb;
+
+    // 겹친 만큼 질량 반비례로 밀어냄
+    float overlap = ra + rb - dist;
+    sx[a] = clamp_position(sx[a] - nx * overlap * (mb / total), ra);
+    sy[a] = clamp_position(sy[a] - ny * overlap * (mb / total), ra);
+    sx[b] = clamp_position(sx[b] + nx * overlap * (ma / total), rb);
+    sy[b] = clamp_position(sy[b] + ny * overlap * (ma / total), rb);
+
+    // 서로 다가오는 경우에만 법선 방향 속도 교환
+    float vn = (float)(sdx[a] - sdx[b]) * nx + (float)(sdy[a] - sdy[b]) * ny;
+    if (vn <= 0.0f) return;
+
+    float ja = 2.0f * mb / total * vn;
+    float jb = 2.0f * ma / total * vn;
+    sdx[a] = round_velocity((float)sdx[a] - ja * nx);
+    sdy[a] = round_velocity((float)sdy[a] - ja * ny);
+    sdx[b] = round_velocity((float)sdx[b] + jb * nx);
+    sdy[b] = round_velocity((float)sdy[b] + jb * ny);
+}
+
+// 정렬된 위치 i의 공과 구간 [j_begin, j_end)의 공들 사이의 충돌 검사, 충돌 수 반환
+static inline unsigned long long test_range(CollisionGrid* grid, int i, int j_begin, int j_end) {
+    const float* sx = grid->sorted_x;
+    const float* sy = grid->sorted_y;
+    const float* sr = grid->sorted_r;
+    unsigned long long colliding = 0;
+
+    for (int j = j_begin; j < j_end; j++) {
+        float ddx = sx[j] - sx[i];
+        float ddy = sy[j] - sy[i];
+        float reach = sr[i] + sr[j];
+        float dist2 = ddx * ddx + ddy * ddy;
+
+        if (dist2 >= reach * reach) continue;
+        colliding++;
+
+        float dist = sqrtf(dist2);
+        float nx = 1.0f, ny = 0.0f;  // 완전히 겹친 경우 임의의 법선 사용
+        if (dist > 0.0f) {
+            nx = ddx / dist;
+            ny = ddy / dist;
+        }
+        resolve_pair(grid, i, j, nx, ny, dist);
+    }
+    return colliding;
+}
+
+void collision_step(CollisionGrid* grid, BallList* list) {
+    grid->stats.tick_pairs_tested = 0;
+    grid->stats.tick_pairs_colliding = 0;
+
+    if (list->count < 2) return;
+    if (grid_rebuild(grid, list) < 0) {
+        perror(COLOR_RED "[Error] Collision grid allocation failed" COLOR_RESET);
+        return;
+    }
+
+    // 각 쌍을 한 번만 검사하도록 자기 셀 + 전방 이웃(오른쪽 1개, 아래 행 3개)만 확인.
+    // 셀이 행 우선 순서로 정렬되어 있으므로 "자기 셀의 뒤쪽 + 오른쪽 셀"과
+    // "아래 행의 이웃 3개"는 각각 하나의 연속 구간이 됨
+    const int* start = grid->cell_start;
+    int cols = grid->cols;
+    unsigned long long tested = 0, colliding = 0;
+
+    for (int cy = 0; cy < grid->rows; cy++) {
+        for (int cx = 0; cx < cols; cx++) {
+            int c = cy * cols + cx;
+            int i_begin = start[c], i_end = start[c + 1];
+            if (i_begin == i_end) continue;
+
+            int right_end = (cx + 1 < cols) ? start[c + 2] : i_end;
+            int below_begin = 0, below_end = 0;
+            if (cy + 1 < grid->rows) {
+                int below = c + cols;
+                below_begin = start[(cx > 0) ? below - 1 : below];
+                below_end = start[((cx + 1 < cols) ? below + 1 : below) + 1];
+            }
+
+            for (int i = i_begin; i < i_end; i++) {
+                colliding += test_range(grid, i, i + 1, right_end);
+                colliding += test_range(grid, i, below_begin, below_end);
+                tested += (unsigned long long)(right_end - i - 1 + below_end - below_begin);
+            }
+        }
+    }
+
+    // 큰 공: 서로 모두 검사하고, 닿을 수 있는 범위(반지름 + 셀 공의 최대 반지름)의 셀들만 검사.
+    // 셀들은 행 단위로 연속 구간이 됨
+    int cells = cols * grid->rows;
+    int large_end = start[cells + 1];
+    float half_cell = grid->cell_size * 0.5f;
+    for (int i = start[cells]; i < large_end; i++) {
+        colliding += test_range(grid, i, i + 1, large_end);
+        tested += (unsigned long long)(large_end - i - 1);
+
+        float reach = grid->sorted_r[i] + half_cell;
+        int cx0 = clamp_cell(grid->sorted_x[i] - reach, grid->cell_size, cols);
+        int cx1 = clamp_cell(grid->sorted_x[i] + reach, grid->cell_size, cols);
+        int cy0 = clamp_cell(grid->sorted_y[i] - reach, grid->cell_size, grid->rows);
+        int cy1 = clamp_cell(grid->sorted_y[i] + reach, grid->cell_size, grid->rows);
+        for (int cy = cy0; cy <= cy1; cy++) {
+            int row_begin = start[cy * cols + cx0], row_end = start[cy * cols + cx1 + 1];
+            colliding += test_range(grid, i, row_begin, row_end);
+            tested += (unsigned long long)(row_end - row_begin);
+        }
+    }
+
+    // 충돌이 있었으면 정렬된 배열의 결과를 원래 위치로 되돌려 씀 (Q10.6으로 반올림).
+    // 속도 단계가 있는 소유자의 공은 바뀐 속도만 기본 속도로 환산 (안 바뀐 속도는 손실 없이 유지)
+    // 모든 공을 거치므로 소유자별 기본 속도 범위도 여기서 정확히 다시 계산
+    if (colliding > 0) {
+        int scaled = list->scaled_owners > 0;
+        resetOwnerSpeedRanges(list);
+        for (int k = 0; k < list->count; k++) {
+            int i = grid->sorted_index[k];
+            list->x[i] = toFixedPos(grid->sorted_x[k]);
+            list->y[i] = toFixedPos(grid->sorted_y[k]);
+
+            int lv = scaled ? list->owner_speed_level[list->owner_id[i]] : 0;
+            if (lv == 0) {
+                list->dx[i] = (int16_t)grid->sorted_dx[k];
+                list->dy[i] = (int16_t)grid->sorted_dy[k];
+            } else {
+                if (grid->sorted_dx[k] != scaleSpeed(list->dx[i], lv))
+                    list->dx[i] = (int16_t)unscaleSpeed(grid->sorted_dx[k], lv);
+                if (grid->sorted_dy[k] != scaleSpeed(list->dy[i], lv))
+                    list->dy[i] = (int16_t)unscaleSpeed(grid->sorted_dy[k], lv);
+            }
+            OwnerBallSet* set = &list->owners[list->owner_id[i]];
+            noteOwnerSpeed(set, list->dx[i]);
+            noteOwnerSpeed(set, list->dy[i]);
+        }
+    }
+
+    grid->stats.tick_pairs_tested = tested;
+    grid->stats.tick_pairs_colliding = colliding;
+    grid->stats.total_pairs_tested += grid->stats.tick_pairs_tested;
+    grid->stats.total_pairs_colliding += grid->stats.tick_pairs_colliding;
+}
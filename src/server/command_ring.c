@@ -0,0 +1,97 @@
+#include <string.h>
+#include "command_ring.h"
+
+#define COMMAND_RING_MASK (COMMAND_RING_CAPACITY - 1)
+
+#if (COMMAND_RING_CAPACITY & COMMAND_RING_MASK) != 0
+#error "COMMAND_RING_CAPACITY must be a power of two"
+#endif
+
+void command_ring_init(CommandRing* ring) {
+    memset(ring, 0, sizeof(CommandRing));
+}
+
+int command_ring_push(CommandRing* ring, const WorldCommand* command) {
+    uint32_t tail = ring->tail;     // 생산자만 쓰는 값
+
+    // 캐시된 head로 가득 찼다고 보일 때만 소비자의 head를 다시 읽음
+    if (tail - ring->cached_head == COMMAND_RING_CAPACITY) {
+        ring->cached_head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        if (tail - ring->cached_head == COMMAND_RING_CAPACITY) return 0;
+    }
+
+    ring->slots[tail & COMMAND_RING_MASK] = *command;
+    __atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+    return 1;
+}
+
+uint32_t command_ring_end(CommandRing* ring) {
+    return __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+}
+
+int command_ring_pop(CommandRing* ring, uint32_t end, WorldCommand* command) {
+    uint32_t head = ring->head;     // 소비자만 쓰는 값
+    if (head == end) return 0;
+
+    *command = ring->slots[head & COMMAND_RING_MASK];
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+    return 1;
+}
+
+int command_ring_consumed(CommandRing* ring, uint32_t pos) {
+    return (int32_t)(__atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) - pos) >= 0;
+}
+
+void shared_command_ring_init(SharedCommandRing* ring) {
+    memset(ring, 0, sizeof(SharedCommandRing));
+    for (uint32_t i = 0; i < COMMAND_RING_CAPACITY; i++) {
+        ring->seq[i] = i;   // 위치 i의 생산자를 기다리는 빈 슬롯
+    }
+}
+
+int shared_command_ring_push(SharedCommandRing* ring, const WorldCommand* command) {
+    uint32_t pos = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+    for (;;) {
+        uint32_t seq = __atomic_load_n(&ring->seq[pos & COMMAND_RING_MASK], __ATOMIC_ACQUIRE);
+        int32_t diff = (int32_t)(seq - pos);
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&ring->tail, &pos, pos + 1, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) break;
+        } else if (diff < 0) {
+            return 0;   // 가득 참
+        } else {
+            pos = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+        }
+    }
+
+    ring->slots[pos & COMMAND_RING_MASK] = *command;
+    __atomic_store_n(&ring->seq[pos & COMMAND_RING_MASK], pos + 1, __ATOMIC_RELEASE);
+    return 1;
+}
+
+uint32_t shared_command_ring_end(SharedCommandRing* ring) {
+    uint32_t pos = ring->head;
+    // 앞에서부터 연속으로 발행된 슬롯까지
+    while (__atomic_load_n(&ring->seq[pos & COMMAND_RING_MASK], __ATOMIC_ACQUIRE) == pos + 1) {
+        pos++;
+    }
+    return pos;
+}
+
+int shared_command_ring_pop(SharedCommandRing* ring, uint32_t end, WorldCommand* command) {
+    uint32_t head = ring->head;     // 소비자만 쓰는 값
+    if (head == end) return 0;
+
+    *command = ring->slots[head & COMMAND_RING_MASK];
+    __atomic_store_n(&ring->seq[head & COMMAND_RING_MASK], head + COMMAND_RING_CAPACITY, __ATOMIC_RELEASE);
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+    return 1;
+}
+
+uint32_t shared_command_ring_tail(SharedCommandRing* ring) {
+    return __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+}
+
+int shared_command_ring_consumed(SharedCommandRing* ring, uint32_t pos) {
+    return (int32_t)(__atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) - pos) >= 0;
+}
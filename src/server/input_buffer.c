@@ -0,0 +1,54 @@
+#include <string.h>
+#include "input_buffer.h"
+
+void input_buffer_reset(InputBuffer* in) {
+    in->start = 0;
+    in->end = 0;
+    in->discarding = 0;
+}
+
+char* input_buffer_space(InputBuffer* in, size_t* avail) {
+    // 남은 미완성 명령을 앞으로 당겨 빈 공간을 한 덩어리로 만듦
+    if (in->start > 0) {
+        memmove(in->data, in->data + in->start, in->end - in->start);
+        in->end -= in->start;
+        in->start = 0;
+    }
+    *avail = INPUT_BUFFER_SIZE - in->end;
+    return in->data + in->end;
+}
+
+void input_buffer_commit(InputBuffer* in, size_t len) {
+    in->end += (uint32_t)len;
+}
+
+int input_buffer_next(InputBuffer* in, char** cmd) {
+    for (;;) {
+        char* begin = in->data + in->start;
+        size_t buffered = in->end - in->start;
+        char* delim = memchr(begin, COMMAND_DELIMITER, buffered);
+
+        if (!delim) {
+            if (buffered < INPUT_BUFFER_SIZE) return INPUT_NONE;   // 나머지가 올 때까지 보관
+
+            // 버퍼가 가득 찼는데 구분자가 없음: 구분자가 나올 때까지 버림 (알림은 한 번만)
+            in->start = in->end = 0;
+            if (in->discarding) return INPUT_NONE;
+            in->discarding = 1;
+            return INPUT_TOO_LONG;
+        }
+
+        size_t len = (size_t)(delim - begin);
+        in->start += (uint32_t)len + 1;
+        if (in->discarding) {
+            in->discarding = 0;     // 너무 긴 명령의 끝부분
+            continue;
+        }
+
+        if (len > 0 && begin[len - 1] == '\r') len--;  // "\r\n" 허용
+        if (len == 0) continue;                         // 빈 줄 무시
+        begin[len] = '\0';
+        *cmd = begin;
+        return (int)len;
+    }
+}
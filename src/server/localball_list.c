@@ -1,119 +1,334 @@
 #include  "localball_list.h"
+#include "ball_kernel.h"
+#include "rng.h"
+#include <math.h>
+#include <limits.h>
 
-BallListNode* createNode(LogicalBall ball) {
+void initBallList(BallList* list) {
+    memset(list, 0, sizeof(BallList));
+    list->free_handle = -1;
+    list->free_handle_tail = -1;
+}
 
-  BallListNode *newnode = (BallListNode*)malloc(sizeof(BallListNode));
-  if (!newnode) {
-      return NULL;
-  }
+// 배열 하나를 새 용량으로 확장 (실패 시 기존 배열 유지)
+static int growArray(void** arr, size_t elem_size, int capacity) {
+    void* p = realloc(*arr, elem_size * (size_t)capacity);
+    if (!p) return -1;
+    *arr = p;
+    return 0;
+}
 
-  memset(newnode, 0, sizeof(BallListNode));
+int reserveBallList(BallList* list, int capacity) {
+    if (capacity <= list->capacity) return 0;
 
-  newnode->data = ball;
-  newnode->next = NULL;
+    int new_cap = (list->capacity > 0) ? list->capacity : BALL_LIST_INIT_CAPACITY;
+    while (new_cap < capacity) {
+        if (new_cap > INT_MAX / 2) return -1;     // 두 배로 늘리면 int 범위를 넘음
+        new_cap *= 2;
+    }
 
-    return newnode;
+    if (growArray((void**)&list->x, sizeof(uint16_t), new_cap) < 0 ||
+        growArray((void**)&list->y, sizeof(uint16_t), new_cap) < 0 ||
+        growArray((void**)&list->dx, sizeof(int16_t), new_cap) < 0 ||
+        growArray((void**)&list->dy, sizeof(int16_t), new_cap) < 0 ||
+        growArray((void**)&list->radius, sizeof(uint8_t), new_cap) < 0 ||
+        growArray((void**)&list->owner_id, sizeof(uint16_t), new_cap) < 0 ||
+        growArray((void**)&list->palette, sizeof(uint8_t), new_cap) < 0 ||
+        growArray((void**)&list->id, sizeof(int), new_cap) < 0 ||
+        growArray((void**)&list->owner_slot, sizeof(int), new_cap) < 0) {
+        return -1;
+    }
+
+    list->capacity = new_cap;
+    return 0;
 }
 
-BallListNode* appendBall(BallListNode* head, BallListNode** tail, LogicalBall ball)
-{
-  BallListNode* newnode = NULL;
-  if((newnode =createNode(ball)) == NULL)
-    perror(COLOR_RED "[Error] Memory allocation failed" COLOR_RESET);
+// owner_id 번 소유자 집합을 사용할 수 있도록 소유자 테이블 확장
+static OwnerBallSet* ownerSetFor(BallList* list, int owner_id) {
+    if (owner_id >= list->owner_capacity) {
+        int new_cap = (list->owner_capacity > 0) ? list->owner_capacity : 16;
+        while (new_cap <= owner_id) new_cap *= 2;
 
-  if (head == NULL) {
-    head = newnode;
-    *tail = newnode;
-  } else {
-    (*tail)->next = newnode;
-    *tail = newnode;
-  }
+        OwnerBallSet* p = (OwnerBallSet*)realloc(list->owners, sizeof(OwnerBallSet) * (size_t)new_cap);
+        if (!p) return NULL;
+        memset(p + list->owner_capacity, 0, sizeof(OwnerBallSet) * (size_t)(new_cap - list->owner_capacity));
+        list->owners = p;
 
-  return head;
+        int* lv = (int*)realloc(list->owner_speed_level, sizeof(int) * (size_t)new_cap);
+        if (!lv) return NULL;
+        memset(lv + list->owner_capacity, 0, sizeof(int) * (size_t)(new_cap - list->owner_capacity));
+        list->owner_speed_level = lv;
 
+        float* sc = (float*)realloc(list->owner_speed_scale, sizeof(float) * (size_t)new_cap);
+        if (!sc) return NULL;
+        for (int o = list->owner_capacity; o < new_cap; o++) sc[o] = 1.0f;
+        list->owner_speed_scale = sc;
+        list->owner_capacity = new_cap;
+    }
+    return &list->owners[owner_id];
 }
 
-void moveBallList(BallListNode* head) {
-    BallListNode* cur = head;
-    while (cur != NULL) {
-        move_logical_ball(&cur->data);
-        cur = cur->next;
+// 소유자 집합이 capacity개를 담을 수 있도록 확장
+static int ownerSetReserve(OwnerBallSet* set, int capacity) {
+    if (capacity <= set->capacity) return 0;
+    int new_cap = (set->capacity > 0) ? set->capacity : OWNER_SET_INIT_CAPACITY;
+    while (new_cap < capacity) {
+        if (new_cap > INT_MAX / 2) return -1;     // 두 배로 늘리면 int 범위를 넘음
+        new_cap *= 2;
     }
+    int* p = (int*)realloc(set->index, sizeof(int) * (size_t)new_cap);
+    if (!p) return -1;
+    set->index = p;
+    set->capacity = new_cap;
+    return 0;
 }
 
+// 핸들 슬롯 할당 (free list 우선, 가장 오래전에 반환된 슬롯부터), 슬롯 번호 반환
+static int allocHandle(BallList* list) {
+    if (list->free_handle >= 0) {
+        int h = list->free_handle;
+        list->free_handle = list->handles[h].next_free;
+        if (list->free_handle < 0) list->free_handle_tail = -1;
+        return h;
+    }
 
+    if (list->handle_count == BALL_HANDLE_MAX_SLOTS) return -1;
+    if (list->handle_count == list->handle_capacity) {
+        int new_cap = (list->handle_capacity > 0) ? list->handle_capacity * 2 : BALL_LIST_INIT_CAPACITY;
+        if (new_cap > BALL_HANDLE_MAX_SLOTS) new_cap = BALL_HANDLE_MAX_SLOTS;
+        BallHandleSlot* p = (BallHandleSlot*)realloc(list->handles, sizeof(BallHandleSlot) * (size_t)new_cap);
+        if (!p) return -1;
+        list->handles = p;
+        list->handle_capacity = new_cap;
+    }
+
+    int h = list->handle_count++;
+    list->handles[h].generation = 0;
+    return h;
+}
 
-void speedUpBalls(BallListNode* head, int owner_id) {
-    BallListNode* cur = head;
-    while (cur != NULL) {
-        if(cur->data.owner_id == owner_id) {
+// 핸들 슬롯 반환: 세대를 올려 이전 ID가 더 이상 유효하지 않게 함.
+// free list 끝에 붙여(FIFO) 같은 슬롯이 바로 재사용되어 세대가 빨리 한 바퀴 도는 것을 막음
+static void releaseHandle(BallList* list, int h) {
+    BallHandleSlot* slot = &list->handles[h];
+    slot->index = -1;
+    slot->generation = (slot->generation + 1) & BALL_HANDLE_GEN_MASK;
+    slot->next_free = -1;
+    if (list->free_handle_tail >= 0) {
+        list->handles[list->free_handle_tail].next_free = h;
+    } else {
+        list->free_handle = h;
+    }
+    list->free_handle_tail = h;
+}
 
-            if (cur->data.dx > 0)
-                cur->data.dx = (cur->data.dx > MAX_SPEED) ? MAX_SPEED : cur->data.dx * 2;
-            else if (cur->data.dx < 0)
-                cur->data.dx = (cur->data.dx < MIN_SPEED) ? MIN_SPEED : cur->data.dx * 2;
+int spawnBalls(BallList* list, int count, int radius, int owner_id) {
+    if (owner_id < 0 || owner_id > BALL_MAX_OWNER_ID || count <= 0) return 0;
+    radius = toStoredRadius(radius);
+    // 살아 있는 공은 핸들 슬롯 수를 넘을 수 없음: 먼저 잘라야 count 합이 넘치지 않음
+    if (count > BALL_HANDLE_MAX_SLOTS - list->count) count = BALL_HANDLE_MAX_SLOTS - list->count;
+    if (count <= 0) return 0;
 
-            if (cur->data.dy > 0)
-                cur->data.dy = (cur->data.dy > MAX_SPEED) ? MAX_SPEED : cur->data.dy * 2;
-            else if (cur->data.dy < 0)
-                cur->data.dy = (cur->data.dy < MIN_SPEED) ? MIN_SPEED : cur->data.dy * 2;
+    OwnerBallSet* set = ownerSetFor(list, owner_id);
+    if (!set ||
+        reserveBallList(list, list->count + count) < 0 ||
+        ownerSetReserve(set, set->count + count) < 0) {
+        perror(COLOR_RED "[Error] Memory allocation failed" COLOR_RESET);
+        return 0;
+    }
+
+    // 논리 좌표계 (0~1000) 안에 공 전체가 들어가는 위치 범위
+    uint32_t span = (1000 - 2 * radius > 0) ? (uint32_t)(1000 - 2 * radius) : 1;
+    uint8_t palette = get_palette_index_by_owner(owner_id);
+    if (set->count == 0) {
+        set->speed_min = set->speed_max = START_BALL_SPEED;
+    } else {
+        noteOwnerSpeed(set, START_BALL_SPEED);
+    }
+    uint32_t rnd[3 * SPAWN_BATCH];
+    int added = 0;
+
+    while (added < count) {
+        int n = count - added;
+        if (n > SPAWN_BATCH) n = SPAWN_BATCH;
+        int base = list->count;
+
+        // (1) 난수를 한 번에 생성한 뒤 위치/방향 배열에 바로 기록 (벡터화 가능)
+        rng_fill(rnd, 3 * n);
+        for (int k = 0; k < n; k++) {
+            list->x[base + k] = (uint16_t)((radius + (int)(((uint64_t)rnd[k] * span) >> 32)) << BALL_FIXED_SHIFT);
+            list->y[base + k] = (uint16_t)((radius + (int)(((uint64_t)rnd[n + k] * span) >> 32)) << BALL_FIXED_SHIFT);
+            list->dx[base + k] = (rnd[2 * n + k] & 1) ? -START_BALL_SPEED : START_BALL_SPEED;
+            list->dy[base + k] = (rnd[2 * n + k] & 2) ? -START_BALL_SPEED : START_BALL_SPEED;
+            list->radius[base + k] = (uint8_t)radius;
+            list->owner_id[base + k] = (uint16_t)owner_id;
+            list->palette[base + k] = palette;
+        }
+
+        // (2) ID 발급과 소유자 집합 등록
+        for (int k = 0; k < n; k++) {
+            int h = allocHandle(list);
+            if (h < 0) {
+                perror(COLOR_RED "[Error] Ball handle allocation failed" COLOR_RESET);
+                return added;
+            }
+            int i = list->count++;
+            list->id[i] = (list->handles[h].generation << BALL_HANDLE_INDEX_BITS) | h;
+            list->handles[h].index = i;
+            list->owner_slot[i] = set->count;
+            set->index[set->count++] = i;
+            added++;
         }
-        cur = cur->next;
     }
-    printInfoBall(head);
+
+    return added;
 }
 
-void speedDownBalls(BallListNode* head, int owner_id) {
-    BallListNode* cur = head;
-    while (cur != NULL) {
-        if(cur->data.owner_id == owner_id) {
-            if (cur->data.dx > 0)
-                cur->data.dx = (cur->data.dx > 1) ? cur->data.dx / 2 : 1;
-            else if (cur->data.dx < 0)
-            cur->data.dx = (cur->data.dx < -1) ? cur->data.dx / 2 : -1;
+void removeBallAt(BallList* list, int index) {
+    if (index < 0 || index >= list->count) return;
 
-            if (cur->data.dy > 0)
-                cur->data.dy = (cur->data.dy > 1) ? cur->data.dy / 2 : 1;
-            else if (cur->data.dy < 0)
-                cur->data.dy = (cur->data.dy < -1) ? cur->data.dy / 2 : -1;
-        }
-        cur = cur->next;
+    // 소유자 집합에서 제거: 집합의 마지막 항목을 빈 자리로 옮김
+    OwnerBallSet* set = &list->owners[list->owner_id[index]];
+    int slot = list->owner_slot[index];
+    int moved = set->index[--set->count];
+    if (slot != set->count) {
+        set->index[slot] = moved;
+        list->owner_slot[moved] = slot;
+    }
+
+    releaseHandle(list, list->id[index] & BALL_HANDLE_INDEX_MASK);
+
+    // 마지막 공을 빈 자리로 옮김 (swap-remove)
+    int last = --list->count;
+    if (index != last) {
+        list->x[index] = list->x[last];
+        list->y[index] = list->y[last];
+        list->dx[index] = list->dx[last];
+        list->dy[index] = list->dy[last];
+        list->radius[index] = list->radius[last];
+        list->owner_id[index] = list->owner_id[last];
+        list->palette[index] = list->palette[last];
+        list->id[index] = list->id[last];
+        list->owner_slot[index] = list->owner_slot[last];
+
+        // 옮겨진 공을 가리키던 소유자 집합 항목과 핸들 갱신
+        list->owners[list->owner_id[index]].index[list->owner_slot[index]] = index;
+        list->handles[list->id[index] & BALL_HANDLE_INDEX_MASK].index = index;
     }
-    printInfoBall(head);
 }
 
-void freeBallList(BallListNode** head) {
-    BallListNode* cur = *head;
-    while (cur != NULL) {
-        BallListNode* tmp = cur;
-        cur = cur->next;
-        free(tmp);
+int findBall(const BallList* list, int id) {
+    if (id < 0) return -1;
+
+    int h = id & BALL_HANDLE_INDEX_MASK;
+    if (h >= list->handle_count) return -1;
+
+    const BallHandleSlot* slot = &list->handles[h];
+    if (slot->index < 0 || slot->generation != (id >> BALL_HANDLE_INDEX_BITS)) return -1;
+    return slot->index;
+}
+
+int removeOwnerBalls(BallList* list, int owner_id) {
+    if (owner_id < 0 || owner_id >= list->owner_capacity) return 0;
+
+    OwnerBallSet* set = &list->owners[owner_id];
+    int removed = 0;
+    while (set->count > 0) {
+        removeBallAt(list, set->index[set->count - 1]);
+        removed++;
     }
-    *head = NULL;
-    printf(COLOR_GREEN "Freed memory of the ball linked list." COLOR_RESET);
+
+    free(set->index);
+    memset(set, 0, sizeof(OwnerBallSet));
+    setOwnerSpeedLevel(list, owner_id, 0);  // 같은 fd를 받는 다음 클라이언트는 기본 속도로 시작
+    return removed;
 }
 
+const OwnerBallSet* getOwnerBalls(const BallList* list, int owner_id) {
+    if (owner_id < 0 || owner_id >= list->owner_capacity) return NULL;
+    return &list->owners[owner_id];
+}
 
-void printInfoBall(BallListNode *head) {
-    int i = 0;
+int setOwnerSpeedLevel(BallList* list, int owner_id, int level) {
+    if (owner_id < 0 || owner_id > BALL_MAX_OWNER_ID) return 0;
+    if (level > SPEED_LEVEL_MAX) level = SPEED_LEVEL_MAX;
+    if (level < SPEED_LEVEL_MIN) level = SPEED_LEVEL_MIN;
+    if (level == 0 && owner_id >= list->owner_capacity) return 0;
+    if (!ownerSetFor(list, owner_id)) return 0;
 
-    if (!head) {
+    // 배율이 적용된 소유자 수 유지 (0이면 커널이 배율 계산을 건너뜀)
+    int old = list->owner_speed_level[owner_id];
+    if (old == 0 && level != 0) list->scaled_owners++;
+    if (old != 0 && level == 0) list->scaled_owners--;
+    list->owner_speed_level[owner_id] = level;
+    list->owner_speed_scale[owner_id] = ldexpf(1.0f, level);
+    return level;
+}
+
+int getOwnerSpeedLevel(const BallList* list, int owner_id) {
+    if (owner_id < 0 || owner_id >= list->owner_capacity) return 0;
+    return list->owner_speed_level[owner_id];
+}
+
+void resetOwnerSpeedRanges(BallList* list) {
+    for (int o = 0; o < list->owner_capacity; o++) {
+        list->owners[o].speed_min = MAX_SPEED + 1;
+        list->owners[o].speed_max = 0;
+    }
+}
+
+// 기존 클램프 유지: 모든 공이 이미 MAX_SPEED / 1이면 단계를 더 옮기지 않음
+// (그렇지 않으면 반대 명령이 쌓인 단계만큼 아무 효과가 없음)
+int speedUpBalls(BallList* list, int owner_id) {
+    int level = getOwnerSpeedLevel(list, owner_id);
+    const OwnerBallSet* set = getOwnerBalls(list, owner_id);
+    if (set && set->count > 0 && scaleSpeed(set->speed_min, level) >= MAX_SPEED) return level;
+    return setOwnerSpeedLevel(list, owner_id, level + 1);
+}
+
+int speedDownBalls(BallList* list, int owner_id) {
+    int level = getOwnerSpeedLevel(list, owner_id);
+    const OwnerBallSet* set = getOwnerBalls(list, owner_id);
+    if (set && set->count > 0 && scaleSpeed(set->speed_max, level) <= 1) return level;
+    return setOwnerSpeedLevel(list, owner_id, level - 1);
+}
+
+void freeBallList(BallList* list) {
+    free(list->x);
+    free(list->y);
+    free(list->dx);
+    free(list->dy);
+    free(list->radius);
+    free(list->owner_id);
+    free(list->palette);
+    free(list->id);
+    free(list->owner_slot);
+    for (int o = 0; o < list->owner_capacity; o++) {
+        free(list->owners[o].index);
+    }
+    free(list->owners);
+    free(list->owner_speed_level);
+    free(list->owner_speed_scale);
+    free(list->handles);
+    initBallList(list);
+    printf(COLOR_GREEN "Freed memory of the ball list." COLOR_RESET);
+}
+
+
+void printInfoBall(const BallList* list) {
+    if (list->count == 0) {
         printf(COLOR_YELLOW "\nNo data available.\n\n" COLOR_RESET);
         return;
     }
 
-    BallListNode *cur = head;
-
     printf("\n................................... \n");
-    while (cur) {
+    for (int i = 0; i < list->count; i++) {
+        RGBColor color = ball_palette[list->palette[i]];
         printf("FD: %d, ID: %d,  x : %.1f,  y : %.1f, dx : %d, dy : %d, RGB : (%d, %d, %d)\n",
-               cur->data.owner_id, cur->data.id, cur->data.x, cur->data.y,
-               cur->data.dx, cur->data.dy,
-               cur->data.color.r, cur->data.color.g, cur->data.color.b);
-
-        cur = cur->next;
-        i++;
+               list->owner_id[i], list->id[i], fromFixedPos(list->x[i]), fromFixedPos(list->y[i]),
+               list->dx[i], list->dy[i],
+               color.r, color.g, color.b);
     }
-    printf("\ntotal : %d\n", i);
+    printf("\ntotal : %d\n", list->count);
     printf("................................... \n\n");
-}
\ No newline at end of file
+}
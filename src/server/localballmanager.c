@@ -4,8 +4,9 @@
 void ball_manager_init(BallListManager* manager) {
 
     memset(manager, 0,sizeof(BallListManager));
-    manager->head = NULL;
-    manager->tail = NULL;
+    initBallList(&manager->balls);
+    collision_grid_init(&manager->collision);
+    snapshot_store_init(&manager->snapshots);
     manager->total_count = 0;
     pthread_mutex_init(&manager->mutex_ball, NULL);
 }
@@ -13,178 +14,130 @@ void ball_manager_init(BallListManager* manager) {
 void ball_manager_destroy(BallListManager* manager) {
     pthread_mutex_destroy(&manager->mutex_ball);
     printf( COLOR_GREEN "Mutex 'mutex_ball' has been destroyed." COLOR_RESET);
-    freeBallList(&manager->head);
+    freeBallList(&manager->balls);
+    collision_grid_destroy(&manager->collision);
+    snapshot_store_destroy(&manager->snapshots);
 }
 
 void add_ball(BallListManager* manager, int count, int radius, int owner_id) {
-    for (int i = 0; i < count; i++) {
-        LogicalBall b = create_logical_ball(manager->total_count++,radius, owner_id);
-        manager->head = appendBall(manager->head, &manager->tail, b);
-    }
-    printf(COLOR_GREEN "[Success] fd[%d]: '%d' added successfully." COLOR_RESET, owner_id, count);
-    printInfoBall(manager->head);
+    // 배열/소유자 집합/핸들 테이블을 한 번에 확보한 뒤 일괄 생성
+    int added = spawnBalls(&manager->balls, count, radius, owner_id);
+    manager->total_count += added;
+    printf(COLOR_GREEN "[Success] fd[%d]: '%d' added successfully (total %d)." COLOR_RESET,
+           owner_id, added, manager->balls.count);
 }
 
 void delete_ball(BallListManager* manager, int count, int owner_id) {
-    BallListNode *cur = manager->head;
-    BallListNode *prev = NULL;
-
-    // 삭제 대상 후보 저장용 (역순으로)
-    BallListNode* candidates[count];
-    BallListNode* candidates_prev[count];
+    BallList* list = &manager->balls;
+    const OwnerBallSet* set = getOwnerBalls(list, owner_id);
     int found = 0;
 
-    while (cur) {
-        if (cur->data.owner_id == owner_id) {
-            if (found < count) {
-                candidates[found] = cur;
-                candidates_prev[found] = prev;
-                found++;
-            } else {
-                // 가장 오래된 후보는 버리고 새로 push
-                for (int i = 0; i < count - 1; ++i) {
-                    candidates[i] = candidates[i+1];
-                    candidates_prev[i] = candidates_prev[i+1];
-                }
-                candidates[count-1] = cur;
-                candidates_prev[count-1] = prev;
-            }
-        }
-        prev = cur;
-        cur = cur->next;
+    // 소유자 집합의 끝(가장 최근에 추가된 공)부터 삭제 (공마다 출력하지 않음)
+    while (set && set->count > 0 && found < count) {
+        removeBallAt(list, set->index[set->count - 1]);
+        manager->total_count--;
+        found++;
     }
 
     if (found == 0) {
         printf(COLOR_BLUE "No balls found for owner_id %d\n" COLOR_RESET, owner_id);
         return;
     }
+    printf(COLOR_GREEN "[Success] fd[%d]: '%d' deleted successfully (total %d)." COLOR_RESET,
+           owner_id, found, list->count);
+}
 
-    for (int i = found - 1; i >= 0; --i) {
-        BallListNode* target = candidates[i];
-        BallListNode* target_prev = candidates_prev[i];
-
-        // target이 이미 리스트에서 빠졌는지 확인
-        if (target_prev && target_prev->next != target) continue;
-
-        // head 갱신
-        if (manager->head == target) {
-            manager->head = target->next;
-        }
-
-        // tail 갱신
-        if (manager->tail == target) {
-            manager->tail = target_prev;
-        }
-
-        // 중간 연결 제거
-        if (target_prev) {
-            target_prev->next = target->next;
-        }
-
-        free(target);
-        manager->total_count--;
-        printf(COLOR_GREEN "[Success] '%d' Deleted (owner: %d)\n" COLOR_RESET, target->data.id, owner_id);
+int kill_ball(BallListManager* manager, int ball_id, int owner_id) {
+    BallList* list = &manager->balls;
+    int index = findBall(list, ball_id);
+    // 다른 플레이어의 공은 없는 공과 같이 처리 (소유자만 삭제 가능)
+    if (index < 0 || list->owner_id[index] != owner_id) {
+        printf(COLOR_BLUE "No ball found for id %d (owner: %d)\n" COLOR_RESET, ball_id, owner_id);
+        return -1;
     }
 
-
-    printInfoBall(manager->head);
+    removeBallAt(list, index);
+    manager->total_count--;
+    printf(COLOR_GREEN "[Success] '%d' Deleted (owner: %d)\n" COLOR_RESET, ball_id, owner_id);
+    return owner_id;
 }
 
 void delete_ball_by_socket(BallListManager* manager, int socket_fd) {
-    BallListNode *cur = manager->head;
-    BallListNode *prev = NULL;
-
-    while (cur) {
-        BallListNode* next = cur->next;
-
-        if (cur->data.owner_id == socket_fd) {
-            if (prev == NULL) {
-                manager->head = next;
-            } else {
-                prev->next = next;
-            }
-
-            // tail이 삭제 대상이라면 tail 갱신
-            if (manager->tail == cur) {
-                manager->tail = prev;
-            }
-
-            free(cur);
-            manager->total_count--;
-        } else {
-            prev = cur;
-        }
-
-        cur = next;
-    }
+    manager->total_count -= removeOwnerBalls(&manager->balls, socket_fd);
 }
 
-void move_all_ball(BallListManager* manager) {
-    moveBallList(manager->head);
+void collide_all_ball(BallListManager* manager) {
+    collision_step(&manager->collision, &manager->balls);
 }
 
-char* serialize_ball_list(BallListManager* manager, int owner_id) {
-    BallListNode* cur = manager->head;
-    char* buffer = (char*)malloc(8192);
-    buffer[0] = '\0';
+// Q10.6 좌표를 소수점 둘째 자리(1/100 단위)로 반올림 ("%.2f"와 같은 결과, 동률은 짝수 쪽)
+static inline int fixed_to_hundredths(uint16_t v) {
+    int num = (int)v * 100;
+    int q = num >> BALL_FIXED_SHIFT;
+    int r = num & (BALL_FIXED_ONE - 1);
+    if (r > BALL_FIXED_ONE / 2 || (r == BALL_FIXED_ONE / 2 && (q & 1))) q++;
+    return q;
+}
 
-    while (cur) {
-        if(cur->data.owner_id == owner_id) {
-            char temp[256];
-            snprintf(temp, sizeof(temp), "%d,%.2f,%.2f,%d,%d,%d,%hhu,%hhu,%hhu|",
-                 cur->data.owner_id,
-                 cur->data.x, cur->data.y,
-                 cur->data.dx, cur->data.dy,
-                 cur->data.radius,
-                 cur->data.color.r, cur->data.color.g, cur->data.color.b);
+// 부호 없는 정수를 10진수로 기록 (snprintf 대신, 다음 쓸 위치 반환)
+static inline char* put_uint(char* p, unsigned v) {
+    char digits[10];
+    int n = 0;
+    do {
+        digits[n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v);
+    while (n) *p++ = digits[--n];
+    return p;
+}
 
-            strcat(buffer, temp);
-        }
-        cur = cur->next;
+static inline char* put_int(char* p, int v) {
+    if (v < 0) {
+        *p++ = '-';
+        return put_uint(p, 0u - (unsigned)v);
     }
-
-    return buffer; // 호출자가 free 해야 함
+    return put_uint(p, (unsigned)v);
 }
 
-char* serialize_ball_list_all(BallListManager* manager) {
-    BallListNode* cur = manager->head;
-    char* buffer = (char*)malloc(8192);
-    buffer[0] = '\0';
-
-    while (cur) {
-        char temp[256];
-        snprintf(temp, sizeof(temp), "%d,%.2f,%.2f,%d,%d,%d,%hhu,%hhu,%hhu|",
-                 cur->data.id,
-                 cur->data.x, cur->data.y,
-                 cur->data.dx, cur->data.dy,
-                 cur->data.radius,
-                 cur->data.color.r, cur->data.color.g, cur->data.color.b);
+// 1/100 단위 값을 "정수.소수 둘째 자리"로 기록 ("%d.%02d")
+static inline char* put_hundredths(char* p, int h) {
+    p = put_uint(p, (unsigned)(h / 100));
+    *p++ = '.';
+    *p++ = (char)('0' + (h % 100) / 10);
+    *p++ = (char)('0' + h % 10);
+    return p;
+}
 
-        strcat(buffer, temp);
-        cur = cur->next;
+size_t encode_snapshot_all(const WorldSnapshot* snap, char* buf) {
+    char* p = buf;
+    for (int i = 0; snap && i < snap->count; i++) {
+        // 형식: id,x,y,dx,dy,radius,r,g,b| (좌표는 소수점 둘째 자리)
+        RGBColor color = ball_palette[snap->palette[i]];
+        p = put_int(p, snap->id[i]);                           *p++ = ',';
+        p = put_hundredths(p, fixed_to_hundredths(snap->x[i])); *p++ = ',';
+        p = put_hundredths(p, fixed_to_hundredths(snap->y[i])); *p++ = ',';
+        p = put_int(p, snap->dx[i]);                           *p++ = ',';
+        p = put_int(p, snap->dy[i]);                           *p++ = ',';
+        p = put_uint(p, snap->radius[i]);                      *p++ = ',';
+        p = put_uint(p, color.r);                              *p++ = ',';
+        p = put_uint(p, color.g);                              *p++ = ',';
+        p = put_uint(p, color.b);                              *p++ = '|';
     }
-
-    return buffer; // 호출자가 free 해야 함
+    return (size_t)(p - buf);
 }
 
-
-int count_ball_by_owner(BallListNode* head, int owner_id) {
-    int count = 0;
-    while (head) {
-        if (head->data.owner_id == owner_id)
-            count++;
-        head = head->next;
-    }
-    return count;
+int count_ball_by_owner(const BallList* list, int owner_id) {
+    const OwnerBallSet* set = getOwnerBalls(list, owner_id);
+    return set ? set->count : 0;
 }
 
 
 void log_ball_memory_usage(BallListManager* manager, const char* action, int fd, int count) {
-    size_t unit_mem = sizeof(BallListNode);
+    size_t unit_mem = BALL_LIST_ELEM_SIZE;
     size_t delta_mem = unit_mem * count;
 
     // 현재 전체 공 개수 (이후 기준)
-    int now_count = count_ball_by_owner(manager->head, fd);
+    int now_count = count_ball_by_owner(&manager->balls, fd);
     size_t now_mem = now_count * unit_mem;
 
     char details[256];
@@ -196,46 +149,61 @@ void log_ball_memory_usage(BallListManager* manager, const char* action, int fd,
 }
 
 // 핸들러 함수 정의
-void handle_add(BallListManager* m, int count, int radius, int owner_id) {
+int handle_add(BallListManager* m, int count, int radius, int owner_id) {
     if (count <= 0) count = 1;
     add_ball(m,count,radius,owner_id);
     log_ball_memory_usage(m, "ADD", owner_id, count);
+    return 0;
 }
 
-void handle_delete(BallListManager* m, int count, int radius,int owner_id) {
+int handle_delete(BallListManager* m, int count, int radius,int owner_id) {
     (void)radius;
     if (count <= 0) count = 1;
     delete_ball(m, count, owner_id);
     log_ball_memory_usage(m, "DEL", owner_id, count);
+    return 0;
 }
 
-void handle_speed_up(BallListManager* m, int count, int radius, int owner_id) {
+int handle_speed_up(BallListManager* m, int count, int radius, int owner_id) {
     (void)count;
     (void)radius;
-    speedUpBalls(m->head, owner_id);
+    int level = speedUpBalls(&m->balls, owner_id);
+    printf(COLOR_GREEN "[Success] fd[%d]: speed level %d" COLOR_RESET, owner_id, level);
+    return 0;
 }
 
-void handle_speed_down(BallListManager* m, int count, int radius, int owner_id) {
+int handle_speed_down(BallListManager* m, int count, int radius, int owner_id) {
     (void)count;
     (void)radius;
-    speedDownBalls(m->head, owner_id);
+    int level = speedDownBalls(&m->balls, owner_id);
+    printf(COLOR_GREEN "[Success] fd[%d]: speed level %d" COLOR_RESET, owner_id, level);
+    return 0;
+}
+
+int handle_kill(BallListManager* m, int ball_id, int radius, int owner_id) {
+    (void)radius;
+    int ball_owner = kill_ball(m, ball_id, owner_id);
+    if (ball_owner < 0) return -1;
+    log_ball_memory_usage(m, "KILL", ball_owner, 1);
+    return 0;
 }
 
 CommandEntry command_table[] = {
     {CMD_ADD, handle_add},
     {CMD_DEL, handle_delete},
     {CMD_SPEED_UP, handle_speed_up},
-    {CMD_SPEED_DOWN, handle_speed_down}
+    {CMD_SPEED_DOWN, handle_speed_down},
+    {CMD_KILL, handle_kill}
 };
 
-void dispatch_command(BallListManager* m, char cmd, int count, int radius, int owner_id) {
+int dispatch_command(BallListManager* m, char cmd, int count, int radius, int owner_id) {
     for (size_t i = 0; i < sizeof(command_table)/sizeof(CommandEntry); ++i) {
         if (command_table[i].cmd == cmd) {
-            command_table[i].handler(m, count, radius, owner_id);
-            return;
+            return command_table[i].handler(m, count, radius, owner_id);
         }
     }
     printf("[Server] Unknown command: %c\n", cmd);
+    return -1;
 }
 
 
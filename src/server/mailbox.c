@@ -0,0 +1,101 @@
+#include "mailbox.h"
+
+#define MAILBOX_MASK (MAILBOX_CAPACITY - 1)
+
+#if (MAILBOX_CAPACITY & MAILBOX_MASK) != 0
+#error "MAILBOX_CAPACITY must be a power of two"
+#endif
+
+void mailbox_table_init(MailboxTable* table) {
+    memset(table->pages, 0, sizeof(table->pages));
+    pthread_mutex_init(&table->grow_mutex, NULL);
+}
+
+void mailbox_table_destroy(MailboxTable* table) {
+    for (int p = 0; p < MAILBOX_MAX_PAGES; p++) {
+        if (!table->pages[p]) continue;
+        for (int i = 0; i < MAILBOX_PAGE_SIZE; i++) {
+            out_queue_destroy(&table->pages[p][i].out);
+        }
+        free(table->pages[p]);
+        table->pages[p] = NULL;
+    }
+    pthread_mutex_destroy(&table->grow_mutex);
+}
+
+Mailbox* mailbox_get(MailboxTable* table, int fd) {
+    if (fd < 0 || fd >= MAILBOX_PAGE_SIZE * MAILBOX_MAX_PAGES) return NULL;
+    int p = fd / MAILBOX_PAGE_SIZE;
+
+    Mailbox* page = __atomic_load_n(&table->pages[p], __ATOMIC_ACQUIRE);
+    if (!page) {
+        // 처음 쓰는 페이지: 잠금 안에서 다시 확인 후 할당
+        pthread_mutex_lock(&table->grow_mutex);
+        page = table->pages[p];
+        if (!page) {
+            page = (Mailbox*)aligned_alloc(TASK_CACHE_LINE, sizeof(Mailbox) * MAILBOX_PAGE_SIZE);
+            if (page) {
+                memset(page, 0, sizeof(Mailbox) * MAILBOX_PAGE_SIZE);
+                for (int i = 0; i < MAILBOX_PAGE_SIZE; i++) {
+                    out_queue_init(&page[i].out);
+                }
+                __atomic_store_n(&table->pages[p], page, __ATOMIC_RELEASE);
+            } else {
+                perror(COLOR_RED "[Error] Mailbox allocation failed" COLOR_RESET);
+            }
+        }
+        pthread_mutex_unlock(&table->grow_mutex);
+        if (!page) return NULL;
+    }
+    return &page[fd % MAILBOX_PAGE_SIZE];
+}
+
+void mailbox_open(Mailbox* box, int fd, OutFlushList* flush_list) {
+    box->eof_queued = 0;
+    input_buffer_reset(&box->input);    // 이전 연결이 남긴 미완성 명령 버림
+    out_queue_open(&box->out, fd, flush_list);
+    __atomic_store_n(&box->closed, 0, __ATOMIC_RELEASE);
+}
+
+int mailbox_push(Mailbox* box, const Task* task, int use_reserve) {
+    uint32_t tail = box->tail;      // 생산자(리액터)만 쓰는 값
+    uint32_t head = __atomic_load_n(&box->head, __ATOMIC_ACQUIRE);
+    uint32_t limit = use_reserve ? MAILBOX_CAPACITY : MAILBOX_CAPACITY - 1;
+    if (tail - head >= limit) return 0;
+
+    box->slots[tail & MAILBOX_MASK] = *task;
+    // mailbox_release()의 scheduled 해제와 순서가 맞도록 SEQ_CST
+    __atomic_store_n(&box->tail, tail + 1, __ATOMIC_SEQ_CST);
+    return 1;
+}
+
+int mailbox_schedule(Mailbox* box) {
+    int expected = 0;
+    return __atomic_compare_exchange_n(&box->scheduled, &expected, 1, 0,
+                                       __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+int mailbox_pop(Mailbox* box, Task* task) {
+    uint32_t head = box->head;      // 토큰을 가진 워커만 쓰는 값
+    if (head == __atomic_load_n(&box->tail, __ATOMIC_ACQUIRE)) return 0;
+
+    *task = box->slots[head & MAILBOX_MASK];
+    __atomic_store_n(&box->head, head + 1, __ATOMIC_RELEASE);
+    return 1;
+}
+
+int mailbox_release(Mailbox* box) {
+    __atomic_store_n(&box->scheduled, 0, __ATOMIC_SEQ_CST);
+    // 해제 직전에 들어온 명령은 생산자가 예약하지 못했을 수 있으므로 다시 확인
+    uint32_t head = __atomic_load_n(&box->head, __ATOMIC_SEQ_CST);
+    if (head == __atomic_load_n(&box->tail, __ATOMIC_SEQ_CST)) return 0;
+    return mailbox_schedule(box);
+}
+
+void mailbox_close(Mailbox* box) {
+    __atomic_store_n(&box->closed, 1, __ATOMIC_RELEASE);
+}
+
+int mailbox_is_closed(const Mailbox* box) {
+    return __atomic_load_n(&box->closed, __ATOMIC_ACQUIRE);
+}
@@ -6,190 +6,105 @@
 #include <arpa/inet.h>
 #include <signal.h>
 #include "server.h"
+#include "reactor.h"
 
-#define MAX_EVENTS 64
-
-extern TaskQueue* global_task_queue;
+extern WorkerPool* global_worker_pool;
 extern volatile sig_atomic_t keep_running;
 
 void handle_sigint(int sig) {
     if(sig ==  SIGINT)
     {
         keep_running = 0;
-        pthread_cond_broadcast(&global_task_queue->cond); 
+        worker_pool_wake_all(global_worker_pool);    // futex 기반이므로 시그널 핸들러에서 호출 가능
         printf(COLOR_YELLOW "\n[Signal] SIGINT received. Shutting down server..." COLOR_RESET);
     }
 }
 
-void set_nonblocking(int fd) {
-    int flags = fcntl(fd, F_GETFL, 0);
-    fcntl(fd, F_SETFL, flags | O_NONBLOCK);
-}
-
-int main(void)
+int main(int argc, char** argv)
 {
-    int ssock, csock;
-    struct sockaddr_in servaddr, cliaddr;
-    socklen_t clen = sizeof(cliaddr);
-    pthread_t workers[NUM_WORKERS];  // woker Pool 생성
+    pthread_t manager_id;            // 워커 풀을 늘리고 줄이는 관리 스레드
     pthread_t cycle_broadcast_id;
-    
+    pthread_t fanout_id;
+    Reactor reactors[MAX_REACTORS];
+    int reactor_count = 0;
+    int rc = 0;
+
+    ServerConfig config;
+    if (parse_server_config(argc, argv, &config) < 0) {
+        return -1;
+    }
 
     signal(SIGINT, handle_sigint); // graceful shutdown 지원
+    signal(SIGPIPE, SIG_IGN);      // 끊긴 클라이언트에 send 해도 종료되지 않도록 (EPIPE로 처리)
 
-    SharedContext* arg = manager_init();
+    // 월드 메모리를 시뮬레이션 CPU에서 할당 (first-touch로 시뮬레이션 스레드의 NUMA 노드에 배치)
+    affinity_pin_self(&config.affinity, ROLE_SIM);
+    SharedContext* arg = manager_init(&config);
+    affinity_unpin_self();
     if(arg == NULL)
     {
         perror("manager_init()");
         return -1;
     }
+    affinity_report(&config.affinity);
 
-       ssock = socket(AF_INET, SOCK_STREAM, 0);
-    if (ssock < 0) {
-        perror("socket()");
-        exit(1);
-    }
-
-    set_nonblocking(ssock);
-
-    // 2. 포트 재사용 설정
-    int optval = 1;
-    setsockopt(ssock, SOL_SOCKET, SO_REUSEADDR, &optval, sizeof(optval));
-
-    // 2. 서버 주소 구조체 초기화 및 설정
-    memset(&servaddr, 0, sizeof(servaddr));
-    servaddr.sin_family = AF_INET;                 // IPv4
-    servaddr.sin_addr.s_addr = htonl(INADDR_ANY);  // 모든 IP에서의 접속 허용
-    servaddr.sin_port = htons(SERVER_PORT);           // 포트 번호
-
-    // 3. IP/포트 바인딩
-    if(bind(ssock, (struct sockaddr *)&servaddr, sizeof(servaddr))<0)
-    {
-        perror("bind() :");
-        return -1;
+    // 리액터마다 리스닝 소켓과 epoll 생성 (여럿이면 SO_REUSEPORT로 같은 포트 공유)
+    for (; reactor_count < config.reactors; reactor_count++) {
+        if (reactor_init(&reactors[reactor_count], reactor_count, arg, SERVER_PORT, config.reactors > 1) < 0) {
+            for (int r = 0; r < reactor_count; r++) reactor_destroy(&reactors[r]);
+            manager_destroy(arg);
+            return -1;
+        }
     }
 
-    // 4. 클라이언트 연결 대기 상태 진입
-    if((listen(ssock, 8) < 0))
-    {
-        perror("listen() : ");
-        return -1;
-    }
+    pthread_create(&cycle_broadcast_id, NULL, cycle_broadcast_ball_state, (void*)arg);
+    pthread_create(&fanout_id, NULL, snapshot_fanout_thread, (void*)arg);
 
-    int epfd = epoll_create1(0);
-    if (epfd < 0) {
-        perror("epoll_create1");
+    // 워커는 관리 스레드가 최소 개수만큼 시작하고 부하에 따라 조절
+    if (pthread_create(&manager_id, NULL, worker_manager_thread, (void*)arg) != 0) {
+        perror("pthread_create");
         return -1;
     }
 
-    struct epoll_event ev, events[MAX_EVENTS];
-    ev.events = EPOLLIN;
-    ev.data.fd = ssock;
-    epoll_ctl(epfd, EPOLL_CTL_ADD, ssock, &ev);
-    arg->epoll_fd = epfd;
-
-    pthread_create(&cycle_broadcast_id, NULL, cycle_broadcast_ball_state, (void*)arg);
-
-    for (int i = 0; i < NUM_WORKERS; ++i) {
-        if (pthread_create(&workers[i], NULL, worker_thread, (void*)arg) != 0) {
+    // 리액터 0은 메인 스레드에서 실행, 나머지는 각자 스레드에서 실행
+    int started = 1;
+    for (; started < reactor_count; started++) {
+        if (pthread_create(&reactors[started].thread, NULL, reactor_thread, &reactors[started]) != 0) {
             perror("pthread_create");
-            return -1;
+            keep_running = 0;
+            rc = -1;
+            break;
         }
     }
 
+    printf(COLOR_BLUE "[Server] Listening on port %d (%d reactors)..." COLOR_RESET, SERVER_PORT, reactor_count);
 
-    printf(COLOR_BLUE "[Server] Listening on port %d..."COLOR_RESET, SERVER_PORT);
-
-    while (keep_running) {
-        int nready = epoll_wait(epfd, events, MAX_EVENTS, 1000);
-        if (nready == -1) {
-            if (errno == EINTR) continue;
-            perror("epoll_wait");
-            break;
-        }
-
-        for (int i = 0; i < nready; i++) {
-            int fd = events[i].data.fd;
-
-            if (fd == ssock) {
-                csock = accept(ssock, (struct sockaddr*)&cliaddr, &clen);
-                if (csock >= 0) {
-                    set_nonblocking(csock);
-                    ev.events = EPOLLIN | EPOLLET;
-                    ev.data.fd = csock;
-                    epoll_ctl(epfd, EPOLL_CTL_ADD, csock, &ev);
-
-                    add_client(arg->client_list_manager, csock, cliaddr);
-                    pthread_mutex_lock(&arg->client_list_manager->mutex_client);
-                    arg->client_list_manager->client_count++;
-                    log_client_connect(csock, &cliaddr);
-                    pthread_mutex_unlock(&arg->client_list_manager->mutex_client);
-                    pthread_mutex_lock(&arg->ball_list_manager->mutex_ball);
-                    add_ball(arg->ball_list_manager, START_BALL_COUNT, START_BALL_RADIUS, csock);   // 초기 공 생성
-                    log_ball_memory_usage(arg->ball_list_manager, "ADD", csock, START_BALL_COUNT);
-                    pthread_mutex_unlock(&arg->ball_list_manager->mutex_ball);
-                }
-            } else if (events[i].events & EPOLLIN) {
-                char buf[BUFSIZ];
-                memset(buf, 0, sizeof(buf));
-                int len = recv(fd, buf, sizeof(buf), 0);
-                buf[len] = '\0';
-
-                if (len <= 0) {
-                    printf(COLOR_RED "[Server] Client disconnected (fd=%d)\n" COLOR_RESET, fd);
-                    log_client_disconnect(fd, "Client requested disconnect");
-
-                    pthread_mutex_lock(&arg->client_list_manager->mutex_client);
-                    ClientNode* removed = remove_client_by_socket(fd, &arg->client_list_manager->head, &arg->client_list_manager->tail);
-                    if (removed) {
-                        arg->client_list_manager->client_count--;
-                        epoll_ctl(epfd, EPOLL_CTL_DEL, fd, NULL);
-                        shutdown(removed->ctx.csock, SHUT_RDWR);
-                        close(removed->ctx.csock);
-                        free(removed);
-                    }
-                    pthread_mutex_unlock(&arg->client_list_manager->mutex_client);
-
-                    pthread_mutex_lock(&arg->ball_list_manager->mutex_ball);
-                    delete_ball_by_socket(arg->ball_list_manager, fd);
-                    int now_count = count_ball_by_owner(arg->ball_list_manager->head, fd);
-                    log_ball_memory_usage(arg->ball_list_manager, "DEL", fd, now_count);
-                    pthread_mutex_unlock(&arg->ball_list_manager->mutex_ball);
-                }
-                else
-                {
-                    // enqueue to task queue
-                    Task task;
-                    task.fd = fd;
-                    memcpy(task.data, buf, len);
-                    task.length = len;
-                    task_queue_push(arg->task_queue, task);  
-                    printf(COLOR_CYAN "[Server] Enqueued task for fd %d : %s\n" COLOR_RESET, fd, buf);
-                }
-            }
-        }
-    }
+    reactor_thread(&reactors[0]);
 
     printf("[Server] Main Thread Shutting down...\n");
-    close(ssock);
-    close(epfd);
+    for (int r = 1; r < started; r++) {
+        pthread_join(reactors[r].thread, NULL);
+    }
 
-    // 남은 클라이언트 소켓 제거
+    // 남은 클라이언트 소켓의 송수신 중단 (close는 client_list_manager_destroy에서)
     pthread_mutex_lock(&arg->client_list_manager->mutex_client);
-    ClientNode* curr = arg->client_list_manager->head;
-    while (curr) {
-        close(curr->ctx.csock);
-        curr = curr->next;
+    for (int i = 0; i < arg->client_list_manager->client_count; i++) {
+        shutdown(arg->client_list_manager->clients[i].csock, SHUT_RDWR);
     }
     pthread_mutex_unlock(&arg->client_list_manager->mutex_client);
 
-    // 워커 스레드 종료 대기
-    for (int i = 0; i < NUM_WORKERS; ++i) {
-        pthread_join(workers[i], NULL);
-    }
+    // 워커 스레드 종료 대기 (시그널 외의 이유로 루프를 빠져나온 경우에도 깨움)
+    worker_pool_wake_all(arg->worker_pool);
+    pthread_join(manager_id, NULL);      // 관리 스레드가 남은 워커를 모두 join
     pthread_join(cycle_broadcast_id, NULL);
+    pthread_join(fanout_id, NULL);
+
+    // 클라이언트에 쓰는 스레드가 모두 끝난 뒤 닫음 (송신 큐가 리액터를 깨울 수 있음)
+    for (int r = 0; r < reactor_count; r++) {
+        reactor_destroy(&reactors[r]);
+    }
+    worker_pool_report(arg->worker_pool);
     manager_destroy(arg);
 
-    return 0;
+    return rc;
 }
-
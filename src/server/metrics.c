@@ -0,0 +1,63 @@
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "metrics.h"
+
+unsigned long long metrics_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + (unsigned long long)ts.tv_nsec;
+}
+
+void metrics_init(ServerMetrics* metrics) {
+    memset(&metrics->pool, 0, sizeof(PoolMetrics));
+    memset(&metrics->outbound, 0, sizeof(OutboundMetrics));
+    metrics->outbound.max_fd = -1;
+    metrics->states_dropped = 0;
+    metrics->slow_disconnects = 0;
+    pthread_mutex_init(&metrics->mutex, NULL);
+}
+
+void metrics_destroy(ServerMetrics* metrics) {
+    pthread_mutex_destroy(&metrics->mutex);
+}
+
+void metrics_publish_pool(ServerMetrics* metrics, const PoolMetrics* sample) {
+    pthread_mutex_lock(&metrics->mutex);
+    metrics->pool = *sample;
+    pthread_mutex_unlock(&metrics->mutex);
+}
+
+void metrics_read_pool(ServerMetrics* metrics, PoolMetrics* out) {
+    pthread_mutex_lock(&metrics->mutex);
+    *out = metrics->pool;
+    pthread_mutex_unlock(&metrics->mutex);
+}
+
+void metrics_publish_outbound(ServerMetrics* metrics, const OutboundMetrics* sample) {
+    pthread_mutex_lock(&metrics->mutex);
+    metrics->outbound = *sample;
+    pthread_mutex_unlock(&metrics->mutex);
+}
+
+void metrics_read_outbound(ServerMetrics* metrics, OutboundMetrics* out) {
+    pthread_mutex_lock(&metrics->mutex);
+    *out = metrics->outbound;
+    pthread_mutex_unlock(&metrics->mutex);
+}
+
+int metrics_format(const PoolMetrics* sample, char* buf, size_t size) {
+    return snprintf(buf, size,
+                    "METRICS workers=%d target=%d busy=%d depth=%d wait_avg_us=%llu wait_max_us=%llu "
+                    "local=%llu steals=%llu\n",
+                    sample->workers, sample->target_workers, sample->busy_workers, sample->queue_depth,
+                    sample->wait_avg_us, sample->wait_max_us, sample->local_pops, sample->steals);
+}
+
+int metrics_format_outbound(const OutboundMetrics* sample, char* buf, size_t size) {
+    return snprintf(buf, size,
+                    "OUTBOUND clients=%d backlogged=%d queued=%llu max=%llu max_fd=%d dropped=%llu "
+                    "disconnected=%llu\n",
+                    sample->clients, sample->backlogged, sample->queued_bytes, sample->max_bytes,
+                    sample->max_fd, sample->dropped, sample->disconnects);
+}
@@ -0,0 +1,369 @@
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include "out_queue.h"
+
+// 소켓이 받는 만큼만 씀 (블록하지 않음, 끊긴 연결에도 SIGPIPE 없음)
+static ssize_t send_some(int fd, const char* data, size_t len) {
+    ssize_t n;
+    do {
+        n = send(fd, data, len, MSG_NOSIGNAL | MSG_DONTWAIT);
+    } while (n < 0 && errno == EINTR);
+    return n;
+}
+
+SharedFrame* shared_frame_alloc(size_t capacity) {
+    SharedFrame* frame = (SharedFrame*)malloc(sizeof(SharedFrame) + capacity);
+    if (!frame) return NULL;
+    frame->refs = 1;
+    frame->len = 0;
+    frame->capacity = capacity;
+    return frame;
+}
+
+void shared_frame_release(SharedFrame* frame) {
+    if (frame && __atomic_sub_fetch(&frame->refs, 1, __ATOMIC_ACQ_REL) == 0) {
+        free(frame);
+    }
+}
+
+static void free_frame(OutFrame* f) {
+    shared_frame_release(f->shared);
+    free(f);
+}
+
+static void free_frames(OutQueue* q) {
+    OutFrame* f = q->head;
+    while (f) {
+        OutFrame* next = f->next;
+        free_frame(f);
+        f = next;
+    }
+    q->head = q->tail = NULL;
+    q->frames = 0;
+    __atomic_store_n(&q->bytes, 0, __ATOMIC_RELAXED);
+}
+
+// 아직 한 바이트도 보내지 않은 공 상태 프레임을 모두 버림 (더 새로운 상태가 들어옴)
+static int drop_stale_states(OutQueue* q) {
+    int dropped = 0;
+    OutFrame* prev = NULL;
+    OutFrame* f = q->head;
+    while (f) {
+        OutFrame* next = f->next;
+        if (f->kind == OUT_FRAME_STATE && f->sent == 0) {
+            if (prev) prev->next = next;
+            else q->head = next;
+            __atomic_store_n(&q->bytes, q->bytes - f->len, __ATOMIC_RELAXED);
+            q->frames--;
+            free_frame(f);
+            dropped++;
+        } else {
+            prev = f;
+        }
+        f = next;
+    }
+    q->tail = prev;
+    return dropped;
+}
+
+void out_queue_init(OutQueue* q) {
+    pthread_mutex_init(&q->mutex, NULL);
+    q->head = q->tail = NULL;
+    q->bytes = 0;
+    q->frames = 0;
+    q->closed = 1;
+    q->dropped = 0;
+    q->fd = -1;
+    q->generation = 0;
+    q->flush_list = NULL;
+    q->flush_next = NULL;
+    q->flush_queued = 0;
+    q->inflight = 0;
+}
+
+void out_queue_destroy(OutQueue* q) {
+    free_frames(q);
+    pthread_mutex_destroy(&q->mutex);
+}
+
+void out_queue_open(OutQueue* q, int fd, OutFlushList* flush_list) {
+    pthread_mutex_lock(&q->mutex);
+    free_frames(q);
+    q->dropped = 0;
+    q->fd = fd;
+    q->generation++;        // 이전 연결의 전송 완료는 무시됨
+    q->flush_list = flush_list;
+    q->inflight = 0;        // 이전 연결의 배치는 자신의 프레임을 따로 가지고 있음
+    q->closed = 0;
+    // flush_queued는 그대로 둠: 아직 리스트에 있으면 리액터가 꺼낼 때 지움
+    pthread_mutex_unlock(&q->mutex);
+}
+
+void out_queue_close(OutQueue* q) {
+    pthread_mutex_lock(&q->mutex);
+    free_frames(q);
+    q->closed = 1;
+    pthread_mutex_unlock(&q->mutex);
+}
+
+// 플러시 리스트에 큐를 넣음 (비어 있던 리스트면 1: 리액터를 깨워야 함)
+static int flush_list_push(OutFlushList* list, OutQueue* q) {
+    OutQueue* head = __atomic_load_n(&list->head, __ATOMIC_RELAXED);
+    do {
+        q->flush_next = head;
+    } while (!__atomic_compare_exchange_n(&list->head, &head, q, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+    return head == NULL;
+}
+
+// 공통 전송 경로: shared가 있으면 남은 부분을 참조로, 없으면 복사해서 큐에 넣음
+static int queue_send(OutQueue* q, int fd, const char* data, size_t len, SharedFrame* shared,
+                      int kind, size_t limit, SlowConsumerPolicy policy) {
+    pthread_mutex_lock(&q->mutex);
+    if (q->closed) {
+        pthread_mutex_unlock(&q->mutex);
+        return 0;
+    }
+
+    // 앞선 프레임이 없으면 바로 전송 (대부분의 경우 여기서 끝남)
+    // io_uring 백엔드의 공 상태는 리액터가 모아서 한 번에 전송
+    size_t off = 0;
+    int deferred = q->flush_list && kind == OUT_FRAME_STATE;
+    if (!q->head && !q->inflight && !deferred) {
+        ssize_t n = send_some(fd, data, len);
+        if (n < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                // 연결 오류: 리액터가 읽기 쪽에서 종료를 처리하므로 버림
+                pthread_mutex_unlock(&q->mutex);
+                return 0;
+            }
+            n = 0;
+        }
+        off = (size_t)n;
+        if (off == len) {
+            pthread_mutex_unlock(&q->mutex);
+            return 0;
+        }
+    }
+
+    // 느린 소비자: 최신 상태만 남기거나, 상한을 넘으면 연결 종료
+    int dropped = 0;
+    size_t pending;
+    if (policy == SLOW_CONSUMER_LATEST) {
+        if (kind == OUT_FRAME_STATE) dropped = drop_stale_states(q);
+        pending = q->bytes + (kind == OUT_FRAME_REPLY ? len - off : 0);
+    } else {
+        // 미룬 프레임은 아직 소켓에 써 보지 않았으므로 이전 틱까지 밀린 바이트만 상한과 비교
+        pending = q->bytes + (deferred ? 0 : len - off);
+    }
+    q->dropped += (unsigned long long)dropped;
+
+    if (pending > limit) {
+        free_frames(q);
+        q->closed = 1;
+        shutdown(fd, SHUT_RDWR);    // 리액터가 EOF를 보고 평소처럼 연결을 정리
+        pthread_mutex_unlock(&q->mutex);
+        return OUT_QUEUE_OVERFLOW;
+    }
+
+    // 소켓이 받지 않은 나머지를 큐에 넣음 (EPOLLOUT에서 리액터가 전송)
+    OutFrame* f = (OutFrame*)malloc(sizeof(OutFrame) + (shared ? 0 : len - off));
+    if (!f) {
+        pthread_mutex_unlock(&q->mutex);
+        return dropped;
+    }
+    f->next = NULL;
+    f->len = len - off;
+    f->sent = 0;
+    f->kind = kind;
+    f->shared = shared;
+    if (shared) {
+        __atomic_add_fetch(&shared->refs, 1, __ATOMIC_RELAXED);    // 복사 대신 참조
+        f->data = data + off;
+    } else {
+        memcpy(f->copy, data + off, len - off);
+        f->data = f->copy;
+    }
+
+    if (q->tail) q->tail->next = f;
+    else q->head = f;
+    q->tail = f;
+    q->frames++;
+    __atomic_store_n(&q->bytes, q->bytes + f->len, __ATOMIC_RELAXED);
+
+    // 리액터에 전송 요청 (전송 중인 배치가 있으면 완료 때 이어서 보냄)
+    int wake = 0;
+    OutFlushList* list = q->flush_list;
+    if (list && !q->inflight && !q->flush_queued) {
+        q->flush_queued = 1;
+        wake = flush_list_push(list, q);
+    }
+
+    pthread_mutex_unlock(&q->mutex);
+    if (wake) eventfd_write(list->wake_fd, 1);
+    return dropped;
+}
+
+int out_queue_send(OutQueue* q, int fd, const char* data, size_t len, int kind,
+                   size_t limit, SlowConsumerPolicy policy) {
+    return queue_send(q, fd, data, len, NULL, kind, limit, policy);
+}
+
+int out_queue_send_shared(OutQueue* q, int fd, SharedFrame* frame, int kind,
+                          size_t limit, SlowConsumerPolicy policy) {
+    return queue_send(q, fd, frame->data, frame->len, frame, kind, limit, policy);
+}
+
+void out_queue_flush(OutQueue* q, int fd) {
+    struct iovec iov[OUT_QUEUE_IOV_MAX];
+
+    pthread_mutex_lock(&q->mutex);
+    while (q->head && !q->closed) {
+        // 큐의 앞쪽 프레임들을 한 번의 writev로 전송
+        int count = 0;
+        for (OutFrame* f = q->head; f && count < OUT_QUEUE_IOV_MAX; f = f->next, count++) {
+            iov[count].iov_base = (void*)(f->data + f->sent);
+            iov[count].iov_len = f->len - f->sent;
+        }
+
+        ssize_t n;
+        do {
+            n = writev(fd, iov, count);
+        } while (n < 0 && errno == EINTR);
+        if (n <= 0) break;      // EAGAIN: 다음 EPOLLOUT에서 이어서 전송
+
+        __atomic_store_n(&q->bytes, q->bytes - (size_t)n, __ATOMIC_RELAXED);
+
+        // 다 보낸 프레임은 해제, 마지막 프레임은 보낸 위치만 갱신
+        size_t written = (size_t)n;
+        while (written > 0) {
+            OutFrame* f = q->head;
+            size_t left = f->len - f->sent;
+            if (written < left) {
+                f->sent += written;
+                break;
+            }
+            written -= left;
+            q->head = f->next;
+            if (!q->head) q->tail = NULL;
+            q->frames--;
+            free_frame(f);
+        }
+        if (q->head && q->head->sent > 0) break;    // 소켓 버퍼가 가득 참
+    }
+    pthread_mutex_unlock(&q->mutex);
+}
+
+void out_flush_list_init(OutFlushList* list, int wake_fd) {
+    list->head = NULL;
+    list->wake_fd = wake_fd;
+}
+
+OutQueue* out_flush_list_take(OutFlushList* list) {
+    return __atomic_exchange_n(&list->head, NULL, __ATOMIC_ACQUIRE);
+}
+
+// 큐 앞쪽의 프레임을 배치로 떼어 냄 (mutex를 잡은 상태에서 호출)
+static int fill_batch(OutQueue* q, OutBatch* batch) {
+    int count = 0;
+    OutFrame* last = NULL;
+    for (OutFrame* f = q->head; f && count < OUT_QUEUE_IOV_MAX; f = f->next, count++) {
+        batch->iov[count].iov_base = (void*)(f->data + f->sent);
+        batch->iov[count].iov_len = f->len - f->sent;
+        last = f;
+    }
+
+    batch->queue = q;
+    batch->generation = q->generation;
+    batch->fd = q->fd;
+    batch->count = count;
+    batch->frames = q->head;
+    q->head = last->next;
+    if (!q->head) q->tail = NULL;
+    last->next = NULL;
+    q->inflight = 1;
+    return count;
+}
+
+int out_queue_take(OutQueue* q, OutBatch* batch) {
+    pthread_mutex_lock(&q->mutex);
+    q->flush_queued = 0;
+    int count = 0;
+    if (!q->closed && !q->inflight && q->head) count = fill_batch(q, batch);
+    pthread_mutex_unlock(&q->mutex);
+    return count;
+}
+
+int out_queue_complete(OutBatch* batch, long result) {
+    OutQueue* q = batch->queue;
+    OutFrame* f = batch->frames;
+    batch->frames = NULL;
+
+    pthread_mutex_lock(&q->mutex);
+    if (q->generation != batch->generation || q->closed) {
+        // 연결이 닫혔거나 fd가 새 연결에 재사용됨: 큐의 상태는 이미 초기화됨
+        if (q->generation == batch->generation) q->inflight = 0;
+        pthread_mutex_unlock(&q->mutex);
+        while (f) {
+            OutFrame* next = f->next;
+            free_frame(f);
+            f = next;
+        }
+        return 0;
+    }
+
+    if (result < 0 && result != -EAGAIN && result != -EINTR) {
+        // 전송 오류: 배치를 버림 (리액터가 읽기 쪽에서 연결 종료를 처리)
+        while (f) {
+            OutFrame* next = f->next;
+            __atomic_store_n(&q->bytes, q->bytes - (f->len - f->sent), __ATOMIC_RELAXED);
+            q->frames--;
+            free_frame(f);
+            f = next;
+        }
+        q->inflight = 0;
+        pthread_mutex_unlock(&q->mutex);
+        return 0;
+    }
+
+    // 다 보낸 프레임은 해제
+    size_t written = result > 0 ? (size_t)result : 0;
+    while (f && written >= f->len - f->sent) {
+        OutFrame* next = f->next;
+        size_t left = f->len - f->sent;
+        written -= left;
+        __atomic_store_n(&q->bytes, q->bytes - left, __ATOMIC_RELAXED);
+        q->frames--;
+        free_frame(f);
+        f = next;
+    }
+
+    // 보내지 못한 나머지는 큐 앞쪽으로 되돌림
+    if (f) {
+        f->sent += written;
+        __atomic_store_n(&q->bytes, q->bytes - written, __ATOMIC_RELAXED);
+        OutFrame* last = f;
+        while (last->next) last = last->next;
+        last->next = q->head;
+        if (!q->head) q->tail = last;
+        q->head = f;
+    }
+
+    q->inflight = 0;
+    int count = 0;
+    // 소켓이 조금이라도 받았으면 이어서 전송 (EAGAIN이면 다음 전송 요청까지 대기)
+    if (result > 0 && q->head) count = fill_batch(q, batch);
+    pthread_mutex_unlock(&q->mutex);
+    return count;
+}
+
+void out_queue_stats(OutQueue* q, size_t* bytes, int* frames, unsigned long long* dropped) {
+    pthread_mutex_lock(&q->mutex);
+    *bytes = q->bytes;
+    *frames = q->frames;
+    *dropped = q->dropped;
+    pthread_mutex_unlock(&q->mutex);
+}
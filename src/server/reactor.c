@@ -0,0 +1,501 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <arpa/inet.h>
+#include <sys/eventfd.h>
+#include "reactor.h"
+
+// io_uring 요청 종류 (user_data 하위 2비트)
+#define URING_OP_ACCEPT 0
+#define URING_OP_RECV 1
+#define URING_OP_WAKE 2
+#define URING_OP_SEND 3         // 나머지 비트는 ReactorSend 포인터 (malloc 정렬로 하위 비트가 0)
+#define URING_OP_MASK 3ULL
+
+void set_nonblocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+// io_uring 인스턴스, 수신 버퍼 링, 깨우기용 eventfd 준비 (실패하면 모두 정리하고 -1)
+static int reactor_uring_init(Reactor* reactor) {
+    if (uring_init(&reactor->ring) < 0) return -1;
+    if (uring_setup_buffers(&reactor->ring) < 0) {
+        int saved = errno;
+        uring_destroy(&reactor->ring);
+        errno = saved;
+        return -1;
+    }
+    reactor->wake_fd = eventfd(0, EFD_CLOEXEC);
+    if (reactor->wake_fd < 0) {
+        int saved = errno;
+        uring_destroy(&reactor->ring);
+        errno = saved;
+        return -1;
+    }
+    out_flush_list_init(&reactor->flush, reactor->wake_fd);
+    reactor->backend = IO_BACKEND_URING;
+    return 0;
+}
+
+// 연결 하나의 멀티샷 수신 등록 (제공 버퍼 그룹에서 커널이 버퍼를 고름)
+static void reactor_uring_recv(Reactor* reactor, int fd, unsigned generation) {
+    struct io_uring_sqe* sqe = uring_get_sqe(&reactor->ring);
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = fd;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = URING_BUF_GROUP;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    // fd와 연결 세대를 함께 기록: fd가 새 연결에 재사용된 뒤 도착한 완료를 구분
+    sqe->user_data = ((unsigned long long)(generation & 0x3fffffffu) << 34) |
+                     ((unsigned long long)(unsigned)fd << 2) | URING_OP_RECV;
+}
+
+int reactor_init(Reactor* reactor, int id, SharedContext* ctx, int port, int reuse_port) {
+    struct sockaddr_in servaddr;
+
+    memset(reactor, 0, sizeof(Reactor));
+    reactor->id = id;
+    reactor->ctx = ctx;
+    reactor->listen_fd = -1;
+    reactor->epoll_fd = -1;
+    reactor->wake_fd = -1;
+    reactor->ring.fd = -1;
+    reactor->backend = IO_BACKEND_EPOLL;
+
+    int ssock = socket(AF_INET, SOCK_STREAM, 0);
+    if (ssock < 0) {
+        perror("socket()");
+        return -1;
+    }
+
+    // 포트 재사용 설정 (리액터가 여럿이면 같은 포트를 SO_REUSEPORT로 공유)
+    int optval = 1;
+    setsockopt(ssock, SOL_SOCKET, SO_REUSEADDR, &optval, sizeof(optval));
+    if (reuse_port && setsockopt(ssock, SOL_SOCKET, SO_REUSEPORT, &optval, sizeof(optval)) < 0) {
+        perror("setsockopt(SO_REUSEPORT)");
+        close(ssock);
+        return -1;
+    }
+
+    // 서버 주소 구조체 초기화 및 설정
+    memset(&servaddr, 0, sizeof(servaddr));
+    servaddr.sin_family = AF_INET;                 // IPv4
+    servaddr.sin_addr.s_addr = htonl(INADDR_ANY);  // 모든 IP에서의 접속 허용
+    servaddr.sin_port = htons(port);               // 포트 번호
+
+    // IP/포트 바인딩 후 연결 대기 상태 진입
+    if (bind(ssock, (struct sockaddr *)&servaddr, sizeof(servaddr)) < 0) {
+        perror("bind() :");
+        close(ssock);
+        return -1;
+    }
+    if (listen(ssock, SOMAXCONN) < 0) {
+        perror("listen() : ");
+        close(ssock);
+        return -1;
+    }
+
+    reactor->listen_fd = ssock;
+
+    // io_uring을 요청했으면 먼저 시도하고, 안 되면 epoll 사용
+    if (ctx->config.io_backend == IO_BACKEND_URING) {
+        if (reactor_uring_init(reactor) == 0) return 0;     // 소켓은 블로킹 유지 (대기는 io_uring이 처리)
+        printf(COLOR_YELLOW "[Reactor %d] io_uring unavailable (%s), falling back to epoll" COLOR_RESET,
+               id, strerror(errno));
+    }
+
+    set_nonblocking(ssock);
+
+    int epfd = epoll_create1(0);
+    if (epfd < 0) {
+        perror("epoll_create1");
+        close(ssock);
+        reactor->listen_fd = -1;
+        return -1;
+    }
+
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.fd = ssock;
+    epoll_ctl(epfd, EPOLL_CTL_ADD, ssock, &ev);
+
+    reactor->epoll_fd = epfd;
+    return 0;
+}
+
+void reactor_destroy(Reactor* reactor) {
+    if (reactor->backend == IO_BACKEND_URING) {
+        uring_destroy(&reactor->ring);      // 진행 중인 요청은 커널이 취소
+
+        // 완료되지 않은 전송의 프레임 반환
+        ReactorSend* send = reactor->all_sends;
+        while (send) {
+            ReactorSend* next = send->next_all;
+            if (send->active) out_queue_complete(&send->batch, -ECANCELED);
+            free(send);
+            send = next;
+        }
+        reactor->all_sends = NULL;
+        reactor->free_sends = NULL;
+    }
+    if (reactor->wake_fd >= 0) close(reactor->wake_fd);
+    if (reactor->listen_fd >= 0) close(reactor->listen_fd);
+    if (reactor->epoll_fd >= 0) close(reactor->epoll_fd);
+    reactor->wake_fd = -1;
+    reactor->listen_fd = -1;
+    reactor->epoll_fd = -1;
+}
+
+// 모아 둔 연결 토큰을 워커 inbox에 넣음 (토큰에는 버퍼가 없으므로 풀이 중지되면 그냥 버림)
+static void flush_pending_tokens(Reactor* reactor) {
+    if (reactor->pending_count > 0) {
+        worker_pool_submit(reactor->ctx->worker_pool, reactor->pending, reactor->pending_count);
+        reactor->pending_count = 0;
+    }
+}
+
+// 명령을 연결의 메일박스에 넣고, 메일박스가 쉬고 있었으면 토큰을 예약
+static int queue_to_mailbox(Reactor* reactor, Mailbox* box, const Task* task, int use_reserve) {
+    if (!mailbox_push(box, task, use_reserve)) return 0;
+    if (mailbox_schedule(box)) {
+        box->scheduled_ns = metrics_now_ns();   // 토큰 대기 시간 측정 시작
+        Task* token = &reactor->pending[reactor->pending_count++];
+        token->fd = task->fd;
+        token->length = 0;
+        token->data = NULL;
+        if (reactor->pending_count == TASK_QUEUE_BATCH) flush_pending_tokens(reactor);
+    }
+    return 1;
+}
+
+// 새 연결 등록: 메일박스, 클라이언트 테이블, 이벤트 등록, 초기 공 생성
+static void reactor_add_connection(Reactor* reactor, int csock, struct sockaddr_in* cliaddr) {
+    SharedContext* ctx = reactor->ctx;
+    int uring = reactor->backend == IO_BACKEND_URING;
+
+    Mailbox* box = mailbox_get(ctx->mailboxes, csock);
+    // 같은 fd를 쓰던 이전 연결의 종료 표시 해제, 송신 큐 열기
+    if (box) mailbox_open(box, csock, uring ? &reactor->flush : NULL);
+    pthread_mutex_lock(&ctx->client_list_manager->mutex_client);
+    if (!box || add_client(ctx->client_list_manager, csock, *cliaddr, reactor->epoll_fd) < 0) {
+        pthread_mutex_unlock(&ctx->client_list_manager->mutex_client);
+        if (box) out_queue_close(&box->out);
+        // 최대 접속 수 초과: 알리고 바로 종료
+        char full_msg[] = "Server full\n";
+        send(csock, full_msg, strlen(full_msg), MSG_NOSIGNAL);
+        close(csock);
+        return;
+    }
+    log_client_connect(csock, cliaddr);
+    pthread_mutex_unlock(&ctx->client_list_manager->mutex_client);
+
+    if (uring) {
+        reactor_uring_recv(reactor, csock, box->out.generation);
+    } else {
+        set_nonblocking(csock);
+        struct epoll_event ev;
+        ev.events = EPOLLIN | EPOLLOUT | EPOLLET;    // EPOLLOUT: 송신 큐에 남은 바이트를 이어서 전송
+        ev.data.fd = csock;
+        epoll_ctl(reactor->epoll_fd, EPOLL_CTL_ADD, csock, &ev);
+    }
+    if (ctx->config.apply_at_tick) {
+        // 초기 공 생성은 다음 틱에 시뮬레이션 스레드가 적용 (이 연결의 명령은 그 뒤에 적용)
+        WorldCommand wc = { csock, START_BALL_COUNT, START_BALL_RADIUS, CMD_ADD };
+        submit_world_command_wait(ctx, REACTOR_COMMAND_RING, &wc);
+        mark_world_command_fence(ctx, box, REACTOR_COMMAND_RING);
+    } else {
+        // 초기 공 생성은 워커가 처리 (리액터는 공 리스트 잠금을 잡지 않음, 이 연결의 명령은 그 뒤에 처리)
+        Task task = { csock, TASK_CONNECT, NULL };
+        queue_to_mailbox(reactor, box, &task, 1);
+    }
+}
+
+// 대기 중인 연결을 모두 받음 (접속이 몰려도 backlog가 넘치지 않도록)
+static void reactor_accept(Reactor* reactor) {
+    struct sockaddr_in cliaddr;
+    socklen_t clen;
+    int csock;
+
+    while (clen = sizeof(cliaddr),
+           (csock = accept(reactor->listen_fd, (struct sockaddr*)&cliaddr, &clen)) >= 0) {
+        reactor_add_connection(reactor, csock, &cliaddr);
+    }
+}
+
+// 연결 종료: 메일박스에 종료 작업을 넣어 앞선 명령이 모두 처리된 뒤 워커가 정리하게 함
+static void reactor_disconnect(Reactor* reactor, int fd) {
+    Mailbox* box = mailbox_get(reactor->ctx->mailboxes, fd);
+    if (!box || box->eof_queued) return;
+
+    printf(COLOR_RED "[Server] Client disconnected (fd=%d)\n" COLOR_RESET, fd);
+
+    Task task = { fd, TASK_DISCONNECT, NULL };
+    if (queue_to_mailbox(reactor, box, &task, 1)) {     // 예약 슬롯 사용: 가득 차도 들어감
+        box->eof_queued = 1;
+    }
+}
+
+// 받은 바이트에서 완성된 명령을 하나씩 꺼내 슬랩 버퍼로 복사한 뒤 메일박스에 넣음
+// (토큰은 라운드가 끝날 때 한 번에 워커에게 넘김)
+static void reactor_queue_commands(Reactor* reactor, Mailbox* box, int fd) {
+    SharedContext* ctx = reactor->ctx;
+    char* cmd;
+    int len;
+
+    while ((len = input_buffer_next(&box->input, &cmd)) != INPUT_NONE) {
+        if (len == INPUT_TOO_LONG) {
+            char long_msg[] = "Command too long\n";
+            client_send(ctx, fd, long_msg, strlen(long_msg), OUT_FRAME_REPLY);
+            continue;
+        }
+
+        char* data = buffer_slab_alloc(ctx->buffer_slab, (size_t)len + 1);
+        if (!data) continue;
+        memcpy(data, cmd, (size_t)len + 1);     // '\0' 포함
+
+        Task task = { fd, len, data };
+        if (!queue_to_mailbox(reactor, box, &task, 0)) {
+            // 이 연결의 명령이 밀려 있음: 알리고 버림
+            buffer_slab_free(ctx->buffer_slab, data);
+            char busy_msg[] = "Server busy\n";
+            client_send(ctx, fd, busy_msg, strlen(busy_msg), OUT_FRAME_REPLY);
+            continue;
+        }
+        printf(COLOR_CYAN "[Server] Enqueued task for fd %d : %s\n" COLOR_RESET, fd, cmd);
+    }
+}
+
+// 엣지 트리거이므로 EAGAIN이 나올 때까지 읽음 (남은 바이트가 다음 패킷까지 묶이지 않도록)
+static void reactor_read(Reactor* reactor, int fd) {
+    Mailbox* box = mailbox_get(reactor->ctx->mailboxes, fd);
+    if (!box || box->eof_queued || mailbox_is_closed(box)) return;
+
+    for (;;) {
+        size_t avail;
+        char* dst = input_buffer_space(&box->input, &avail);
+        ssize_t len = recv(fd, dst, avail, 0);
+
+        if (len > 0) {
+            input_buffer_commit(&box->input, (size_t)len);
+            reactor_queue_commands(reactor, box, fd);
+            continue;
+        }
+        if (len < 0 && errno == EINTR) continue;
+        if (len < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return;
+
+        // 0: 상대가 연결을 닫음, 그 외: 소켓 오류 (미완성 명령은 버림)
+        reactor_disconnect(reactor, fd);
+        return;
+    }
+}
+
+static void reactor_uring_accept(Reactor* reactor) {
+    struct io_uring_sqe* sqe = uring_get_sqe(&reactor->ring);
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = reactor->listen_fd;
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->user_data = URING_OP_ACCEPT;
+}
+
+static void reactor_uring_wait_wake(Reactor* reactor) {
+    struct io_uring_sqe* sqe = uring_get_sqe(&reactor->ring);
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = reactor->wake_fd;
+    sqe->addr = (unsigned long long)(unsigned long)&reactor->wake_value;
+    sqe->len = sizeof(reactor->wake_value);
+    sqe->user_data = URING_OP_WAKE;
+}
+
+static void reactor_uring_submit_send(Reactor* reactor, ReactorSend* send) {
+    memset(&send->msg, 0, sizeof(send->msg));
+    send->msg.msg_iov = send->batch.iov;
+    send->msg.msg_iovlen = (size_t)send->batch.count;
+    send->active = 1;
+
+    struct io_uring_sqe* sqe = uring_get_sqe(&reactor->ring);
+    sqe->opcode = IORING_OP_SENDMSG;
+    sqe->fd = send->batch.fd;
+    sqe->addr = (unsigned long long)(unsigned long)&send->msg;
+    sqe->msg_flags = MSG_NOSIGNAL;
+    sqe->user_data = (unsigned long long)(unsigned long)send | URING_OP_SEND;
+    reactor->sends++;
+}
+
+// 송신 큐의 앞쪽 프레임을 벡터 전송 하나로 제출
+static void reactor_uring_flush(Reactor* reactor, OutQueue* q) {
+    ReactorSend* send = reactor->free_sends;
+    if (send) {
+        reactor->free_sends = send->next_free;
+    } else {
+        send = (ReactorSend*)calloc(1, sizeof(ReactorSend));
+        if (!send) return;      // 다음 전송 요청 때 다시 시도
+        send->next_all = reactor->all_sends;
+        reactor->all_sends = send;
+    }
+
+    if (out_queue_take(q, &send->batch) > 0) {
+        reactor_uring_submit_send(reactor, send);
+    } else {
+        send->next_free = reactor->free_sends;
+        reactor->free_sends = send;
+    }
+}
+
+// 받은 바이트를 입력 버퍼로 옮기고 완성된 명령을 메일박스에 넣음
+static void reactor_uring_received(Reactor* reactor, Mailbox* box, int fd, const char* data, size_t len) {
+    while (len > 0) {
+        size_t avail;
+        char* dst = input_buffer_space(&box->input, &avail);
+        size_t n = len < avail ? len : avail;
+        memcpy(dst, data, n);
+        input_buffer_commit(&box->input, n);
+        reactor_queue_commands(reactor, box, fd);
+        data += n;
+        len -= n;
+    }
+}
+
+static void reactor_uring_complete(Reactor* reactor, const struct io_uring_cqe* cqe) {
+    SharedContext* ctx = reactor->ctx;
+    unsigned long long data = cqe->user_data;
+    int more = (cqe->flags & IORING_CQE_F_MORE) != 0;
+
+    switch (data & URING_OP_MASK) {
+        case URING_OP_ACCEPT:
+            if (cqe->res >= 0) {
+                struct sockaddr_in cliaddr;
+                socklen_t clen = sizeof(cliaddr);
+                memset(&cliaddr, 0, sizeof(cliaddr));
+                getpeername(cqe->res, (struct sockaddr*)&cliaddr, &clen);
+                reactor_add_connection(reactor, cqe->res, &cliaddr);
+            } else if (cqe->res != -ECANCELED) {
+                printf(COLOR_RED "[Reactor %d] accept: %s" COLOR_RESET, reactor->id, strerror(-cqe->res));
+            }
+            if (!more) reactor_uring_accept(reactor);    // 멀티샷이 끝나면 다시 등록
+            break;
+
+        case URING_OP_RECV:
+            {
+                int fd = (int)(unsigned)((data >> 2) & 0xffffffffULL);
+                unsigned generation = (unsigned)(data >> 34);
+                unsigned bid = 0;
+                char* buf = (cqe->flags & IORING_CQE_F_BUFFER) ? uring_buffer(&reactor->ring, cqe, &bid) : NULL;
+
+                Mailbox* box = mailbox_get(ctx->mailboxes, fd);
+                int current = box &&
+                    (__atomic_load_n(&box->out.generation, __ATOMIC_RELAXED) & 0x3fffffffu) == generation &&
+                    !box->eof_queued && !mailbox_is_closed(box);
+
+                if (current && cqe->res > 0) {
+                    reactor_uring_received(reactor, box, fd, buf, (size_t)cqe->res);
+                }
+                if (buf) uring_buffer_recycle(&reactor->ring, bid);
+                if (!current) break;    // 이미 끝난 연결의 완료: 다시 등록하지 않음
+
+                if (cqe->res > 0 || cqe->res == -ENOBUFS) {
+                    if (!more) reactor_uring_recv(reactor, fd, generation);
+                } else {
+                    // 0: 상대가 연결을 닫음, 그 외: 소켓 오류 (미완성 명령은 버림)
+                    reactor_disconnect(reactor, fd);
+                }
+            }
+            break;
+
+        case URING_OP_WAKE:
+            {
+                reactor_uring_wait_wake(reactor);
+                // 리스트에 쌓인 큐마다 벡터 전송 하나 (제출은 이 라운드 끝에 한 번)
+                OutQueue* q = out_flush_list_take(&reactor->flush);
+                while (q) {
+                    OutQueue* next = q->flush_next;     // take 이후에는 다시 리스트에 들어갈 수 있음
+                    reactor_uring_flush(reactor, q);
+                    q = next;
+                }
+            }
+            break;
+
+        case URING_OP_SEND:
+            {
+                ReactorSend* send = (ReactorSend*)(unsigned long)(data & ~URING_OP_MASK);
+                send->active = 0;
+                if (out_queue_complete(&send->batch, cqe->res) > 0) {
+                    reactor_uring_submit_send(reactor, send);   // 남은 바이트나 새로 쌓인 프레임
+                } else {
+                    send->next_free = reactor->free_sends;
+                    reactor->free_sends = send;
+                }
+            }
+            break;
+    }
+}
+
+// io_uring 이벤트 루프: 완료를 모두 처리한 뒤 새 요청을 io_uring_enter() 한 번으로 제출하고 대기
+static void reactor_uring_loop(Reactor* reactor) {
+    reactor_uring_accept(reactor);
+    reactor_uring_wait_wake(reactor);
+
+    while (keep_running) {
+        if (uring_submit_and_wait(&reactor->ring, 1, REACTOR_WAIT_TIMEOUT_MS) < 0) {
+            if (errno == EINTR) continue;
+            perror("io_uring_enter");
+            break;
+        }
+
+        struct io_uring_cqe* cqe;
+        while ((cqe = uring_peek_cqe(&reactor->ring)) != NULL) {
+            struct io_uring_cqe copy = *cqe;
+            uring_cqe_seen(&reactor->ring);     // 처리 중 SQE 제출로 CQ가 넘치지 않도록 먼저 반환
+            reactor_uring_complete(reactor, &copy);
+        }
+
+        flush_pending_tokens(reactor);
+    }
+
+    printf("[Reactor %d] io_uring: %llu enters, %llu sends\n",
+           reactor->id, reactor->ring.enters, reactor->sends);
+}
+
+void* reactor_thread(void* arg) {
+    Reactor* reactor = (Reactor*)arg;
+    SharedContext* ctx = reactor->ctx;
+    struct epoll_event events[REACTOR_MAX_EVENTS];
+    affinity_pin_self(&ctx->config.affinity, ROLE_REACTOR);
+
+    reactor->pending_count = 0;
+
+    if (reactor->backend == IO_BACKEND_URING) {
+        reactor_uring_loop(reactor);
+        printf(COLOR_GREEN "[Reactor %d] Thread Shutting down..." COLOR_RESET, reactor->id);
+        return NULL;
+    }
+
+    while (keep_running) {
+        int nready = epoll_wait(reactor->epoll_fd, events, REACTOR_MAX_EVENTS, REACTOR_WAIT_TIMEOUT_MS);
+        if (nready == -1) {
+            if (errno == EINTR) continue;
+            perror("epoll_wait");
+            break;
+        }
+
+        for (int i = 0; i < nready; i++) {
+            int fd = events[i].data.fd;
+
+            if (fd == reactor->listen_fd) {
+                reactor_accept(reactor);
+            } else {
+                if (events[i].events & EPOLLOUT) {
+                    Mailbox* box = mailbox_get(ctx->mailboxes, fd);
+                    if (box) out_queue_flush(&box->out, fd);
+                }
+                if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+                    reactor_read(reactor, fd);
+                }
+            }
+        }
+
+        flush_pending_tokens(reactor);
+    }
+
+    printf(COLOR_GREEN "[Reactor %d] Thread Shutting down..." COLOR_RESET, reactor->id);
+    return NULL;
+}
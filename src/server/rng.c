@@ -0,0 +1,85 @@
+#include <time.h>
+#include "rng.h"
+
+static _Thread_local RngState rng_state;
+static uint64_t rng_seed_counter;   // 스레드마다 다른 시드를 만들기 위한 전역 카운터
+
+static inline uint32_t rotl32(uint32_t x, int k) {
+    return (x << k) | (x >> (32 - k));
+}
+
+static inline uint64_t splitmix64(uint64_t* x) {
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+void rng_seed(uint64_t seed) {
+    RngState* st = &rng_state;
+    for (int lane = 0; lane < RNG_LANES; lane++) {
+        uint64_t a = splitmix64(&seed);
+        uint64_t b = splitmix64(&seed);
+        st->s[0][lane] = (uint32_t)a;
+        st->s[1][lane] = (uint32_t)(a >> 32);
+        st->s[2][lane] = (uint32_t)b;
+        st->s[3][lane] = (uint32_t)(b >> 32) | 1u;  // 상태 전체가 0이 되지 않도록
+    }
+    st->next_lane = 0;
+    st->seeded = 1;
+}
+
+// 처음 사용하는 스레드는 시간 + 전역 카운터로 시드
+static inline RngState* rng_get(void) {
+    RngState* st = &rng_state;
+    if (!st->seeded) {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        uint64_t n = __atomic_add_fetch(&rng_seed_counter, 1, __ATOMIC_RELAXED);
+        rng_seed(((uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec) ^ (n * 0xD1B54A32D192ED03ULL));
+    }
+    return st;
+}
+
+uint32_t rng_next(void) {
+    RngState* st = rng_get();
+    int l = st->next_lane;
+    st->next_lane = (l + 1) % RNG_LANES;
+
+    // xoshiro128**
+    uint32_t result = rotl32(st->s[1][l] * 5, 7) * 9;
+    uint32_t t = st->s[1][l] << 9;
+    st->s[2][l] ^= st->s[0][l];
+    st->s[3][l] ^= st->s[1][l];
+    st->s[1][l] ^= st->s[2][l];
+    st->s[0][l] ^= st->s[3][l];
+    st->s[2][l] ^= t;
+    st->s[3][l] = rotl32(st->s[3][l], 11);
+    return result;
+}
+
+void rng_fill(uint32_t* out, int n) {
+    RngState* st = rng_get();
+    uint32_t* s0 = st->s[0];
+    uint32_t* s1 = st->s[1];
+    uint32_t* s2 = st->s[2];
+    uint32_t* s3 = st->s[3];
+    int i = 0;
+
+    // 레인끼리 의존성이 없으므로 안쪽 루프가 벡터화됨
+    for (; i + RNG_LANES <= n; i += RNG_LANES) {
+        for (int l = 0; l < RNG_LANES; l++) {
+            out[i + l] = rotl32(s1[l] * 5, 7) * 9;
+            uint32_t t = s1[l] << 9;
+            s2[l] ^= s0[l];
+            s3[l] ^= s1[l];
+            s1[l] ^= s2[l];
+            s0[l] ^= s3[l];
+            s2[l] ^= t;
+            s3[l] = rotl32(s3[l], 11);
+        }
+    }
+    for (; i < n; i++) {
+        out[i] = rng_next();
+    }
+}
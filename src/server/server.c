@@ -1,7 +1,9 @@
+#include <getopt.h>
+#include <sched.h>
 #include "server.h"
 
 // 전역 변수 정의
-TaskQueue* global_task_queue = NULL;
+WorkerPool* global_worker_pool = NULL;
 volatile sig_atomic_t keep_running = 1;
 
 /**
@@ -12,7 +14,7 @@ volatile sig_atomic_t keep_running = 1;
  * @param count 생성/삭제된 공의 개수
  */
 
-SharedContext* manager_init() {
+SharedContext* manager_init(const ServerConfig* config) {
     // 로그 파일 초기화 (파일 내용 지우기)
     FILE* log_file = fopen("logs/ball_operations.log", "w");
     if (log_file) {
@@ -30,24 +32,67 @@ SharedContext* manager_init() {
 
     arg->ball_list_manager = malloc(sizeof(BallListManager));
     arg->client_list_manager = malloc(sizeof(ClientListManager));
-    arg->task_queue = malloc(sizeof(TaskQueue));
-
-
-    if (!arg->ball_list_manager || !arg->client_list_manager || !arg->task_queue) {
+    arg->worker_pool = malloc(sizeof(WorkerPool));
+    arg->buffer_slab = malloc(sizeof(BufferSlab));
+    arg->command_rings = malloc(sizeof(CommandRing) * config->max_workers);
+    arg->reactor_commands = malloc(sizeof(SharedCommandRing));
+    arg->mailboxes = malloc(sizeof(MailboxTable));
+    arg->metrics = malloc(sizeof(ServerMetrics));
+    arg->udp = malloc(sizeof(UdpChannel));
+
+    if (!arg->ball_list_manager || !arg->client_list_manager || !arg->worker_pool || !arg->buffer_slab ||
+        !arg->command_rings || !arg->reactor_commands || !arg->mailboxes || !arg->metrics || !arg->udp) {
         perror("malloc() : internal");
         free(arg->ball_list_manager);
         free(arg->client_list_manager);
-        free(arg->task_queue); 
+        free(arg->worker_pool);
+        free(arg->buffer_slab);
+        free(arg->command_rings);
+        free(arg->reactor_commands);
+        free(arg->mailboxes);
+        free(arg->metrics);
+        free(arg->udp);
         free(arg);
         return NULL;
     }
 
     ball_manager_init(arg->ball_list_manager);
-    client_list_manager_init(arg->client_list_manager);
-    task_queue_init(arg->task_queue);
+    client_list_manager_init(arg->client_list_manager, config->max_clients);
+    buffer_slab_init(arg->buffer_slab);
+    for (int i = 0; i < config->max_workers; i++) {
+        command_ring_init(&arg->command_rings[i]);
+    }
+    shared_command_ring_init(arg->reactor_commands);
+    mailbox_table_init(arg->mailboxes);
+    metrics_init(arg->metrics);
+    if (worker_pool_init(arg->worker_pool, config->max_workers, config->min_workers) < 0) {
+        ball_manager_destroy(arg->ball_list_manager);
+        client_list_manager_destroy(arg->client_list_manager);
+        buffer_slab_destroy(arg->buffer_slab);
+        free(arg->ball_list_manager);
+        free(arg->client_list_manager);
+        free(arg->worker_pool);
+        free(arg->buffer_slab);
+        free(arg->command_rings);
+        free(arg->reactor_commands);
+        mailbox_table_destroy(arg->mailboxes);
+        free(arg->mailboxes);
+        metrics_destroy(arg->metrics);
+        free(arg->metrics);
+        free(arg->udp);
+        free(arg);
+        return NULL;
+    }
+
+    // UDP 상태 채널: 열지 못해도 서버는 TCP만으로 동작 ("u" 명령은 거부됨)
+    if (udp_channel_init(arg->udp, SERVER_PORT) < 0) {
+        printf(COLOR_YELLOW "[UDP] Snapshot channel disabled, ball states are sent over TCP only" COLOR_RESET);
+    }
+    
+    arg->config = *config;
     
     // 전역 변수 초기화
-    global_task_queue = arg->task_queue;
+    global_worker_pool = arg->worker_pool;
 
     return arg;
 }
@@ -56,11 +101,197 @@ void manager_destroy(SharedContext* arg) {
     if (!arg) return;
     ball_manager_destroy(arg->ball_list_manager);
     client_list_manager_destroy(arg->client_list_manager);
-    task_queue_destroy(arg->task_queue);
+    worker_pool_destroy(arg->worker_pool);
+    free(arg->worker_pool);
+    buffer_slab_destroy(arg->buffer_slab);
+    free(arg->buffer_slab);
+    free(arg->command_rings);
+    free(arg->reactor_commands);
+    mailbox_table_destroy(arg->mailboxes);
+    free(arg->mailboxes);
+    metrics_destroy(arg->metrics);
+    free(arg->metrics);
+    udp_channel_destroy(arg->udp);
+    free(arg->udp);
     free(arg);
     printf(COLOR_GREEN "Freed memory of the SharedContext." COLOR_RESET);
 }
 
+static void print_usage(const char* prog) {
+    printf("Usage : %s [options]\n"
+           "  --sim-threads N   simulation threads per tick (default %d, max %d)\n"
+           "  --no-collisions   disable ball-ball collisions\n"
+           "  --tick-hz N       simulation/broadcast rate in Hz (default %d, max %d)\n"
+           "  --max-catchup N   maximum steps run after a late wakeup (default %d)\n"
+           "  --apply-at-tick   apply commands on the simulation thread at tick boundaries\n"
+           "  --max-clients N   maximum number of connected clients (default %d, max %d)\n"
+           "  --reactors N      network threads, each with its own listening socket (default %d, max %d)\n"
+           "  --affinity R=L    pin role R (reactor, worker, sim, fanout) to CPU list L, e.g. worker=2-5 (repeatable)\n"
+           "  --min-workers N   workers kept running when idle (default %d)\n"
+           "  --max-workers N   workers the pool may grow to under load (default %d, max %d)\n"
+           "  --outbound-limit B  unsent bytes queued per client (default %d, min %d)\n"
+           "  --slow-consumer P   latest (drop stale ball states) or disconnect (default latest)\n"
+           "  --io-backend B      epoll or io_uring (falls back to epoll if unavailable, default epoll)\n",
+           prog, DEFAULT_SIM_THREADS, SIM_POOL_MAX_THREADS,
+           DEFAULT_TICK_HZ, MAX_TICK_HZ, DEFAULT_MAX_CATCHUP,
+           MAX_CLIENTS, CLIENT_TABLE_MAX_CLIENTS,
+           DEFAULT_REACTORS, MAX_REACTORS,
+           DEFAULT_MIN_WORKERS, DEFAULT_MAX_WORKERS, MAX_WORKERS,
+           OUT_QUEUE_DEFAULT_LIMIT, OUT_QUEUE_MIN_LIMIT);
+}
+
+int parse_server_config(int argc, char** argv, ServerConfig* config) {
+    static const struct option options[] = {
+        {"sim-threads", required_argument, NULL, 't'},
+        {"no-collisions", no_argument,     NULL, 'C'},
+        {"tick-hz",     required_argument, NULL, 'r'},
+        {"max-catchup", required_argument, NULL, 'c'},
+        {"apply-at-tick", no_argument,     NULL, 'A'},
+        {"max-clients", required_argument, NULL, 'm'},
+        {"reactors",    required_argument, NULL, 'R'},
+        {"affinity",    required_argument, NULL, 'P'},
+        {"min-workers", required_argument, NULL, 'w'},
+        {"max-workers", required_argument, NULL, 'W'},
+        {"outbound-limit", required_argument, NULL, 'o'},
+        {"slow-consumer", required_argument, NULL, 'S'},
+        {"io-backend",  required_argument, NULL, 'B'},
+        {"help",        no_argument,       NULL, 'h'},
+        {NULL, 0, NULL, 0}
+    };
+
+    config->sim_threads = DEFAULT_SIM_THREADS;
+    config->collisions = 1;
+    config->tick_hz = DEFAULT_TICK_HZ;
+    config->max_catchup = DEFAULT_MAX_CATCHUP;
+    config->apply_at_tick = 0;
+    config->max_clients = MAX_CLIENTS;
+    config->reactors = DEFAULT_REACTORS;
+    config->min_workers = DEFAULT_MIN_WORKERS;
+    config->max_workers = DEFAULT_MAX_WORKERS;
+    config->outbound_limit = OUT_QUEUE_DEFAULT_LIMIT;
+    config->slow_consumer = SLOW_CONSUMER_LATEST;
+    config->io_backend = IO_BACKEND_EPOLL;
+    affinity_layout_init(&config->affinity);
+
+    int opt;
+    while ((opt = getopt_long(argc, argv, "h", options, NULL)) != -1) {
+        switch (opt) {
+            case 't':
+                config->sim_threads = atoi(optarg);
+                if (config->sim_threads < 1 || config->sim_threads > SIM_POOL_MAX_THREADS) {
+                    fprintf(stderr, "Invalid --sim-threads value: %s\n", optarg);
+                    print_usage(argv[0]);
+                    return -1;
+                }
+                break;
+            case 'C':
+                config->collisions = 0;
+                break;
+            case 'r':
+                config->tick_hz = atoi(optarg);
+                if (config->tick_hz < 1 || config->tick_hz > MAX_TICK_HZ) {
+                    fprintf(stderr, "Invalid --tick-hz value: %s\n", optarg);
+                    print_usage(argv[0]);
+                    return -1;
+                }
+                break;
+            case 'c':
+                config->max_catchup = atoi(optarg);
+                if (config->max_catchup < 1) {
+                    fprintf(stderr, "Invalid --max-catchup value: %s\n", optarg);
+                    print_usage(argv[0]);
+                    return -1;
+                }
+                break;
+            case 'A':
+                config->apply_at_tick = 1;
+                break;
+            case 'm':
+                config->max_clients = atoi(optarg);
+                if (config->max_clients < 1 || config->max_clients > CLIENT_TABLE_MAX_CLIENTS) {
+                    fprintf(stderr, "Invalid --max-clients value: %s\n", optarg);
+                    print_usage(argv[0]);
+                    return -1;
+                }
+                break;
+            case 'R':
+                config->reactors = atoi(optarg);
+                if (config->reactors < 1 || config->reactors > MAX_REACTORS) {
+                    fprintf(stderr, "Invalid --reactors value: %s\n", optarg);
+                    print_usage(argv[0]);
+                    return -1;
+                }
+                break;
+            case 'P':
+                if (affinity_parse(&config->affinity, optarg) < 0) {
+                    print_usage(argv[0]);
+                    return -1;
+                }
+                break;
+            case 'w':
+                config->min_workers = atoi(optarg);
+                if (config->min_workers < 1 || config->min_workers > MAX_WORKERS) {
+                    fprintf(stderr, "Invalid --min-workers value: %s\n", optarg);
+                    print_usage(argv[0]);
+                    return -1;
+                }
+                break;
+            case 'W':
+                config->max_workers = atoi(optarg);
+                if (config->max_workers < 1 || config->max_workers > MAX_WORKERS) {
+                    fprintf(stderr, "Invalid --max-workers value: %s\n", optarg);
+                    print_usage(argv[0]);
+                    return -1;
+                }
+                break;
+            case 'o':
+                {
+                    long long limit = atoll(optarg);
+                    if (limit < OUT_QUEUE_MIN_LIMIT) {
+                        fprintf(stderr, "Invalid --outbound-limit value: %s\n", optarg);
+                        print_usage(argv[0]);
+                        return -1;
+                    }
+                    config->outbound_limit = (size_t)limit;
+                }
+                break;
+            case 'S':
+                if (strcmp(optarg, "latest") == 0) {
+                    config->slow_consumer = SLOW_CONSUMER_LATEST;
+                } else if (strcmp(optarg, "disconnect") == 0) {
+                    config->slow_consumer = SLOW_CONSUMER_DISCONNECT;
+                } else {
+                    fprintf(stderr, "Invalid --slow-consumer value: %s\n", optarg);
+                    print_usage(argv[0]);
+                    return -1;
+                }
+                break;
+            case 'B':
+                if (strcmp(optarg, "epoll") == 0) {
+                    config->io_backend = IO_BACKEND_EPOLL;
+                } else if (strcmp(optarg, "io_uring") == 0) {
+                    config->io_backend = IO_BACKEND_URING;
+                } else {
+                    fprintf(stderr, "Invalid --io-backend value: %s\n", optarg);
+                    print_usage(argv[0]);
+                    return -1;
+                }
+                break;
+            default:
+                print_usage(argv[0]);
+                return -1;
+        }
+    }
+
+    if (config->min_workers > config->max_workers) {
+        fprintf(stderr, "--min-workers (%d) must not exceed --max-workers (%d)\n",
+                config->min_workers, config->max_workers);
+        print_usage(argv[0]);
+        return -1;
+    }
+    return 0;
+}
+
 // 명령 파싱 함수: a:3:30, d:2, w, s, x 등 다양한 형태 지원
 char parseCommand(const char* cmdStr, int* ball_count, int* radius) {
     if (!cmdStr || !ball_count || !radius) return 0;
@@ -92,62 +323,132 @@ char parseCommand(const char* cmdStr, int* ball_count, int* radius) {
     return 0;
 }
 
-void broadcast_ball_state(ClientListManager* client_mgr, BallListManager* ball_mgr) {
-    ClientNode* curr = client_mgr->head;
-    int n = 0;
+// 송신 결과를 지표에 반영 (느린 소비자 종료, 버려진 상태 프레임)
+static void count_send_result(SharedContext* ctx, int fd, int rc) {
+    if (rc == OUT_QUEUE_OVERFLOW) {
+        __atomic_add_fetch(&ctx->metrics->slow_disconnects, 1, __ATOMIC_RELAXED);
+        printf(COLOR_YELLOW "[Server] Disconnecting slow client (fd=%d): outbound queue over %zu bytes" COLOR_RESET,
+               fd, ctx->config.outbound_limit);
+        log_client_disconnect(fd, "Outbound queue limit exceeded");
+    } else if (rc > 0) {
+        __atomic_add_fetch(&ctx->metrics->states_dropped, (unsigned long long)rc, __ATOMIC_RELAXED);
+    }
+}
 
-    while (curr) {
+void client_send(SharedContext* ctx, int fd, const char* data, size_t len, int kind) {
+    Mailbox* box = mailbox_get(ctx->mailboxes, fd);
+    if (!box) return;
 
-        // owner_id == csock fd
-        char* data = serialize_ball_list(ball_mgr, curr->ctx.csock);
-        
-        if((data != NULL) && (strlen(data) > 0))
-        {
-            n = send(curr->ctx.csock, data, strlen(data), 0);
-        }
-        else {
-            curr = curr->next;
-            continue;  // 클라이언트는 접속했지만 공이 없는 경우
-        }
+    int rc = out_queue_send(&box->out, fd, data, len, kind,
+                            ctx->config.outbound_limit, ctx->config.slow_consumer);
+    count_send_result(ctx, fd, rc);
+}
 
-        if(n < 0)
-        {
-            perror("send()");
-            printf(COLOR_RED "[Server] Failed to send data to client (fd=%d)\n" COLOR_RESET, curr->ctx.csock);
-            free(data);
-            curr = curr->next;
-            continue;
-        }
-        else if(n == 0)
-        {
-            printf(COLOR_RED "[Server] Sent 0 bytes to client (fd=%d)\n" COLOR_RESET, curr->ctx.csock);
-            free(data);
-            curr = curr->next;
+void client_send_frame(SharedContext* ctx, int fd, SharedFrame* frame, int kind) {
+    Mailbox* box = mailbox_get(ctx->mailboxes, fd);
+    if (!box) return;
+
+    int rc = out_queue_send_shared(&box->out, fd, frame, kind,
+                                   ctx->config.outbound_limit, ctx->config.slow_consumer);
+    count_send_result(ctx, fd, rc);
+}
+
+// 틱마다 스냅샷을 한 번만 인코딩하여 모든 클라이언트에 참조로 전송
+void broadcast_ball_state_all(SharedContext* ctx, const WorldSnapshot* snap) {
+    ClientListManager* client_mgr = ctx->client_list_manager;
+    if (!snap) return;
+
+    // 인코딩은 잠금 없이 스냅샷에서 수행 (공 하나당 최대 BALL_TEXT_MAX 바이트, 빈 월드도 1바이트)
+    size_t capacity = (size_t)snap->count * BALL_TEXT_MAX;
+    SharedFrame* frame = shared_frame_alloc(capacity > 0 ? capacity : 1);
+    if (!frame) {
+        perror(COLOR_RED "[Error] Frame allocation failed" COLOR_RESET);
+        return;
+    }
+    frame->len = encode_snapshot_all(snap, frame->data);
+    // 빈 월드도 전송: 0바이트는 TCP에서 보이지 않으므로 구분자 하나 (클라이언트는 공 없음으로 파싱)
+    if (frame->len == 0) frame->data[frame->len++] = '|';
+    int udp_prepared = 0;      // UDP 조각은 UDP 클라이언트가 있을 때 한 번만 만듦
+    int udp_ready = 0;
+
+    pthread_mutex_lock(&client_mgr->mutex_client);
+    // 밀집 배열을 순서대로 순회 (느린 클라이언트의 큐에는 복사 대신 프레임 참조만 쌓임)
+    for (int i = 0; i < client_mgr->client_count; i++) {
+        SocketContext* client = &client_mgr->clients[i];
+        if (client->udp_port == 0) {
+            client_send_frame(ctx, client->csock, frame, OUT_FRAME_STATE);
             continue;
         }
-        free(data);
 
-        curr = curr->next;
+        // UDP 클라이언트: 같은 조각을 TCP 피어 주소의 등록된 포트로 전송 (유실된 틱은 다음 틱이 대신함)
+        // 잠금 중에는 주소만 모으고 sendmmsg()는 잠금 해제 후 수행
+        if (!udp_prepared) {
+            udp_ready = udp_channel_prepare(ctx->udp, frame, snap->tick) >= 0;
+            udp_prepared = 1;
+        }
+        struct sockaddr_in addr = client->cliaddr;
+        addr.sin_port = htons((unsigned short)client->udp_port);
+        if (!udp_ready || udp_channel_add_peer(ctx->udp, &addr) < 0) {
+            client_send_frame(ctx, client->csock, frame, OUT_FRAME_STATE);
+        }
     }
-}
+    pthread_mutex_unlock(&client_mgr->mutex_client);
 
-// 공 리스트를 문자열로 직렬화하여 모든 클라이언트에 전송
-void broadcast_ball_state_all(ClientListManager* client_mgr, BallListManager* ball_mgr) {
-   
-    char* buffer  = serialize_ball_list_all(ball_mgr);
+    if (udp_ready) udp_channel_flush(ctx->udp);
 
-    if(!buffer) return;
-    
-    ClientNode* curr = client_mgr->head;
-    while (curr) {
-        send(curr->ctx.csock, buffer, strlen(buffer), 0);
-        curr = curr->next;
-    }
+    shared_frame_release(frame);    // 마지막 클라이언트가 전송을 끝내면 해제됨
+}
 
-    free(buffer);
+// UDP 포트 등록: 주소는 TCP 피어의 IP로 고정하여 제3자에게 상태를 보내지 않음
+static void set_udp_port(SharedContext* ctx, int fd, int port) {
+    char reply[64];
+
+    if (port < 0 || port > 65535) {
+        snprintf(reply, sizeof(reply), "Invalid UDP port\n");
+    } else if (port > 0 && ctx->udp->fd < 0) {
+        snprintf(reply, sizeof(reply), "UDP unavailable\n");
+    } else {
+        pthread_mutex_lock(&ctx->client_list_manager->mutex_client);
+        SocketContext* client = find_client(ctx->client_list_manager, fd);
+        if (client) client->udp_port = port;     // 다음 틱부터 적용 (0이면 다시 TCP)
+        pthread_mutex_unlock(&ctx->client_list_manager->mutex_client);
+        snprintf(reply, sizeof(reply), "OK %c : %d\n", CMD_UDP, port);
+    }
+    client_send(ctx, fd, reply, strlen(reply), OUT_FRAME_REPLY);
 }
 
+// 지표 응답: METRICS, OUTBOUND 한 줄씩 + 클라이언트별 송신 큐 깊이 (최대 METRICS_MAX_CLIENT_LINES명)
+static void send_metrics(SharedContext* ctx, int fd) {
+    size_t cap = METRICS_LINE_SIZE * (size_t)(METRICS_MAX_CLIENT_LINES + 2);
+    char* reply = malloc(cap);
+    if (!reply) return;
+
+    PoolMetrics pool;
+    OutboundMetrics outbound;
+    metrics_read_pool(ctx->metrics, &pool);
+    metrics_read_outbound(ctx->metrics, &outbound);
+    int len = metrics_format(&pool, reply, cap);
+    len += metrics_format_outbound(&outbound, reply + len, cap - (size_t)len);
+
+    ClientListManager* client_mgr = ctx->client_list_manager;
+    pthread_mutex_lock(&client_mgr->mutex_client);
+    for (int i = 0; i < client_mgr->client_count && i < METRICS_MAX_CLIENT_LINES; i++) {
+        int cfd = client_mgr->clients[i].csock;
+        Mailbox* box = mailbox_get(ctx->mailboxes, cfd);
+        if (!box) continue;
+
+        size_t bytes;
+        int frames;
+        unsigned long long dropped;
+        out_queue_stats(&box->out, &bytes, &frames, &dropped);
+        len += snprintf(reply + len, cap - (size_t)len, "CLIENT fd=%d queued=%zu frames=%d dropped=%llu\n",
+                        cfd, bytes, frames, dropped);
+    }
+    pthread_mutex_unlock(&client_mgr->mutex_client);
 
+    client_send(ctx, fd, reply, (size_t)len, OUT_FRAME_REPLY);
+    free(reply);
+}
 
 void log_client_connect(int fd, struct sockaddr_in* cliaddr) {
     char ip[INET_ADDRSTRLEN];
@@ -166,97 +467,537 @@ void log_client_disconnect(int fd, const char* reason) {
 }
 
 
-// Worker thread 루프
-void* worker_thread(void* arg) {
+void wait_world_command_fence(SharedContext* ctx, Mailbox* box, int ring) {
+    if (!box->fence_set || box->fence_ring == ring) return;
 
-    int count = 0, radius = 0;
-    SharedContext* ctx = (SharedContext*)arg;
+    // 이 연결의 이전 명령이 다른 링에 남아 있으면 시뮬레이션 스레드가 가져갈 때까지 대기
+    // (가져간 뒤에 넣은 명령은 다음 틱 이후에 적용되므로 순서가 유지됨)
+    for (;;) {
+        int done = (box->fence_ring == REACTOR_COMMAND_RING)
+                 ? shared_command_ring_consumed(ctx->reactor_commands, box->fence_pos)
+                 : command_ring_consumed(&ctx->command_rings[box->fence_ring], box->fence_pos);
+        if (done || !keep_running) break;
+        sched_yield();
+    }
+    box->fence_set = 0;
+}
 
-    while (keep_running) {
+void mark_world_command_fence(SharedContext* ctx, Mailbox* box, int ring) {
+    box->fence_ring = ring;
+    box->fence_pos = (ring == REACTOR_COMMAND_RING)
+                   ? shared_command_ring_tail(ctx->reactor_commands)
+                   : command_ring_end(&ctx->command_rings[ring]);
+    box->fence_set = 1;
+}
 
-        Task task = task_queue_pop(ctx->task_queue);
-        task.data[task.length] = '\0'; // 수신한 데이터 null-terminate 보장
+// 명령을 이 워커의 링에 넣음, 링이 가득 차면 "Server busy" 응답 후 0 반환
+static int queue_world_command(SharedContext* ctx, Mailbox* box, int ring, int fd, char cmd, int count, int radius) {
+    WorldCommand wc = { fd, count, radius, cmd };
+    wait_world_command_fence(ctx, box, ring);
+    if (command_ring_push(&ctx->command_rings[ring], &wc)) {
+        mark_world_command_fence(ctx, box, ring);
+        return 1;
+    }
 
-        printf(COLOR_BLUE "[Worker] Processing task from fd %d" COLOR_RESET, task.fd);
+    char busy_msg[] = "Server busy\n";
+    client_send(ctx, fd, busy_msg, strlen(busy_msg), OUT_FRAME_REPLY);
+    return 0;
+}
 
-        char cmd = parseCommand(task.data, &count, &radius);
+static inline int push_world_command(SharedContext* ctx, int ring, const WorldCommand* command) {
+    if (ring == REACTOR_COMMAND_RING) return shared_command_ring_push(ctx->reactor_commands, command);
+    return command_ring_push(&ctx->command_rings[ring], command);
+}
 
-        if ( cmd == 0)
-        {
-            char error_msg[] = "Invalid command format\n";
-            send(task.fd, error_msg, strlen(error_msg), 0);
-            continue;
+void submit_world_command_wait(SharedContext* ctx, int ring, const WorldCommand* command) {
+    // 링이 가득 차면 시뮬레이션 스레드가 비울 때까지 양보하며 재시도
+    while (!push_world_command(ctx, ring, command)) {
+        if (!keep_running) return;
+        sched_yield();
+    }
+}
+
+// 시뮬레이션 스레드에서 명령 하나를 적용 (apply-at-tick 모드, 잠금 없음)
+static void apply_world_command(SharedContext* ctx, const WorldCommand* c) {
+    BallListManager* ball_mgr = ctx->ball_list_manager;
+
+    if (c->cmd == CMD_EXIT) {
+        delete_ball_by_socket(ball_mgr, c->fd);
+        int now_count = count_ball_by_owner(&ball_mgr->balls, c->fd);
+        log_ball_memory_usage(ball_mgr, "DEL", c->fd, now_count);
+        return;
+    }
+
+    int rc = dispatch_command(ball_mgr, c->cmd, c->count, c->radius, c->fd);
+    if (c->cmd == CMD_KILL && rc < 0) {
+        char err_msg[64];
+        snprintf(err_msg, sizeof(err_msg), "No ball %d\n", c->count);
+        client_send(ctx, c->fd, err_msg, strlen(err_msg), OUT_FRAME_REPLY);
+    }
+}
+
+// 모든 명령 링을 비우며 적용: 워커 링을 순서대로, 마지막에 리액터 공용 링
+static void apply_pending_commands(SharedContext* ctx) {
+    uint32_t end[MAX_WORKERS];
+    int rings = ctx->config.max_workers;    // 은퇴한 워커의 링에 남은 명령도 적용
+
+    // 리액터 링의 끝을 먼저 읽음: 거기 담긴 명령보다 먼저 워커 링에 들어간
+    // 명령(예: 같은 fd의 종료)은 이후에 읽는 워커 링의 끝 안에 반드시 포함됨
+    uint32_t reactor_end = shared_command_ring_end(ctx->reactor_commands);
+    for (int r = 0; r < rings; r++) {
+        end[r] = command_ring_end(&ctx->command_rings[r]);
+    }
+
+    WorldCommand c;
+    for (int r = 0; r < rings; r++) {
+        while (command_ring_pop(&ctx->command_rings[r], end[r], &c)) {
+            apply_world_command(ctx, &c);
         }
+    }
+    while (shared_command_ring_pop(ctx->reactor_commands, reactor_end, &c)) {
+        apply_world_command(ctx, &c);
+    }
+}
+
+// 작업 하나 처리 (이 연결의 메일박스 토큰을 가진 워커만 호출)
+static void handle_task(SharedContext* ctx, Mailbox* box, const Task* task, int ring) {
+    int count = 0, radius = 0;
+    int apply_at_tick = ctx->config.apply_at_tick;
+    char cmd;
 
-        if(cmd == CMD_EXIT)
-        {
-            // 클라이언트 종료 처리
-            printf(COLOR_YELLOW "[Server] Client requested disconnect (fd=%d)" COLOR_RESET, task.fd);
-            log_client_disconnect(task.fd, "Client requested disconnect");
-
-            pthread_mutex_lock(&ctx->client_list_manager->mutex_client);
-            ClientNode* removed = remove_client_by_socket(task.fd, &ctx->client_list_manager->head, &ctx->client_list_manager->tail);
-            if (removed) {
-                ctx->client_list_manager->client_count--;
-                epoll_ctl(ctx->epoll_fd, EPOLL_CTL_DEL, task.fd, NULL);
-                shutdown(removed->ctx.csock, SHUT_RDWR);
-                close(removed->ctx.csock);
-                free(removed);
+    if (task->length == TASK_CONNECT) {
+        // 리액터가 넣은 초기 공 생성: 이 연결의 첫 작업
+        pthread_mutex_lock(&ctx->ball_list_manager->mutex_ball);
+        add_ball(ctx->ball_list_manager, START_BALL_COUNT, START_BALL_RADIUS, task->fd);
+        log_ball_memory_usage(ctx->ball_list_manager, "ADD", task->fd, START_BALL_COUNT);
+        pthread_mutex_unlock(&ctx->ball_list_manager->mutex_ball);
+        return;
+    }
+    if (task->length == TASK_DISCONNECT) {
+        cmd = CMD_EXIT;     // 리액터가 넣은 연결 종료: 앞선 명령이 모두 처리된 뒤에 정리
+    } else {
+        printf(COLOR_BLUE "[Worker] Processing task from fd %d" COLOR_RESET, task->fd);
+        cmd = parseCommand(task->data, &count, &radius);   // data는 생산자가 '\0'으로 끝냄
+    }
+
+    if ( cmd == 0)
+    {
+        char error_msg[] = "Invalid command format\n";
+        client_send(ctx, task->fd, error_msg, strlen(error_msg), OUT_FRAME_REPLY);
+        return;
+    }
+
+    if(cmd == CMD_EXIT)
+    {
+        // 클라이언트 종료 처리
+        if (task->length == TASK_DISCONNECT) {
+            log_client_disconnect(task->fd, "Connection closed");
+        } else {
+            printf(COLOR_YELLOW "[Server] Client requested disconnect (fd=%d)" COLOR_RESET, task->fd);
+            log_client_disconnect(task->fd, "Client requested disconnect");
+        }
+
+        if (apply_at_tick) {
+            // fd가 재사용되기 전(close 전)에 공 삭제를 넣어 새 클라이언트의 공 생성보다 먼저 적용되게 함
+            WorldCommand wc = { task->fd, 0, 0, CMD_EXIT };
+            wait_world_command_fence(ctx, box, ring);
+            submit_world_command_wait(ctx, ring, &wc);
+        }
+
+        // 남은 명령은 버림 (close 후 같은 fd의 새 연결에 적용되지 않도록 close 전에)
+        mailbox_close(box);
+        Task rest;
+        while (mailbox_pop(box, &rest)) buffer_slab_free(ctx->buffer_slab, rest.data);
+
+        pthread_mutex_lock(&ctx->client_list_manager->mutex_client);
+        SocketContext removed;
+        if (remove_client_by_socket(ctx->client_list_manager, task->fd, &removed)) {
+            out_queue_close(&box->out);     // 이후 이 fd로 쓰지 않도록 close 전에 닫음
+            if (removed.epoll_fd >= 0) {
+                epoll_ctl(removed.epoll_fd, EPOLL_CTL_DEL, task->fd, NULL);   // 연결을 가진 리액터의 epoll
             }
-            pthread_mutex_unlock(&ctx->client_list_manager->mutex_client);
+            shutdown(removed.csock, SHUT_RDWR);
+            close(removed.csock);
+        }
+        pthread_mutex_unlock(&ctx->client_list_manager->mutex_client);
 
+        if (!apply_at_tick) {
             pthread_mutex_lock(&ctx->ball_list_manager->mutex_ball);
-            delete_ball_by_socket(ctx->ball_list_manager, task.fd);
-            int now_count = count_ball_by_owner(ctx->ball_list_manager->head, task.fd);
-            log_ball_memory_usage(ctx->ball_list_manager, "DEL", task.fd, now_count);
+            delete_ball_by_socket(ctx->ball_list_manager, task->fd);
+            int now_count = count_ball_by_owner(&ctx->ball_list_manager->balls, task->fd);
+            log_ball_memory_usage(ctx->ball_list_manager, "DEL", task->fd, now_count);
             pthread_mutex_unlock(&ctx->ball_list_manager->mutex_ball);
-            continue; // 다음 작업 처리
         }
+        return;
+    }
+
+    if (cmd == CMD_METRICS)
+    {
+        // 관리 스레드가 마지막으로 발행한 지표 + 클라이언트별 송신 큐 깊이 응답 (공 리스트와 무관)
+        send_metrics(ctx, task->fd);
+        return;
+    }
 
-        // 다른 명령이 들어왔을때 처리 필요함!
-        switch (cmd) {
-            case CMD_ADD:  
-            case CMD_DEL:
-            case CMD_SPEED_UP:
-            case CMD_SPEED_DOWN:
-                count = (count <= 0) ? 1 : count;
+    if (cmd == CMD_UDP)
+    {
+        // 공 상태를 받을 UDP 포트 등록 (공 리스트와 무관, 명령과 응답은 계속 TCP)
+        set_udp_port(ctx, task->fd, count);
+        return;
+    }
+
+    // 다른 명령이 들어왔을때 처리 필요함!
+    switch (cmd) {
+        case CMD_ADD:  
+        case CMD_DEL:
+        case CMD_SPEED_UP:
+        case CMD_SPEED_DOWN:
+            count = (count <= 0) ? 1 : count;
+            if (apply_at_tick) {
+                if (!queue_world_command(ctx, box, ring, task->fd, cmd, count, radius)) return;
+                break;
+            }
+            pthread_mutex_lock(&ctx->ball_list_manager->mutex_ball);
+            dispatch_command(ctx->ball_list_manager, cmd, count, radius, task->fd);
+            pthread_mutex_unlock(&ctx->ball_list_manager->mutex_ball);
+            break;
+        case CMD_KILL:
+            {
+                // count 자리에 공 ID가 들어옴 (k:<id>). ID 없는 'k'는 0번 공으로 해석하지 않고 거부
+                if (!strchr(task->data, ':')) {
+                    char error_msg[] = "Invalid command format\n";
+                    client_send(ctx, task->fd, error_msg, strlen(error_msg), OUT_FRAME_REPLY);
+                    return;
+                }
+                if (apply_at_tick) {
+                    // 없는 ID면 적용 시점에 시뮬레이션 스레드가 "No ball"을 보냄
+                    if (!queue_world_command(ctx, box, ring, task->fd, cmd, count, radius)) return;
+                    break;
+                }
                 pthread_mutex_lock(&ctx->ball_list_manager->mutex_ball);
-                dispatch_command(ctx->ball_list_manager, cmd, count, radius, task.fd);
+                int rc = dispatch_command(ctx->ball_list_manager, cmd, count, radius, task->fd);
                 pthread_mutex_unlock(&ctx->ball_list_manager->mutex_ball);
-                break;
-            default:
-                {
-                    char unknown_msg[] = "Unknown command\n";
-                    send(task.fd, unknown_msg, strlen(unknown_msg), 0);
-                    continue;
+                if (rc < 0) {
+                    char err_msg[64];
+                    snprintf(err_msg, sizeof(err_msg), "No ball %d\n", count);
+                    client_send(ctx, task->fd, err_msg, strlen(err_msg), OUT_FRAME_REPLY);
+                    return;
                 }
+            }
+            break;
+        default:
+            {
+                char unknown_msg[] = "Unknown command\n";
+                client_send(ctx, task->fd, unknown_msg, strlen(unknown_msg), OUT_FRAME_REPLY);
+                return;
+            }
+    }
+
+    char response[64];
+    snprintf(response, sizeof(response), "OK %c : %d\n", cmd, count);
+    client_send(ctx, task->fd, response, strlen(response), OUT_FRAME_REPLY);
+    // 변경된 공 상태는 다음 틱의 팬아웃이 모든 클라이언트에 전송
+}
+
+// Worker thread 루프
+void* worker_thread(void* arg) {
+
+    WorkerHandle* handle = (WorkerHandle*)arg;
+    SharedContext* ctx = handle->ctx;
+    affinity_pin_self(&ctx->config.affinity, ROLE_WORKER);
+    int ring = handle->slot;    // 이 워커의 명령 링 (= 워커 풀 슬롯)
+    Task token;
+
+    // 연결 토큰을 받아 그 연결의 명령을 도착 순서대로 처리
+    // (자신의 덱 → inbox → 다른 워커에게서 훔치기, 한 연결은 한 번에 한 워커만 처리)
+    // 슬롯이 목표 워커 수 밖으로 밀려나면 자기 큐를 비운 뒤 종료
+    while (keep_running && worker_pool_next(ctx->worker_pool, ring, &token)) {
+        Mailbox* box = mailbox_get(ctx->mailboxes, token.fd);
+        if (!box) continue;
+
+        worker_pool_record_wait(ctx->worker_pool, metrics_now_ns() - box->scheduled_ns);
+
+        for (;;) {
+            __atomic_add_fetch(&ctx->worker_pool->busy_workers, 1, __ATOMIC_RELAXED);
+
+            Task task;
+            int handled = 0;
+            while (handled < MAILBOX_DRAIN_BUDGET && mailbox_pop(box, &task)) {
+                if (!mailbox_is_closed(box)) handle_task(ctx, box, &task, ring);
+                buffer_slab_free(ctx->buffer_slab, task.data);    // 처리가 끝난 명령 버퍼 반환
+                handled++;
+            }
+
+            __atomic_sub_fetch(&ctx->worker_pool->busy_workers, 1, __ATOMIC_RELAXED);
+
+            // 예산만큼만 처리하고 토큰 반환: 명령이 남았으면 다시 예약해 다른 연결과 번갈아 처리
+            if (!mailbox_release(box)) break;
+            box->scheduled_ns = metrics_now_ns();
+            // 워커는 inbox를 비우는 유일한 주체이므로 여기서 대기하면 풀 전체가 멈출 수 있음:
+            // 덱과 inbox가 모두 가득 차면 토큰을 쥔 채 같은 메일박스를 이어서 처리
+            if (worker_pool_resubmit(ctx->worker_pool, ring, &token)) break;
+        }
+    }
+
+    printf(COLOR_GREEN "[Worker %d] Thread Shutting down..." COLOR_RESET, ring);
+    __atomic_store_n(&handle->exited, 1, __ATOMIC_RELEASE);    // 관리 스레드가 join해도 됨
+    return NULL;
+}
+
+// 클라이언트별 송신 큐 깊이 표본 (큐 잠금 없이 바이트 수만 읽음)
+static void sample_outbound(SharedContext* ctx, OutboundMetrics* sample) {
+    ClientListManager* client_mgr = ctx->client_list_manager;
+    memset(sample, 0, sizeof(OutboundMetrics));
+    sample->max_fd = -1;
+
+    pthread_mutex_lock(&client_mgr->mutex_client);
+    sample->clients = client_mgr->client_count;
+    for (int i = 0; i < client_mgr->client_count; i++) {
+        int fd = client_mgr->clients[i].csock;
+        Mailbox* box = mailbox_get(ctx->mailboxes, fd);
+        if (!box) continue;
+
+        unsigned long long bytes = __atomic_load_n(&box->out.bytes, __ATOMIC_RELAXED);
+        if (bytes == 0) continue;
+        sample->backlogged++;
+        sample->queued_bytes += bytes;
+        if (bytes > sample->max_bytes) {
+            sample->max_bytes = bytes;
+            sample->max_fd = fd;
+        }
+    }
+    pthread_mutex_unlock(&client_mgr->mutex_client);
+
+    sample->dropped = __atomic_load_n(&ctx->metrics->states_dropped, __ATOMIC_RELAXED);
+    sample->disconnects = __atomic_load_n(&ctx->metrics->slow_disconnects, __ATOMIC_RELAXED);
+}
+
+// 워커 하나를 slot 자리에 시작 (실패 시 -1)
+static int start_worker(WorkerHandle* handle, SharedContext* ctx, int slot) {
+    handle->ctx = ctx;
+    handle->slot = slot;
+    handle->exited = 0;
+    if (pthread_create(&handle->tid, NULL, worker_thread, handle) != 0) {
+        perror(COLOR_RED "[Error] Worker thread creation failed" COLOR_RESET);
+        return -1;
+    }
+    handle->running = 1;
+    return 0;
+}
+
+// 은퇴해 종료한 워커 스레드를 회수
+static int reap_workers(WorkerHandle* handles, int max_workers, int* running) {
+    int reaped = 0;
+    for (int i = 0; i < max_workers; i++) {
+        if (handles[i].running && __atomic_load_n(&handles[i].exited, __ATOMIC_ACQUIRE)) {
+            pthread_join(handles[i].tid, NULL);
+            handles[i].running = 0;
+            (*running)--;
+            reaped++;
+        }
+    }
+    return reaped;
+}
+
+void* worker_manager_thread(void* arg) {
+    SharedContext* ctx = (SharedContext*)arg;
+    WorkerPool* pool = ctx->worker_pool;
+    int min_workers = ctx->config.min_workers;
+    int max_workers = ctx->config.max_workers;
+    int running = 0;
+
+    WorkerHandle* handles = calloc((size_t)max_workers, sizeof(WorkerHandle));
+    if (!handles) {
+        perror(COLOR_RED "[Error] Worker handle allocation failed" COLOR_RESET);
+        keep_running = 0;
+        return NULL;
+    }
+
+    for (int i = 0; i < min_workers; i++) {
+        if (start_worker(&handles[i], ctx, i) < 0) {
+            keep_running = 0;
+            break;
+        }
+        running++;
+    }
+
+    struct timespec interval = { 0, WORKER_SCALE_INTERVAL_MS * 1000000L };
+    int idle_ms = 0;        // 목표 워커 수보다 바쁜 워커가 적었던 연속 시간
+    int since_log_ms = 0;
+
+    while (keep_running) {
+        nanosleep(&interval, NULL);
+        if (!keep_running) break;
+
+        reap_workers(handles, max_workers, &running);
+
+        int target = __atomic_load_n(&pool->target_workers, __ATOMIC_ACQUIRE);
+        int busy = __atomic_load_n(&pool->busy_workers, __ATOMIC_RELAXED);
+        int depth = worker_pool_depth(pool);
+        unsigned long long wait_max_ns = worker_pool_take_wait_max(pool);
+        unsigned long long wait_avg_ns = __atomic_load_n(&pool->wait_avg_ns, __ATOMIC_RELAXED);
+
+        unsigned long long local_pops = 0, steals = 0;
+        for (int i = 0; i < max_workers; i++) {
+            local_pops += __atomic_load_n(&pool->workers[i].local_pops, __ATOMIC_RELAXED);
+            steals += __atomic_load_n(&pool->workers[i].steals, __ATOMIC_RELAXED);
         }
 
-        char response[64];
-        snprintf(response, sizeof(response), "OK %c : %d\n", cmd, count);
-        send(task.fd, response, strlen(response), 0);
+        // 확장: 큐가 쌓이거나 대기 시간이 길어지면 다음 슬롯에 워커 추가
+        // (은퇴한 워커가 아직 그 슬롯을 비우는 중이면 다음 주기에 시도)
+        if ((depth >= WORKER_GROW_DEPTH || wait_max_ns >= WORKER_GROW_WAIT_US * 1000ULL) &&
+            target < max_workers && !handles[target].running) {
+            worker_pool_set_target(pool, target + 1);   // 새 슬롯이 작업을 받기 전에 목표부터 올림
+            if (start_worker(&handles[target], ctx, target) == 0) {
+                running++;
+                printf(COLOR_CYAN "[Worker Pool] Scaled up to %d workers (depth %d, wait max %llu us)" COLOR_RESET,
+                       target + 1, depth, wait_max_ns / 1000ULL);
+                target++;
+            } else {
+                worker_pool_set_target(pool, target);
+            }
+            idle_ms = 0;
+        }
+        // 축소: 바쁜 워커가 계속 목표보다 적으면 가장 높은 슬롯의 워커를 은퇴시킴
+        else if (busy < target && depth == 0 && target > min_workers) {
+            idle_ms += WORKER_SCALE_INTERVAL_MS;
+            if (idle_ms >= WORKER_SHRINK_IDLE_MS) {
+                target--;
+                worker_pool_set_target(pool, target);
+                printf(COLOR_CYAN "[Worker Pool] Scaled down to %d workers" COLOR_RESET, target);
+                idle_ms = 0;
+            }
+        } else {
+            idle_ms = 0;
+        }
 
-        broadcast_ball_state(ctx->client_list_manager, ctx->ball_list_manager);
+        PoolMetrics sample = {
+            running, target, busy, depth,
+            wait_avg_ns / 1000ULL, wait_max_ns / 1000ULL, local_pops, steals
+        };
+        metrics_publish_pool(ctx->metrics, &sample);
+
+        OutboundMetrics outbound;
+        sample_outbound(ctx, &outbound);
+        metrics_publish_outbound(ctx->metrics, &outbound);
+
+        since_log_ms += WORKER_SCALE_INTERVAL_MS;
+        if (since_log_ms >= METRICS_LOG_INTERVAL_MS) {
+            char line[METRICS_LINE_SIZE];
+            metrics_format(&sample, line, sizeof(line));
+            line[strcspn(line, "\n")] = '\0';
+            log_event(LOG_DEBUG, "Worker pool", -1, running, line);
+            metrics_format_outbound(&outbound, line, sizeof(line));
+            line[strcspn(line, "\n")] = '\0';
+            log_event(LOG_DEBUG, "Outbound queues", outbound.max_fd, outbound.backlogged, line);
+            since_log_ms = 0;
+        }
+    }
 
+    // 종료: 남은 워커를 모두 깨워 회수
+    worker_pool_wake_all(pool);
+    for (int i = 0; i < max_workers; i++) {
+        if (handles[i].running) pthread_join(handles[i].tid, NULL);
     }
-    printf(COLOR_GREEN "[Worker] Thread Shutting down..." COLOR_RESET);
+    free(handles);
+    printf(COLOR_GREEN "[Worker Manager] Thread Shutting down..." COLOR_RESET);
     return NULL;
 }
 
+// 시뮬레이션 카운터를 로그 파일에 기록
+static void log_sim_stats(BallListManager* ball_mgr, const TickScheduler* sched) {
+    const CollisionStats* cs = &ball_mgr->collision.stats;
+    char details[384];
+    snprintf(details, sizeof(details),
+        "Balls: %d | Ticks: %llu | Steps: %llu | Late: %llu | Skipped: %llu | "
+        "Pairs tested: %llu (total %llu) | Pairs colliding: %llu (total %llu)",
+        ball_mgr->balls.count, sched->ticks, sched->steps, sched->late_ticks, sched->skipped_ticks,
+        cs->tick_pairs_tested, cs->total_pairs_tested,
+        cs->tick_pairs_colliding, cs->total_pairs_colliding);
+    log_event(LOG_DEBUG, "Simulation stats", -1, ball_mgr->balls.count, details);
+}
+
 void* cycle_broadcast_ball_state(void* arg) {
     SharedContext* ctx = (SharedContext*)arg;
+    affinity_pin_self(&ctx->config.affinity, ROLE_SIM);    // 이후 생성되는 시뮬레이션 헬퍼도 같은 CPU 집합을 물려받음
+
+    // 시뮬레이션 스레드 풀 (sim_threads == 1 이면 이 스레드만 사용)
+    SimPool pool;
+    if (sim_pool_init(&pool, ctx->config.sim_threads) < 0) {
+        printf(COLOR_RED "[Cycle Broadcast] Failed to start simulation threads" COLOR_RESET);
+        keep_running = 0;
+        return NULL;
+    }
+
+    TickScheduler sched;
+    if (tick_scheduler_init(&sched, ctx->config.tick_hz, ctx->config.max_catchup) < 0) {
+        printf(COLOR_RED "[Cycle Broadcast] Failed to start the tick timer" COLOR_RESET);
+        sim_pool_destroy(&pool);
+        keep_running = 0;
+        return NULL;
+    }
+
+    unsigned long long next_stats_log = STATS_LOG_INTERVAL_TICKS;
 
     while (keep_running) {
-        usleep(30000); // 약 33 FPS
-        pthread_mutex_lock(&ctx->ball_list_manager->mutex_ball);
-        pthread_mutex_unlock(&ctx->client_list_manager->mutex_client);
+        // 고정 주기 대기: 늦었으면 밀린 스텝 수(최대 max_catchup)만큼 시뮬레이션
+        int steps = tick_scheduler_wait(&sched);
+        if (steps <= 0) continue;
+
+        if (ctx->config.apply_at_tick) {
+            // 단일 작성자 모드: 이 스레드만 공 리스트를 바꾸므로 잠금 없이 명령부터 적용
+            apply_pending_commands(ctx);
+        } else {
+            pthread_mutex_lock(&ctx->ball_list_manager->mutex_ball);
+        }
 
-        move_all_ball(ctx->ball_list_manager);
-        //broadcast_ball_state(ctx->client_list_manager, ctx->ball_list_manager);
-        broadcast_ball_state_all(ctx->client_list_manager, ctx->ball_list_manager);
-        pthread_mutex_unlock(&ctx->ball_list_manager->mutex_ball);
-        pthread_mutex_unlock(&ctx->client_list_manager->mutex_client);
+        for (int i = 0; i < steps; i++) {
+            sim_pool_step(&pool, &ctx->ball_list_manager->balls);
+            if (ctx->config.collisions) {
+                collide_all_ball(ctx->ball_list_manager);
+            }
+        }
+        if (sched.steps >= next_stats_log) {
+            log_sim_stats(ctx->ball_list_manager, &sched);
+            next_stats_log += STATS_LOG_INTERVAL_TICKS;
+        }
+        // 전송은 팬아웃 스레드가 스냅샷으로 처리하므로 여기서는 발행만 함
+        snapshot_publish(&ctx->ball_list_manager->snapshots, &ctx->ball_list_manager->balls, sched.steps);
+        if (!ctx->config.apply_at_tick) {
+            pthread_mutex_unlock(&ctx->ball_list_manager->mutex_ball);
+        }
     }
+
+    // 스냅샷을 기다리는 스레드들을 깨워 종료하게 함
+    snapshot_wake_all(&ctx->ball_list_manager->snapshots);
+
+    log_sim_stats(ctx->ball_list_manager, &sched);
+    tick_scheduler_destroy(&sched);
+    sim_pool_destroy(&pool);
     printf(COLOR_GREEN "[Cycle Broadcast] Thread Shutting down..." COLOR_RESET);
     return NULL;
 }
+
+void* snapshot_fanout_thread(void* arg) {
+    SharedContext* ctx = (SharedContext*)arg;
+    affinity_pin_self(&ctx->config.affinity, ROLE_FANOUT);
+    SnapshotStore* snapshots = &ctx->ball_list_manager->snapshots;
+    int reader = snapshot_reader_register(snapshots);
+    unsigned long long last_seq = 0;
+
+    while (keep_running) {
+        // 새 스냅샷이 발행될 때까지 대기 (종료 확인을 위해 제한 시간 사용)
+        if (!snapshot_wait(snapshots, &last_seq, 100)) continue;
+
+        WorldSnapshot* snap = snapshot_acquire(snapshots, reader);
+        broadcast_ball_state_all(ctx, snap);
+        snapshot_release(snap);
+    }
+
+    snapshot_reader_unregister(snapshots, reader);
+    if (ctx->udp->datagrams > 0 || ctx->udp->dropped > 0) {
+        printf(COLOR_CYAN "[Fanout] UDP: %llu datagrams sent, %llu dropped" COLOR_RESET,
+               ctx->udp->datagrams, ctx->udp->dropped);
+    }
+    printf(COLOR_GREEN "[Fanout] Thread Shutting down..." COLOR_RESET);
+    return NULL;
+}
@@ -0,0 +1,99 @@
+#include "sim_pool.h"
+#include "ball_kernel.h"
+
+// index 번째 스레드가 담당하는 공 범위 계산 (SIMD 폭에 맞춰 정렬)
+static void chunk_range(const SimPool* pool, int index, int* begin, int* end) {
+    int n = pool->list->count;
+    int chunk = (n + pool->active_threads - 1) / pool->active_threads;
+    chunk = (chunk + SIM_POOL_CHUNK_ALIGN - 1) / SIM_POOL_CHUNK_ALIGN * SIM_POOL_CHUNK_ALIGN;
+
+    *begin = index * chunk;
+    *end = *begin + chunk;
+    if (*begin > n) *begin = n;
+    if (*end > n) *end = n;
+}
+
+static void* sim_helper_thread(void* arg) {
+    SimHelper* helper = (SimHelper*)arg;
+    SimPool* pool = helper->pool;
+
+    while (1) {
+        pthread_barrier_wait(&pool->start_barrier);
+        if (pool->stop) break;
+
+        if (helper->index < pool->active_threads) {
+            int begin, end;
+            chunk_range(pool, helper->index, &begin, &end);
+            move_balls(pool->list, begin, end);
+        }
+
+        pthread_barrier_wait(&pool->done_barrier);
+    }
+    return NULL;
+}
+
+int sim_pool_init(SimPool* pool, int num_threads) {
+    memset(pool, 0, sizeof(SimPool));
+    if (num_threads < 1) num_threads = 1;
+    if (num_threads > SIM_POOL_MAX_THREADS) num_threads = SIM_POOL_MAX_THREADS;
+    pool->num_threads = num_threads;
+
+    if (num_threads == 1) return 0;
+
+    pool->helpers = (SimHelper*)calloc(num_threads - 1, sizeof(SimHelper));
+    if (!pool->helpers) {
+        perror("calloc() : sim pool");
+        return -1;
+    }
+
+    pthread_barrier_init(&pool->start_barrier, NULL, num_threads);
+    pthread_barrier_init(&pool->done_barrier, NULL, num_threads);
+
+    for (int i = 0; i < num_threads - 1; i++) {
+        pool->helpers[i].index = i + 1;
+        pool->helpers[i].pool = pool;
+        if (pthread_create(&pool->helpers[i].tid, NULL, sim_helper_thread, &pool->helpers[i]) != 0) {
+            perror("pthread_create() : sim pool");
+            return -1;
+        }
+    }
+
+    printf(COLOR_BLUE "[Sim] Parallel tick enabled with %d threads" COLOR_RESET, num_threads);
+    return 0;
+}
+
+void sim_pool_step(SimPool* pool, BallList* list) {
+    int n = list->count;
+    int active = n / SIM_POOL_MIN_BALLS_PER_THREAD;
+    if (active > pool->num_threads) active = pool->num_threads;
+
+    if (pool->num_threads == 1 || active <= 1) {
+        move_balls(list, 0, n);
+        return;
+    }
+
+    pool->list = list;
+    pool->active_threads = active;
+    pthread_barrier_wait(&pool->start_barrier);
+
+    int begin, end;
+    chunk_range(pool, 0, &begin, &end);
+    move_balls(list, begin, end);
+
+    pthread_barrier_wait(&pool->done_barrier);
+}
+
+void sim_pool_destroy(SimPool* pool) {
+    if (pool->num_threads > 1) {
+        pool->stop = 1;
+        pthread_barrier_wait(&pool->start_barrier);
+        for (int i = 0; i < pool->num_threads - 1; i++) {
+            pthread_join(pool->helpers[i].tid, NULL);
+        }
+        pthread_barrier_destroy(&pool->start_barrier);
+        pthread_barrier_destroy(&pool->done_barrier);
+    }
+    free(pool->helpers);
+    pool->helpers = NULL;
+    pool->num_threads = 1;
+}
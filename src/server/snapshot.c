@@ -0,0 +1,244 @@
+#include <errno.h>
+#include <time.h>
+#include "snapshot.h"
+
+void snapshot_store_init(SnapshotStore* store) {
+    memset(store, 0, sizeof(SnapshotStore));
+    store->global_epoch = 1;    // 0은 "읽는 중 아님"을 뜻함
+    pthread_mutex_init(&store->wait_mutex, NULL);
+    pthread_cond_init(&store->published, NULL);
+}
+
+static void snapshot_free(WorldSnapshot* snap) {
+    free(snap->x);
+    free(snap->y);
+    free(snap->dx);
+    free(snap->dy);
+    free(snap->radius);
+    free(snap->palette);
+    free(snap->owner_id);
+    free(snap->id);
+    free(snap->owner_start);
+    free(snap);
+}
+
+static void snapshot_free_chain(WorldSnapshot* snap) {
+    while (snap) {
+        WorldSnapshot* next = snap->next;
+        snapshot_free(snap);
+        snap = next;
+    }
+}
+
+void snapshot_store_destroy(SnapshotStore* store) {
+    WorldSnapshot* cur = __atomic_exchange_n(&store->current, NULL, __ATOMIC_SEQ_CST);
+    if (cur) snapshot_free(cur);
+    snapshot_free_chain(store->retired);
+    snapshot_free_chain(store->spare);
+    store->retired = NULL;
+    store->spare = NULL;
+    pthread_mutex_destroy(&store->wait_mutex);
+    pthread_cond_destroy(&store->published);
+}
+
+int snapshot_reader_register(SnapshotStore* store) {
+    for (int r = 0; r < SNAPSHOT_MAX_READERS; r++) {
+        int expected = 0;
+        if (__atomic_compare_exchange_n(&store->readers[r].in_use, &expected, 1, 0,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+            __atomic_store_n(&store->readers[r].epoch, 0, __ATOMIC_RELEASE);
+            return r;
+        }
+    }
+    printf(COLOR_RED "[Snapshot] No free reader slot" COLOR_RESET);
+    return -1;
+}
+
+void snapshot_reader_unregister(SnapshotStore* store, int reader) {
+    if (reader < 0 || reader >= SNAPSHOT_MAX_READERS) return;
+    __atomic_store_n(&store->readers[reader].epoch, 0, __ATOMIC_RELEASE);
+    __atomic_store_n(&store->readers[reader].in_use, 0, __ATOMIC_RELEASE);
+}
+
+WorldSnapshot* snapshot_acquire(SnapshotStore* store, int reader) {
+    if (reader < 0 || reader >= SNAPSHOT_MAX_READERS) return NULL;
+    SnapshotReader* slot = &store->readers[reader];
+
+    // 에폭 진입: 포인터를 읽고 참조를 올리는 사이에 회수되지 않도록 보호
+    __atomic_store_n(&slot->epoch, __atomic_load_n(&store->global_epoch, __ATOMIC_SEQ_CST), __ATOMIC_SEQ_CST);
+    WorldSnapshot* snap = __atomic_load_n(&store->current, __ATOMIC_SEQ_CST);
+    if (snap) __atomic_add_fetch(&snap->refs, 1, __ATOMIC_ACQ_REL);
+    __atomic_store_n(&slot->epoch, 0, __ATOMIC_RELEASE);
+
+    return snap;
+}
+
+void snapshot_release(WorldSnapshot* snap) {
+    if (snap) __atomic_sub_fetch(&snap->refs, 1, __ATOMIC_ACQ_REL);
+}
+
+// 스냅샷 배열을 balls개 / owners개를 담을 수 있도록 확장
+static int snapshot_reserve(WorldSnapshot* snap, int balls, int owners) {
+    if (balls > snap->capacity) {
+        int cap = snap->capacity > 0 ? snap->capacity : BALL_LIST_INIT_CAPACITY;
+        while (cap < balls) cap *= 2;
+
+        uint16_t* x = (uint16_t*)realloc(snap->x, sizeof(uint16_t) * (size_t)cap);
+        if (x) snap->x = x;
+        uint16_t* y = (uint16_t*)realloc(snap->y, sizeof(uint16_t) * (size_t)cap);
+        if (y) snap->y = y;
+        int16_t* dx = (int16_t*)realloc(snap->dx, sizeof(int16_t) * (size_t)cap);
+        if (dx) snap->dx = dx;
+        int16_t* dy = (int16_t*)realloc(snap->dy, sizeof(int16_t) * (size_t)cap);
+        if (dy) snap->dy = dy;
+        uint8_t* r = (uint8_t*)realloc(snap->radius, sizeof(uint8_t) * (size_t)cap);
+        if (r) snap->radius = r;
+        uint8_t* p = (uint8_t*)realloc(snap->palette, sizeof(uint8_t) * (size_t)cap);
+        if (p) snap->palette = p;
+        uint16_t* o = (uint16_t*)realloc(snap->owner_id, sizeof(uint16_t) * (size_t)cap);
+        if (o) snap->owner_id = o;
+        int* id = (int*)realloc(snap->id, sizeof(int) * (size_t)cap);
+        if (id) snap->id = id;
+
+        if (!x || !y || !dx || !dy || !r || !p || !o || !id) return -1;
+        snap->capacity = cap;
+    }
+
+    if (owners + 1 > snap->owner_capacity) {
+        int* start = (int*)realloc(snap->owner_start, sizeof(int) * (size_t)(owners + 1));
+        if (!start) return -1;
+        snap->owner_start = start;
+        snap->owner_capacity = owners + 1;
+    }
+    return 0;
+}
+
+// 라이브 리스트를 소유자 순서(계수 정렬)로 복사
+static void snapshot_fill(WorldSnapshot* snap, const BallList* list, unsigned long long tick) {
+    int owners = list->owner_capacity;
+    int* start = snap->owner_start;
+
+    // 소유자별 시작 위치 = 앞선 소유자들의 공 개수 합
+    start[0] = 0;
+    for (int o = 0; o < owners; o++) {
+        start[o + 1] = start[o] + list->owners[o].count;
+    }
+
+    // 소유자 집합 순서대로 복사 (집합 안의 순서 = 삽입 순서)
+    int scaled = list->scaled_owners > 0;
+    for (int o = 0; o < owners; o++) {
+        const OwnerBallSet* set = &list->owners[o];
+        int lv = scaled ? list->owner_speed_level[o] : 0;
+        int pos = start[o];
+        for (int k = 0; k < set->count; k++, pos++) {
+            int i = set->index[k];
+            snap->x[pos] = list->x[i];
+            snap->y[pos] = list->y[i];
+            snap->dx[pos] = (int16_t)scaleSpeed(list->dx[i], lv);
+            snap->dy[pos] = (int16_t)scaleSpeed(list->dy[i], lv);
+            snap->radius[pos] = list->radius[i];
+            snap->palette[pos] = list->palette[i];
+            snap->owner_id[pos] = (uint16_t)o;
+            snap->id[pos] = list->id[i];
+        }
+    }
+
+    snap->count = list->count;
+    snap->owner_count = owners;
+    snap->tick = tick;
+}
+
+// 교체된 스냅샷 중 더 이상 닿을 수 없는 것을 회수 (여분 풀에 보관하거나 해제)
+static void snapshot_reclaim(SnapshotStore* store) {
+    // 현재 읽는 중인 리더들의 최소 에폭
+    unsigned long long min_epoch = ~0ULL;
+    for (int r = 0; r < SNAPSHOT_MAX_READERS; r++) {
+        unsigned long long e = __atomic_load_n(&store->readers[r].epoch, __ATOMIC_SEQ_CST);
+        if (e != 0 && e < min_epoch) min_epoch = e;
+    }
+
+    WorldSnapshot** link = &store->retired;
+    while (*link) {
+        WorldSnapshot* snap = *link;
+        if (snap->retire_epoch < min_epoch && __atomic_load_n(&snap->refs, __ATOMIC_ACQUIRE) == 0) {
+            *link = snap->next;
+            if (store->spare_count < SNAPSHOT_SPARE_POOL) {
+                snap->next = store->spare;
+                store->spare = snap;
+                store->spare_count++;
+            } else {
+                snapshot_free(snap);
+            }
+        } else {
+            link = &snap->next;
+        }
+    }
+}
+
+int snapshot_publish(SnapshotStore* store, const BallList* list, unsigned long long tick) {
+    snapshot_reclaim(store);
+
+    WorldSnapshot* snap = store->spare;
+    if (snap) {
+        store->spare = snap->next;
+        store->spare_count--;
+    } else {
+        snap = (WorldSnapshot*)calloc(1, sizeof(WorldSnapshot));
+        if (!snap) return -1;
+    }
+
+    if (snapshot_reserve(snap, list->count, list->owner_capacity) < 0) {
+        perror(COLOR_RED "[Error] Snapshot allocation failed" COLOR_RESET);
+        snap->next = store->spare;
+        store->spare = snap;
+        store->spare_count++;
+        return -1;
+    }
+
+    snapshot_fill(snap, list, tick);
+    snap->refs = 1;     // 현재 스냅샷인 동안 저장소가 가지는 참조
+    snap->next = NULL;
+
+    // 교체 후 이전 스냅샷은 현재 에폭으로 은퇴시키고 에폭을 올림
+    WorldSnapshot* old = __atomic_exchange_n(&store->current, snap, __ATOMIC_SEQ_CST);
+    if (old) {
+        old->retire_epoch = __atomic_fetch_add(&store->global_epoch, 1, __ATOMIC_SEQ_CST);
+        snapshot_release(old);
+        old->next = store->retired;
+        store->retired = old;
+    }
+
+    pthread_mutex_lock(&store->wait_mutex);
+    store->published_seq++;
+    pthread_cond_broadcast(&store->published);
+    pthread_mutex_unlock(&store->wait_mutex);
+    return 0;
+}
+
+int snapshot_wait(SnapshotStore* store, unsigned long long* last_seq, int timeout_ms) {
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    pthread_mutex_lock(&store->wait_mutex);
+    int rc = 0;
+    while (store->published_seq == *last_seq && !store->stopping && rc != ETIMEDOUT) {
+        rc = pthread_cond_timedwait(&store->published, &store->wait_mutex, &deadline);
+    }
+    int fresh = (store->published_seq != *last_seq);
+    *last_seq = store->published_seq;
+    pthread_mutex_unlock(&store->wait_mutex);
+    return fresh;
+}
+
+void snapshot_wake_all(SnapshotStore* store) {
+    pthread_mutex_lock(&store->wait_mutex);
+    store->stopping = 1;
+    pthread_cond_broadcast(&store->published);
+    pthread_mutex_unlock(&store->wait_mutex);
+}
@@ -1,60 +1,223 @@
+#include <limits.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
 #include "task.h"
 
+#define TASK_QUEUE_MASK (TASK_QUEUE_CAPACITY - 1)
+
+#if (TASK_QUEUE_CAPACITY & TASK_QUEUE_MASK) != 0
+#error "TASK_QUEUE_CAPACITY must be a power of two"
+#endif
+
+static inline void cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+static inline void futex_wait(uint32_t* addr, uint32_t expected) {
+    syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, expected, NULL, NULL, 0);
+}
+
+static inline void futex_wake(uint32_t* addr, int count) {
+    syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, count, NULL, NULL, 0);
+}
+
+// 대기 중인 스레드가 있을 때만 futex 워드를 올리고 깨움
+static inline void wake_waiters(uint32_t* word, uint32_t* waiters, int count) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(waiters, __ATOMIC_SEQ_CST) > 0) {
+        __atomic_add_fetch(word, 1, __ATOMIC_SEQ_CST);
+        futex_wake(word, count);
+    }
+}
 
 // 1. TaskQueue 초기화
 void task_queue_init(TaskQueue* q) {
-    memset(q, 0,sizeof(TaskQueue));
-    q->front = 0;
-    q->rear = 0;
-    q->count = 0;
-    pthread_mutex_init(&q->mutex, NULL);
-    pthread_cond_init(&q->cond, NULL);
+    memset(q, 0, sizeof(TaskQueue));
+    for (uint32_t i = 0; i < TASK_QUEUE_CAPACITY; i++) {
+        q->cells[i].seq = i;    // 위치 i의 생산자를 기다리는 빈 슬롯
+    }
+    // CPU가 하나뿐이면 회전 대기는 상대 스레드의 실행만 늦춤
+    q->spin_limit = (sysconf(_SC_NPROCESSORS_ONLN) > 1) ? TASK_QUEUE_SPIN : 1;
+}
+
+// 연속된 빈 슬롯을 최대 max개 확보, 확보한 개수 반환 (0 = 가득 참)
+static int claim_push(TaskQueue* q, int max, uint32_t* start) {
+    uint32_t pos = __atomic_load_n(&q->enqueue_pos, __ATOMIC_RELAXED);
+    for (;;) {
+        int n = 0;
+        while (n < max) {
+            uint32_t seq = __atomic_load_n(&q->cells[(pos + n) & TASK_QUEUE_MASK].seq, __ATOMIC_ACQUIRE);
+            int32_t diff = (int32_t)(seq - (pos + n));
+            if (diff != 0) {
+                if (n == 0 && diff < 0) return 0;   // 이전 바퀴의 작업이 아직 소비되지 않음
+                break;
+            }
+            n++;
+        }
+        if (n == 0) {
+            // 다른 생산자가 이미 pos를 가져감: 위치를 다시 읽음
+            pos = __atomic_load_n(&q->enqueue_pos, __ATOMIC_RELAXED);
+            continue;
+        }
+        if (__atomic_compare_exchange_n(&q->enqueue_pos, &pos, pos + n, 1,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            *start = pos;
+            return n;
+        }
+    }
+}
+
+// 준비된 연속 작업을 최대 max개 확보, 확보한 개수 반환 (0 = 비어 있음)
+static int claim_pop(TaskQueue* q, int max, uint32_t* start) {
+    uint32_t pos = __atomic_load_n(&q->dequeue_pos, __ATOMIC_RELAXED);
+    for (;;) {
+        int n = 0;
+        while (n < max) {
+            uint32_t seq = __atomic_load_n(&q->cells[(pos + n) & TASK_QUEUE_MASK].seq, __ATOMIC_ACQUIRE);
+            int32_t diff = (int32_t)(seq - (pos + n + 1));
+            if (diff != 0) {
+                if (n == 0 && diff < 0) return 0;   // 아직 생산되지 않음
+                break;
+            }
+            n++;
+        }
+        if (n == 0) {
+            // 다른 소비자가 이미 pos를 가져감: 위치를 다시 읽음
+            pos = __atomic_load_n(&q->dequeue_pos, __ATOMIC_RELAXED);
+            continue;
+        }
+        if (__atomic_compare_exchange_n(&q->dequeue_pos, &pos, pos + n, 1,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            *start = pos;
+            return n;
+        }
+    }
+}
+
+static inline int ring_full(TaskQueue* q) {
+    uint32_t pos = __atomic_load_n(&q->enqueue_pos, __ATOMIC_SEQ_CST);
+    uint32_t seq = __atomic_load_n(&q->cells[pos & TASK_QUEUE_MASK].seq, __ATOMIC_SEQ_CST);
+    return (int32_t)(seq - pos) < 0;
+}
+
+static inline int ring_empty(TaskQueue* q) {
+    uint32_t pos = __atomic_load_n(&q->dequeue_pos, __ATOMIC_SEQ_CST);
+    uint32_t seq = __atomic_load_n(&q->cells[pos & TASK_QUEUE_MASK].seq, __ATOMIC_SEQ_CST);
+    return (int32_t)(seq - (pos + 1)) < 0;
+}
+
+// 지금 비어 있는 슬롯만큼 작업을 넣고 넣은 개수 반환 (대기하지 않음)
+static int push_available(TaskQueue* q, const Task* tasks, int count) {
+    uint32_t pos;
+    int n = claim_push(q, count, &pos);
+    for (int i = 0; i < n; i++) {
+        TaskCell* cell = &q->cells[(pos + i) & TASK_QUEUE_MASK];
+        cell->task = tasks[i];
+        __atomic_store_n(&cell->seq, pos + i + 1, __ATOMIC_RELEASE);
+    }
+    if (n > 0) wake_waiters(&q->not_empty, &q->empty_waiters, n);  // 대기 중인 worker thread 깨움
+    return n;
+}
+
+// 지금 준비된 작업을 최대 max개 꺼내고 꺼낸 개수 반환 (대기하지 않음)
+static int pop_available(TaskQueue* q, Task* tasks, int max) {
+    uint32_t pos;
+    int n = claim_pop(q, max, &pos);
+    for (int i = 0; i < n; i++) {
+        TaskCell* cell = &q->cells[(pos + i) & TASK_QUEUE_MASK];
+        tasks[i] = cell->task;
+        // 다음 바퀴의 생산자에게 슬롯 반환
+        __atomic_store_n(&cell->seq, pos + i + TASK_QUEUE_CAPACITY, __ATOMIC_RELEASE);
+    }
+    if (n > 0) wake_waiters(&q->not_full, &q->full_waiters, INT_MAX);  // enqueue 대기 중일 수 있음
+    return n;
 }
 
 // 2. 작업 추가 (enqueue)
 // main thread (epoll 루프)에서 작업을 넣을 때 호출
-void task_queue_push(TaskQueue* q, Task task) {
-    pthread_mutex_lock(&q->mutex);
+int task_queue_push_batch(TaskQueue* q, const Task* tasks, int count) {
+    int pushed = 0;
+    int spin = 0;
 
-    // 큐가 가득 찼으면 대기 (단순 구현: wait → 버퍼가 비면 signal 받음)
-    while (q->count == TASK_QUEUE_CAPACITY) {
-        pthread_cond_wait(&q->cond, &q->mutex);
-    }
+    while (pushed < count) {
+        if (__atomic_load_n(&q->stopping, __ATOMIC_ACQUIRE)) break;
 
-    q->queue[q->rear] = task;
-    q->rear = (q->rear + 1) % TASK_QUEUE_CAPACITY;
-    q->count++;
+        int n = push_available(q, tasks + pushed, count - pushed);
+        if (n > 0) {
+            pushed += n;
+            spin = 0;
+            continue;
+        }
 
-    pthread_cond_signal(&q->cond);  // 대기 중인 worker thread 깨움
-    pthread_mutex_unlock(&q->mutex);
+        // 큐가 가득 참: 잠시 재시도 후 futex에서 대기
+        if (++spin < q->spin_limit) {
+            cpu_relax();
+            continue;
+        }
+        __atomic_add_fetch(&q->full_waiters, 1, __ATOMIC_SEQ_CST);
+        uint32_t seen = __atomic_load_n(&q->not_full, __ATOMIC_SEQ_CST);
+        if (!__atomic_load_n(&q->stopping, __ATOMIC_SEQ_CST) && ring_full(q)) {
+            futex_wait(&q->not_full, seen);
+        }
+        __atomic_sub_fetch(&q->full_waiters, 1, __ATOMIC_SEQ_CST);
+        spin = 0;
+    }
+    return pushed;
 }
 
 // 3. 작업 꺼내기 (dequeue)
 // worker thread가 작업을 받아 처리할 때 호출
-Task task_queue_pop(TaskQueue* q) {
-    pthread_mutex_lock(&q->mutex);
+int task_queue_pop_batch(TaskQueue* q, Task* tasks, int max) {
+    int spin = 0;
+    if (max <= 0) return 0;
 
-    // 큐가 비었으면 대기
-    while (q->count == 0 && keep_running) {
-        pthread_cond_wait(&q->cond, &q->mutex);
-    }
-    if (!keep_running) {
-        pthread_mutex_unlock(&q->mutex);
+    for (;;) {
+        if (__atomic_load_n(&q->stopping, __ATOMIC_ACQUIRE)) return 0;
+
+        int n = pop_available(q, tasks, max);
+        if (n > 0) return n;
+
+        // 큐가 비었음: 잠시 재시도 후 futex에서 대기
+        if (++spin < q->spin_limit) {
+            cpu_relax();
+            continue;
+        }
+        __atomic_add_fetch(&q->empty_waiters, 1, __ATOMIC_SEQ_CST);
+        uint32_t seen = __atomic_load_n(&q->not_empty, __ATOMIC_SEQ_CST);
+        if (!__atomic_load_n(&q->stopping, __ATOMIC_SEQ_CST) && ring_empty(q)) {
+            futex_wait(&q->not_empty, seen);
+        }
+        __atomic_sub_fetch(&q->empty_waiters, 1, __ATOMIC_SEQ_CST);
+        spin = 0;
     }
+}
 
-    Task task = q->queue[q->front];
-    q->front = (q->front + 1) % TASK_QUEUE_CAPACITY;
-    q->count--;
+int task_queue_try_push_batch(TaskQueue* q, const Task* tasks, int count) {
+    if (count <= 0 || __atomic_load_n(&q->stopping, __ATOMIC_ACQUIRE)) return 0;
+    return push_available(q, tasks, count);
+}
 
-    pthread_cond_signal(&q->cond);  // enqueue 대기 중일 수 있음
-    pthread_mutex_unlock(&q->mutex);
+int task_queue_try_pop_batch(TaskQueue* q, Task* tasks, int max) {
+    if (max <= 0 || __atomic_load_n(&q->stopping, __ATOMIC_ACQUIRE)) return 0;
+    return pop_available(q, tasks, max);
+}
+
+int task_queue_is_empty(TaskQueue* q) {
+    return ring_empty(q);
+}
 
-    return task;
+void task_queue_wake_all(TaskQueue* q) {
+    __atomic_store_n(&q->stopping, 1, __ATOMIC_SEQ_CST);
+    __atomic_add_fetch(&q->not_empty, 1, __ATOMIC_SEQ_CST);
+    __atomic_add_fetch(&q->not_full, 1, __ATOMIC_SEQ_CST);
+    futex_wake(&q->not_empty, INT_MAX);
+    futex_wake(&q->not_full, INT_MAX);
 }
 
 void task_queue_destroy(TaskQueue* q) {
-    pthread_mutex_destroy(&q->mutex);
-    pthread_cond_destroy(&q->cond);
-    printf( COLOR_GREEN "Mutex 'mutex, cond' has been destroyed." COLOR_RESET);
+    printf( COLOR_GREEN "Task queue has been destroyed." COLOR_RESET);
     free(q);
-}
\ No newline at end of file
+}
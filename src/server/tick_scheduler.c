@@ -0,0 +1,72 @@
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/timerfd.h>
+#include "tick_scheduler.h"
+#include "console_color.h"
+
+int tick_scheduler_init(TickScheduler* sched, int tick_hz, int max_catchup) {
+    memset(sched, 0, sizeof(TickScheduler));
+    sched->tick_hz = tick_hz;
+    sched->max_catchup = (max_catchup < 1) ? 1 : max_catchup;
+
+    sched->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    if (sched->timer_fd < 0) {
+        perror("timerfd_create()");
+        return -1;
+    }
+
+    long period_ns = 1000000000L / tick_hz;
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    // 절대 시각 기준 주기 타이머: 처리 시간과 무관하게 주기가 유지됨
+    struct itimerspec spec;
+    spec.it_interval.tv_sec = period_ns / 1000000000L;
+    spec.it_interval.tv_nsec = period_ns % 1000000000L;
+    spec.it_value.tv_sec = now.tv_sec + spec.it_interval.tv_sec;
+    spec.it_value.tv_nsec = now.tv_nsec + spec.it_interval.tv_nsec;
+    if (spec.it_value.tv_nsec >= 1000000000L) {
+        spec.it_value.tv_sec++;
+        spec.it_value.tv_nsec -= 1000000000L;
+    }
+
+    if (timerfd_settime(sched->timer_fd, TFD_TIMER_ABSTIME, &spec, NULL) < 0) {
+        perror("timerfd_settime()");
+        close(sched->timer_fd);
+        sched->timer_fd = -1;
+        return -1;
+    }
+
+    printf(COLOR_BLUE "[Tick] Fixed timestep: %d Hz (%.2f ms), max catch-up %d steps" COLOR_RESET,
+           tick_hz, period_ns / 1e6, sched->max_catchup);
+    return 0;
+}
+
+int tick_scheduler_wait(TickScheduler* sched) {
+    uint64_t expirations = 0;
+
+    ssize_t n = read(sched->timer_fd, &expirations, sizeof(expirations));
+    if (n != sizeof(expirations)) {
+        if (n < 0 && errno != EINTR) perror("read() : timerfd");
+        return 0;
+    }
+
+    sched->ticks += expirations;
+    if (expirations > 1) sched->late_ticks++;
+
+    uint64_t steps = expirations;
+    if (steps > (uint64_t)sched->max_catchup) {
+        sched->skipped_ticks += steps - (uint64_t)sched->max_catchup;
+        steps = (uint64_t)sched->max_catchup;
+    }
+    sched->steps += steps;
+    return (int)steps;
+}
+
+void tick_scheduler_destroy(TickScheduler* sched) {
+    if (sched->timer_fd >= 0) {
+        close(sched->timer_fd);
+        sched->timer_fd = -1;
+    }
+}
@@ -0,0 +1,146 @@
+#define _GNU_SOURCE
+#include <sys/socket.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include "console_color.h"
+#include "udp_channel.h"
+
+int udp_channel_init(UdpChannel* udp, int port) {
+    struct sockaddr_in addr;
+
+    memset(udp, 0, sizeof(UdpChannel));
+    udp->fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (udp->fd < 0) {
+        perror(COLOR_RED "[UDP] socket()" COLOR_RESET);
+        return -1;
+    }
+    fcntl(udp->fd, F_SETFL, fcntl(udp->fd, F_GETFL, 0) | O_NONBLOCK);
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    if (bind(udp->fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        perror(COLOR_RED "[UDP] bind()" COLOR_RESET);
+        close(udp->fd);
+        udp->fd = -1;
+        return -1;
+    }
+    return 0;
+}
+
+void udp_channel_destroy(UdpChannel* udp) {
+    if (udp->fd >= 0) close(udp->fd);
+    free(udp->iov);
+    free(udp->msgs);
+    free(udp->headers);
+    free(udp->peers);
+    memset(udp, 0, sizeof(UdpChannel));
+    udp->fd = -1;
+}
+
+// 조각 배열을 count개까지 담을 수 있도록 확장
+static int reserve_fragments(UdpChannel* udp, int count) {
+    if (count <= udp->capacity) return 0;
+    int cap = udp->capacity > 0 ? udp->capacity : 16;
+    while (cap < count) cap *= 2;
+
+    struct iovec* iov = (struct iovec*)realloc(udp->iov, sizeof(struct iovec) * 2 * (size_t)cap);
+    if (iov) udp->iov = iov;
+    struct mmsghdr* msgs = (struct mmsghdr*)realloc(udp->msgs, sizeof(struct mmsghdr) * (size_t)cap);
+    if (msgs) udp->msgs = msgs;
+    char* headers = (char*)realloc(udp->headers, UDP_HEADER_MAX * (size_t)cap);
+    if (headers) udp->headers = headers;
+    if (!iov || !msgs || !headers) return -1;
+
+    udp->capacity = cap;
+    return 0;
+}
+
+int udp_channel_prepare(UdpChannel* udp, const SharedFrame* frame, unsigned long long seq) {
+    const char* data = frame->data;
+    size_t len = frame->len;
+    size_t budget = UDP_DATAGRAM_MAX - UDP_HEADER_MAX;
+
+    // 공 경계('|')에서 자름: 한 조각에 들어가는 만큼 공을 담음
+    int count = 0;
+    size_t start = 0;
+    do {
+        size_t end = len;
+        if (len - start > budget) {
+            end = start + budget;
+            while (end > start && data[end - 1] != '|') end--;
+            if (end == start) end = start + budget;    // 공 하나가 예산보다 큼 (실제로는 없음)
+        }
+        if (count == UDP_MAX_FRAGMENTS) break;          // 나머지 공은 이번 틱에 보내지 않음
+        if (reserve_fragments(udp, count + 1) < 0) return -1;
+        udp->iov[2 * count + 1].iov_base = (void*)(data + start);
+        udp->iov[2 * count + 1].iov_len = end - start;
+        count++;
+        start = end;
+    } while (start < len);
+
+    // 조각 수를 알아야 헤더를 쓸 수 있으므로 두 번째 단계에서 헤더와 메시지 구성
+    for (int i = 0; i < count; i++) {
+        char* header = udp->headers + (size_t)i * UDP_HEADER_MAX;
+        int n = snprintf(header, UDP_HEADER_MAX, "S%llu %d/%d\n", seq, i, count);
+        udp->iov[2 * i].iov_base = header;
+        udp->iov[2 * i].iov_len = (size_t)n;
+
+        memset(&udp->msgs[i], 0, sizeof(struct mmsghdr));
+        udp->msgs[i].msg_hdr.msg_iov = &udp->iov[2 * i];
+        udp->msgs[i].msg_hdr.msg_iovlen = 2;
+        udp->msgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+    }
+
+    udp->frame = frame;
+    udp->count = count;
+    return count;
+}
+
+int udp_channel_add_peer(UdpChannel* udp, const struct sockaddr_in* addr) {
+    if (udp->peer_count == udp->peer_capacity) {
+        int cap = udp->peer_capacity > 0 ? udp->peer_capacity * 2 : 16;
+        struct sockaddr_in* peers = (struct sockaddr_in*)realloc(udp->peers, sizeof(struct sockaddr_in) * (size_t)cap);
+        if (!peers) return -1;
+        udp->peers = peers;
+        udp->peer_capacity = cap;
+    }
+    udp->peers[udp->peer_count++] = *addr;
+    return 0;
+}
+
+// 준비된 조각을 한 클라이언트에게 전송
+static int send_to_peer(UdpChannel* udp, const struct sockaddr_in* addr) {
+    int sent = 0;
+    for (int i = 0; i < udp->count; i++) {
+        udp->msgs[i].msg_hdr.msg_name = (void*)addr;
+    }
+
+    // 한 번의 sendmmsg()로 모든 조각 전송 (소켓 버퍼가 차면 나머지는 버림)
+    while (sent < udp->count) {
+        int n = sendmmsg(udp->fd, &udp->msgs[sent], (unsigned)(udp->count - sent), MSG_DONTWAIT);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        sent += n;
+    }
+
+    udp->datagrams += (unsigned long long)sent;
+    udp->dropped += (unsigned long long)(udp->count - sent);
+    return sent;
+}
+
+int udp_channel_flush(UdpChannel* udp) {
+    int sent = 0;
+    for (int i = 0; i < udp->peer_count; i++) {
+        sent += send_to_peer(udp, &udp->peers[i]);
+    }
+    udp->peer_count = 0;
+    return sent;
+}
@@ -0,0 +1,213 @@
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include "uring.h"
+
+// liburing 없이 시스템 콜을 직접 호출
+static int sys_io_uring_setup(unsigned entries, struct io_uring_params* p) {
+    return (int)syscall(__NR_io_uring_setup, entries, p);
+}
+
+static int sys_io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags,
+                              const void* arg, size_t argsz) {
+    return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, arg, argsz);
+}
+
+static int sys_io_uring_register(int fd, unsigned opcode, const void* arg, unsigned nr_args) {
+    return (int)syscall(__NR_io_uring_register, fd, opcode, arg, nr_args);
+}
+
+int uring_init(Uring* ring) {
+    struct io_uring_params p;
+
+    memset(ring, 0, sizeof(Uring));
+    memset(&p, 0, sizeof(p));
+    p.flags = IORING_SETUP_CQSIZE;
+    p.cq_entries = URING_CQ_ENTRIES;
+
+    ring->fd = sys_io_uring_setup(URING_SQ_ENTRIES, &p);
+    if (ring->fd < 0) {
+        ring->fd = -1;
+        return -1;
+    }
+
+    // 제한 시간 대기(EXT_ARG)와 CQ 넘침 보관(NODROP)이 필요
+    if (!(p.features & IORING_FEAT_EXT_ARG) || !(p.features & IORING_FEAT_NODROP)) {
+        close(ring->fd);
+        ring->fd = -1;
+        errno = ENOTSUP;
+        return -1;
+    }
+
+    ring->sq_ring_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    ring->cq_ring_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    int single = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single && ring->cq_ring_size > ring->sq_ring_size) ring->sq_ring_size = ring->cq_ring_size;
+
+    ring->sq_ring = mmap(NULL, ring->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                         ring->fd, IORING_OFF_SQ_RING);
+    if (ring->sq_ring == MAP_FAILED) goto fail;
+    if (single) {
+        ring->cq_ring = ring->sq_ring;
+    } else {
+        ring->cq_ring = mmap(NULL, ring->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                             ring->fd, IORING_OFF_CQ_RING);
+        if (ring->cq_ring == MAP_FAILED) goto fail;
+    }
+
+    ring->sqes_size = p.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      ring->fd, IORING_OFF_SQES);
+    if (ring->sqes == MAP_FAILED) goto fail;
+
+    char* sq = (char*)ring->sq_ring;
+    ring->sq_head = (unsigned*)(sq + p.sq_off.head);
+    ring->sq_tail = (unsigned*)(sq + p.sq_off.tail);
+    ring->sq_mask = *(unsigned*)(sq + p.sq_off.ring_mask);
+    ring->sq_entries = *(unsigned*)(sq + p.sq_off.ring_entries);
+    ring->sq_array = (unsigned*)(sq + p.sq_off.array);
+
+    char* cq = (char*)ring->cq_ring;
+    ring->cq_head = (unsigned*)(cq + p.cq_off.head);
+    ring->cq_tail = (unsigned*)(cq + p.cq_off.tail);
+    ring->cq_mask = *(unsigned*)(cq + p.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe*)(cq + p.cq_off.cqes);
+
+    // SQE 인덱스를 1:1로 고정 (배열 간접 참조를 매번 쓰지 않음)
+    for (unsigned i = 0; i < ring->sq_entries; i++) ring->sq_array[i] = i;
+    return 0;
+
+fail:
+    {
+        int saved = errno;
+        uring_destroy(ring);
+        errno = saved;
+    }
+    return -1;
+}
+
+int uring_setup_buffers(Uring* ring) {
+    size_t ring_size = sizeof(struct io_uring_buf) * URING_BUF_COUNT;
+    void* mem = mmap(NULL, ring_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED) return -1;
+    ring->buf_ring = (struct io_uring_buf_ring*)mem;
+
+    ring->buf_base = (char*)malloc((size_t)URING_BUF_COUNT * URING_BUF_SIZE);
+    if (!ring->buf_base) {
+        munmap(mem, ring_size);
+        ring->buf_ring = NULL;
+        errno = ENOMEM;
+        return -1;
+    }
+
+    struct io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = (unsigned long long)(unsigned long)mem;
+    reg.ring_entries = URING_BUF_COUNT;
+    reg.bgid = URING_BUF_GROUP;
+    if (sys_io_uring_register(ring->fd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+        int saved = errno;
+        munmap(mem, ring_size);
+        free(ring->buf_base);
+        ring->buf_ring = NULL;
+        ring->buf_base = NULL;
+        errno = saved;
+        return -1;
+    }
+
+    // 모든 버퍼를 커널에 넘김
+    ring->buf_tail = 0;
+    for (unsigned bid = 0; bid < URING_BUF_COUNT; bid++) uring_buffer_recycle(ring, bid);
+    return 0;
+}
+
+void uring_destroy(Uring* ring) {
+    if (ring->buf_ring) munmap(ring->buf_ring, sizeof(struct io_uring_buf) * URING_BUF_COUNT);
+    free(ring->buf_base);
+    if (ring->sqes && ring->sqes != MAP_FAILED) munmap(ring->sqes, ring->sqes_size);
+    if (ring->cq_ring && ring->cq_ring != MAP_FAILED && ring->cq_ring != ring->sq_ring) {
+        munmap(ring->cq_ring, ring->cq_ring_size);
+    }
+    if (ring->sq_ring && ring->sq_ring != MAP_FAILED) munmap(ring->sq_ring, ring->sq_ring_size);
+    if (ring->fd >= 0) close(ring->fd);
+    memset(ring, 0, sizeof(Uring));
+    ring->fd = -1;
+}
+
+// 채워 둔 SQE를 커널에 공개하고, 커널이 아직 가져가지 않은 SQE 수를 반환
+static unsigned publish_pending(Uring* ring) {
+    unsigned tail = *ring->sq_tail + ring->sq_pending;
+    __atomic_store_n(ring->sq_tail, tail, __ATOMIC_RELEASE);
+    ring->sq_pending = 0;
+    return tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+}
+
+static int enter(Uring* ring, unsigned to_submit, unsigned wait_nr, int timeout_ms) {
+    struct __kernel_timespec ts;
+    struct io_uring_getevents_arg arg;
+    unsigned flags = 0;
+
+    memset(&arg, 0, sizeof(arg));
+    if (wait_nr > 0) {
+        ts.tv_sec = timeout_ms / 1000;
+        ts.tv_nsec = (long long)(timeout_ms % 1000) * 1000000LL;
+        arg.ts = (unsigned long long)(unsigned long)&ts;
+        flags = IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG;
+    }
+
+    ring->enters++;
+    int rc = sys_io_uring_enter(ring->fd, to_submit, wait_nr, flags,
+                                wait_nr > 0 ? &arg : NULL, wait_nr > 0 ? sizeof(arg) : 0);
+    if (rc < 0 && errno == ETIME) return 0;     // 제한 시간 만료는 정상 반환
+    return rc < 0 ? -1 : 0;
+}
+
+struct io_uring_sqe* uring_get_sqe(Uring* ring) {
+    unsigned head = __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+    unsigned next = *ring->sq_tail + ring->sq_pending;
+
+    // 제출 링이 가득 참: 지금까지 채운 것을 먼저 제출
+    while (next - head >= ring->sq_entries) {
+        unsigned pending = publish_pending(ring);
+        if (enter(ring, pending, 0, 0) < 0 && errno != EINTR && errno != EBUSY && errno != EAGAIN) break;
+        head = __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+        next = *ring->sq_tail;
+    }
+
+    struct io_uring_sqe* sqe = &ring->sqes[next & ring->sq_mask];
+    memset(sqe, 0, sizeof(*sqe));
+    ring->sq_pending++;
+    return sqe;
+}
+
+int uring_submit_and_wait(Uring* ring, unsigned wait_nr, int timeout_ms) {
+    unsigned pending = publish_pending(ring);
+    return enter(ring, pending, wait_nr, timeout_ms);
+}
+
+struct io_uring_cqe* uring_peek_cqe(Uring* ring) {
+    unsigned head = *ring->cq_head;
+    if (head == __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE)) return NULL;
+    return &ring->cqes[head & ring->cq_mask];
+}
+
+void uring_cqe_seen(Uring* ring) {
+    __atomic_store_n(ring->cq_head, *ring->cq_head + 1, __ATOMIC_RELEASE);
+}
+
+char* uring_buffer(Uring* ring, const struct io_uring_cqe* cqe, unsigned* bid) {
+    *bid = cqe->flags >> IORING_CQE_BUFFER_SHIFT;
+    return ring->buf_base + (size_t)*bid * URING_BUF_SIZE;
+}
+
+void uring_buffer_recycle(Uring* ring, unsigned bid) {
+    struct io_uring_buf* buf = &ring->buf_ring->bufs[ring->buf_tail & (URING_BUF_COUNT - 1)];
+    buf->addr = (unsigned long long)(unsigned long)(ring->buf_base + (size_t)bid * URING_BUF_SIZE);
+    buf->len = URING_BUF_SIZE;
+    buf->bid = (unsigned short)bid;
+    ring->buf_tail++;
+    __atomic_store_n(&ring->buf_ring->tail, ring->buf_tail, __ATOMIC_RELEASE);
+}
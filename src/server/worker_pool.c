@@ -0,0 +1,287 @@
+#include <limits.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include "worker_pool.h"
+
+#define TASK_DEQUE_MASK (TASK_DEQUE_CAPACITY - 1)
+
+#if (TASK_DEQUE_CAPACITY & TASK_DEQUE_MASK) != 0
+#error "TASK_DEQUE_CAPACITY must be a power of two"
+#endif
+
+static inline void futex_wait(uint32_t* addr, uint32_t expected) {
+    syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, expected, NULL, NULL, 0);
+}
+
+static inline void futex_wake(uint32_t* addr, int count) {
+    syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, count, NULL, NULL, 0);
+}
+
+// 잠든 워커가 있을 때만 futex 워드를 올리고 하나를 깨움
+static inline void wake_idle_worker(WorkerPool* pool) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&pool->idle_waiters, __ATOMIC_SEQ_CST) > 0) {
+        __atomic_add_fetch(&pool->work_seq, 1, __ATOMIC_SEQ_CST);
+        futex_wake(&pool->work_seq, 1);
+    }
+}
+
+// ===== Chase-Lev 덱 =====
+
+// 소유자만 호출: bottom에 작업 추가 (가득 차면 0)
+static int deque_push(TaskDeque* d, const Task* task) {
+    long b = __atomic_load_n(&d->bottom, __ATOMIC_RELAXED);
+    long t = __atomic_load_n(&d->top, __ATOMIC_ACQUIRE);
+    if (b - t >= TASK_DEQUE_CAPACITY) return 0;
+
+    d->slots[b & TASK_DEQUE_MASK] = *task;
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&d->bottom, b + 1, __ATOMIC_RELAXED);
+    return 1;
+}
+
+// 소유자만 호출: bottom에서 작업 꺼내기 (비었으면 0)
+static int deque_pop(TaskDeque* d, Task* out) {
+    long b = __atomic_load_n(&d->bottom, __ATOMIC_RELAXED) - 1;
+    __atomic_store_n(&d->bottom, b, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    long t = __atomic_load_n(&d->top, __ATOMIC_RELAXED);
+
+    if (t > b) {
+        // 비어 있음
+        __atomic_store_n(&d->bottom, b + 1, __ATOMIC_RELAXED);
+        return 0;
+    }
+
+    *out = d->slots[b & TASK_DEQUE_MASK];
+    if (t == b) {
+        // 마지막 작업: 훔치는 쪽과 top을 두고 경쟁
+        int won = __atomic_compare_exchange_n(&d->top, &t, t + 1, 0,
+                                              __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+        __atomic_store_n(&d->bottom, b + 1, __ATOMIC_RELAXED);
+        return won;
+    }
+    return 1;
+}
+
+// 다른 워커가 호출: top에서 작업 훔치기 (1 = 성공, 0 = 비어 있음, -1 = 경쟁에서 짐)
+static int deque_steal(TaskDeque* d, Task* out) {
+    long t = __atomic_load_n(&d->top, __ATOMIC_ACQUIRE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    long b = __atomic_load_n(&d->bottom, __ATOMIC_ACQUIRE);
+    if (t >= b) return 0;
+
+    // 소유자는 top이 바뀌기 전까지 이 슬롯을 덮어쓰지 않음 (b - t < 용량)
+    Task task = d->slots[t & TASK_DEQUE_MASK];
+    if (!__atomic_compare_exchange_n(&d->top, &t, t + 1, 0,
+                                     __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+        return -1;
+    }
+    *out = task;
+    return 1;
+}
+
+static inline int deque_is_empty(TaskDeque* d) {
+    long t = __atomic_load_n(&d->top, __ATOMIC_SEQ_CST);
+    long b = __atomic_load_n(&d->bottom, __ATOMIC_SEQ_CST);
+    return t >= b;
+}
+
+// ===== 워커 풀 =====
+
+int worker_pool_init(WorkerPool* pool, int max_workers, int target_workers) {
+    memset(pool, 0, sizeof(WorkerPool));
+    if (max_workers < 1) max_workers = 1;
+    if (target_workers < 1) target_workers = 1;
+    if (target_workers > max_workers) target_workers = max_workers;
+
+    size_t size = sizeof(WorkerSlot) * (size_t)max_workers;
+    size = (size + TASK_CACHE_LINE - 1) / TASK_CACHE_LINE * TASK_CACHE_LINE;
+    pool->workers = (WorkerSlot*)aligned_alloc(TASK_CACHE_LINE, size);
+    if (!pool->workers) {
+        perror(COLOR_RED "[Error] Worker pool allocation failed" COLOR_RESET);
+        return -1;
+    }
+    memset(pool->workers, 0, size);
+
+    for (int i = 0; i < max_workers; i++) {
+        task_queue_init(&pool->workers[i].inbox);
+    }
+    pool->max_workers = max_workers;
+    pool->target_workers = target_workers;
+    return 0;
+}
+
+int worker_pool_submit(WorkerPool* pool, const Task* tasks, int count) {
+    int n = __atomic_load_n(&pool->target_workers, __ATOMIC_ACQUIRE);   // 은퇴 중인 슬롯에는 넣지 않음
+    int target = (int)(__atomic_fetch_add(&pool->next_inbox, 1, __ATOMIC_RELAXED) % (uint32_t)n);
+    int pushed = 0;
+
+    // 차례인 inbox가 가득 차면 다음 inbox로 넘김
+    for (int k = 0; k < n && pushed < count; k++) {
+        TaskQueue* inbox = &pool->workers[(target + k) % n].inbox;
+        pushed += task_queue_try_push_batch(inbox, tasks + pushed, count - pushed);
+    }
+    // 모든 inbox가 가득 참: 차례인 inbox에 자리가 날 때까지 대기 (역압)
+    if (pushed < count) {
+        wake_idle_worker(pool);
+        pushed += task_queue_push_batch(&pool->workers[target].inbox, tasks + pushed, count - pushed);
+    }
+
+    if (pushed > 0) wake_idle_worker(pool);
+    return pushed;
+}
+
+int worker_pool_resubmit(WorkerPool* pool, int worker, const Task* task) {
+    // 자신의 덱 (소유자만 push): 다른 워커가 훔쳐 갈 수 있음
+    if (deque_push(&pool->workers[worker].deque, task)) {
+        wake_idle_worker(pool);
+        return 1;
+    }
+
+    // 덱이 가득 참: 자리가 있는 inbox에 넣음 (대기하지 않음)
+    int n = __atomic_load_n(&pool->target_workers, __ATOMIC_ACQUIRE);
+    for (int k = 0; k < n; k++) {
+        if (task_queue_try_push_batch(&pool->workers[(worker + k) % n].inbox, task, 1) > 0) {
+            wake_idle_worker(pool);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// 다른 워커의 덱(최신 작업) 또는 inbox(가장 오래된 작업)에서 하나 가져옴
+static int steal_task(WorkerPool* pool, int worker, Task* task) {
+    int n = pool->max_workers;
+    for (int k = 1; k < n; k++) {
+        WorkerSlot* victim = &pool->workers[(worker + k) % n];
+        for (int retry = 0; retry < WORKER_POOL_STEAL_RETRIES; retry++) {
+            int rc = deque_steal(&victim->deque, task);
+            if (rc > 0) return 1;
+            if (rc == 0) break;
+        }
+        if (task_queue_try_pop_batch(&victim->inbox, task, 1) > 0) return 1;
+    }
+    return 0;
+}
+
+// 어느 덱이나 inbox에 작업이 남아 있는지 확인
+static int work_available(WorkerPool* pool) {
+    for (int i = 0; i < pool->max_workers; i++) {
+        if (!deque_is_empty(&pool->workers[i].deque)) return 1;
+        if (!task_queue_is_empty(&pool->workers[i].inbox)) return 1;
+    }
+    return 0;
+}
+
+int worker_pool_next(WorkerPool* pool, int worker, Task* task) {
+    WorkerSlot* self = &pool->workers[worker];
+
+    while (!__atomic_load_n(&pool->stopping, __ATOMIC_ACQUIRE)) {
+        int retiring = (worker >= __atomic_load_n(&pool->target_workers, __ATOMIC_ACQUIRE));
+
+        // 1. 자신의 덱
+        if (deque_pop(&self->deque, task)) {
+            __atomic_add_fetch(&self->local_pops, 1, __ATOMIC_RELAXED);
+            return 1;
+        }
+
+        // 2. 자신의 inbox: 첫 작업은 바로 처리, 나머지는 덱에 넣어 훔칠 수 있게 함
+        Task batch[WORKER_POOL_REFILL];
+        int got = task_queue_try_pop_batch(&self->inbox, batch, WORKER_POOL_REFILL);
+        if (got > 0) {
+            // 역순으로 넣어 소유자는 도착 순서대로 꺼내고, 훔치는 쪽은 가장 늦은 작업을 가져감
+            for (int i = got - 1; i >= 1; i--) deque_push(&self->deque, &batch[i]);
+            if (got > 1) wake_idle_worker(pool);
+            *task = batch[0];
+            __atomic_add_fetch(&self->local_pops, 1, __ATOMIC_RELAXED);
+            return 1;
+        }
+
+        // 은퇴하는 워커는 자기 큐만 비우고 종료 (이후 들어온 작업은 다른 워커가 훔쳐 감)
+        if (retiring) return 0;
+
+        // 3. 다른 워커에게서 훔침
+        if (steal_task(pool, worker, task)) {
+            __atomic_add_fetch(&self->steals, 1, __ATOMIC_RELAXED);
+            return 1;
+        }
+
+        // 4. 모든 큐가 비었음: 작업이 들어올 때까지 대기
+        __atomic_add_fetch(&pool->idle_waiters, 1, __ATOMIC_SEQ_CST);
+        uint32_t seen = __atomic_load_n(&pool->work_seq, __ATOMIC_SEQ_CST);
+        if (!__atomic_load_n(&pool->stopping, __ATOMIC_SEQ_CST) && !work_available(pool) &&
+            worker < __atomic_load_n(&pool->target_workers, __ATOMIC_SEQ_CST)) {
+            futex_wait(&pool->work_seq, seen);
+        }
+        __atomic_sub_fetch(&pool->idle_waiters, 1, __ATOMIC_SEQ_CST);
+    }
+    return 0;
+}
+
+void worker_pool_set_target(WorkerPool* pool, int target) {
+    if (target < 1) target = 1;
+    if (target > pool->max_workers) target = pool->max_workers;
+    __atomic_store_n(&pool->target_workers, target, __ATOMIC_SEQ_CST);
+
+    // 잠든 워커가 은퇴 여부를 다시 확인하도록 깨움
+    __atomic_add_fetch(&pool->work_seq, 1, __ATOMIC_SEQ_CST);
+    futex_wake(&pool->work_seq, INT_MAX);
+}
+
+void worker_pool_record_wait(WorkerPool* pool, unsigned long long wait_ns) {
+    // 지수 이동 평균 (1/8 가중치), 동시에 갱신되면 일부 표본은 버려져도 무방
+    unsigned long long avg = __atomic_load_n(&pool->wait_avg_ns, __ATOMIC_RELAXED);
+    avg = avg - avg / 8 + wait_ns / 8;
+    __atomic_store_n(&pool->wait_avg_ns, avg, __ATOMIC_RELAXED);
+
+    unsigned long long max = __atomic_load_n(&pool->wait_max_ns, __ATOMIC_RELAXED);
+    while (wait_ns > max &&
+           !__atomic_compare_exchange_n(&pool->wait_max_ns, &max, wait_ns, 1,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+unsigned long long worker_pool_take_wait_max(WorkerPool* pool) {
+    return __atomic_exchange_n(&pool->wait_max_ns, 0, __ATOMIC_RELAXED);
+}
+
+int worker_pool_depth(WorkerPool* pool) {
+    int depth = 0;
+    for (int i = 0; i < pool->max_workers; i++) {
+        WorkerSlot* w = &pool->workers[i];
+        int32_t queued = (int32_t)(__atomic_load_n(&w->inbox.enqueue_pos, __ATOMIC_RELAXED) -
+                                   __atomic_load_n(&w->inbox.dequeue_pos, __ATOMIC_RELAXED));
+        long stacked = __atomic_load_n(&w->deque.bottom, __ATOMIC_RELAXED) -
+                       __atomic_load_n(&w->deque.top, __ATOMIC_RELAXED);
+        if (queued > 0) depth += queued;
+        if (stacked > 0) depth += (int)stacked;
+    }
+    return depth;
+}
+
+void worker_pool_wake_all(WorkerPool* pool) {
+    __atomic_store_n(&pool->stopping, 1, __ATOMIC_SEQ_CST);
+    for (int i = 0; i < pool->max_workers; i++) {
+        task_queue_wake_all(&pool->workers[i].inbox);   // inbox에서 대기 중인 리액터 깨움
+    }
+    __atomic_add_fetch(&pool->work_seq, 1, __ATOMIC_SEQ_CST);
+    futex_wake(&pool->work_seq, INT_MAX);
+}
+
+void worker_pool_report(const WorkerPool* pool) {
+    for (int i = 0; i < pool->max_workers; i++) {
+        const WorkerSlot* w = &pool->workers[i];
+        printf("[Worker %d] local pops %llu, steals %llu\n", i,
+               __atomic_load_n(&w->local_pops, __ATOMIC_RELAXED),
+               __atomic_load_n(&w->steals, __ATOMIC_RELAXED));
+    }
+}
+
+void worker_pool_destroy(WorkerPool* pool) {
+    free(pool->workers);
+    pool->workers = NULL;
+    pool->max_workers = 0;
+    printf(COLOR_GREEN "Worker pool has been destroyed." COLOR_RESET);
+}
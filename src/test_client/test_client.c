@@ -148,7 +148,11 @@ void* socket_send_thread(void* arg) {
                 if (fgets(input, sizeof(input), stdin) == NULL) continue;
                 input[strcspn(input, "\n")] = '\0';
 
-                send(ctx->socket_fd, input, strlen(input), 0);
+                // 서버는 '\n'으로 명령을 구분하므로 줄 끝을 붙여 전송
+                size_t len = strlen(input);
+                input[len] = '\n';
+                send(ctx->socket_fd, input, len + 1, 0);
+                input[len] = '\0';
                 printf("\n[ Command Guide ]\n"
                 "- Create a ball           : a        (e.g., a)\n"
                 "- Delete a ball           : d        (e.g., d)\n"
@@ -167,7 +171,7 @@ void* socket_send_thread(void* arg) {
             }
         }
     }
-    send(ctx->socket_fd, "x", 1, 0);
+    send(ctx->socket_fd, "x\n", 2, 0);
     printf(COLOR_GREEN "[Client] Socket Send Thread Shutting down..." COLOR_RESET);
     pthread_exit(NULL);
 }